@@ -0,0 +1,60 @@
+#ifndef __OPENRM_ATTACK_SCORER_H__
+#define __OPENRM_ATTACK_SCORER_H__
+#include <attack/attack.h>
+#include <vector>
+
+namespace rm {
+
+// score = priority * P(id) + hit * p_hit + size * big - distance * d - angle * a
+// The current focus gets an extra switch bonus, a new target must beat it by that margin
+struct ScorerWeight {
+    double distance = 0.1;                  // Per meter of target distance
+    double angle = 1.0;                     // Per rad of angle from crosshair
+    double hit = 1.0;                       // Per predicted hit probability
+    double size = 0.2;                      // Bonus of big armor
+    double priority = 1.0;                  // Scale of threat priority
+    double switch_cost = 0.3;               // Bonus kept by current focus
+};
+
+struct ScorerState {
+    TimePoint last_t;                       // Last time of target
+    double angle;                           // Angle between target and crosshair
+    double distance;                        // Distance of target
+    double hit;                             // Predicted hit probability
+    ArmorSize size;                         // Armor size of target
+    double score;                           // Score of last pop
+    bool exist;                             // Whether target exists
+    ScorerState() : last_t(getTime()), angle(1e3), distance(0.0), hit(0.0),
+                    size(ARMOR_SIZE_UNKNOWN), score(0.0), exist(false) {}
+};
+
+class Scorer : public AttackInterface {
+public:
+    Scorer();
+    ~Scorer() {};
+
+    void push(ArmorID armor_id, double angle, TimePoint t) override;
+    void push(ArmorID armor_id, double angle, double distance, double hit, ArmorSize size, TimePoint t);
+    ArmorID pop() override;
+
+    void refresh() override;
+    void clear() override;
+
+    void setWeight(const ScorerWeight& weight) { weight_ = weight; }
+    void setPriority(ArmorID armor_id, double priority) { priority_[armor_id] = priority; }
+    double getScore(ArmorID armor_id) { return state_[armor_id].score; }
+
+private:
+    void   expire(TimePoint now_t);                                 // Remove targets not seen within exist_dt_
+    double getStateScore(const ScorerState& state, ArmorID armor_id);
+
+    ScorerWeight weight_;
+    std::vector<double> priority_;                                  // Threat priority of each armor id
+    std::vector<ScorerState> state_;                                // State of each armor id
+    std::vector<ArmorID> active_;                                   // Armor ids that exist, pop only scans these
+};
+
+}
+
+
+#endif
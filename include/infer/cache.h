@@ -0,0 +1,78 @@
+#ifndef __OPENRM_INFER_CACHE_H__
+#define __OPENRM_INFER_CACHE_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Engine cache layout:
+// [ header (64 bytes) ][ serialized engine ]
+// The file name and the header both carry the cache key, the header is checked on every load.
+
+namespace rm {
+
+enum EnginePrecision {
+    ENGINE_FP32 = 0,
+    ENGINE_FP16 = 1,
+    ENGINE_INT8 = 2,
+};
+
+struct EngineCacheKey {
+    uint64_t onnx_hash   = 0;               // FNV-1a 64 hash of the ONNX file content
+    uint32_t precision   = ENGINE_FP16;     // Engine precision, see EnginePrecision
+    uint32_t max_batch   = 1;               // Max batch size of the engine
+    uint64_t lib_version = 0;               // Version of the inference library which built the engine
+};
+
+struct EngineCache {
+    void*       map_addr = nullptr;         // Start address of the mapped file
+    size_t      map_size = 0;               // Size of the mapped file
+    const void* data     = nullptr;         // Start address of the serialized engine
+    size_t      size     = 0;               // Size of the serialized engine
+};
+
+bool getFileHash(
+    const std::string& file,
+    uint64_t& hash);
+
+bool getEngineCacheKey(
+    const std::string& onnx_file,
+    EnginePrecision precision,
+    unsigned int max_batch,
+    uint64_t lib_version,
+    EngineCacheKey& key);
+
+std::string getEngineCachePath(
+    const std::string& cache_dir,
+    const std::string& onnx_file,
+    const EngineCacheKey& key);
+
+std::string getPrecisionStr(EnginePrecision precision);
+
+bool writeEngineCache(
+    const std::string& cache_file,
+    const EngineCacheKey& key,
+    const void* data,
+    size_t size);
+
+bool mapEngineCache(
+    const std::string& cache_file,
+    const EngineCacheKey& key,
+    EngineCache& cache);
+
+bool mapEngineFile(
+    const std::string& engine_file,
+    EngineCache& cache);
+
+void unmapEngineCache(EngineCache& cache);
+
+// Remove caches of this model built by another library version, including .calib and .tmp leftovers
+// Caches of other precisions and batch sizes stay valid and are kept
+int clearEngineCache(
+    const std::string& cache_dir,
+    const std::string& onnx_file,
+    const EngineCacheKey& key);
+
+}
+
+#endif
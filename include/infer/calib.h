@@ -0,0 +1,59 @@
+#ifndef __OPENRM_INFER_CALIB_H__
+#define __OPENRM_INFER_CALIB_H__
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+namespace rm {
+
+// CPU version of rm::resize, output is the same letterboxed RGB CHW float blob
+void letterbox(
+    const uint8_t* src,
+    int src_width,
+    int src_height,
+    float* dst,
+    int dst_width,
+    int dst_height);
+
+void letterbox(
+    const cv::Mat& src,
+    float* dst,
+    int dst_width,
+    int dst_height);
+
+class CalibLoader {
+public:
+    CalibLoader() {}
+    CalibLoader(const std::string& dir, int width, int height, int batch_size = 1, int max_num = 0);
+    ~CalibLoader() {}
+
+    bool next(float* host_buffer);                                              // Load next batch into CHW host buffer
+    void reset() { this->index_ = 0; }                                          // Restart from the first frame
+
+public:
+    int getBatchSize() const { return batch_size_; }                            // Frames per batch
+    int getFrameNum() const { return static_cast<int>(files_.size()); }         // Frames found in directory
+    size_t getBatchLength() const {                                             // Floats per batch
+        return static_cast<size_t>(batch_size_) * 3 * width_ * height_;
+    }
+    const std::vector<std::string>& getFiles() const { return files_; }         // Sorted frame files
+
+private:
+    int width_      = 640;                  // Width of network input
+    int height_     = 640;                  // Height of network input
+    int batch_size_ = 1;                    // Frames per batch
+    size_t index_   = 0;                    // Index of next frame
+
+    std::vector<std::string> files_;        // Sorted list of recorded frames
+};
+
+bool getImageFiles(
+    const std::string& dir,
+    std::vector<std::string>& files,
+    int max_num = 0);
+
+}
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef __OPENRM_INFER_EVALUATE_H__
+#define __OPENRM_INFER_EVALUATE_H__
+
+#include <string>
+#include <vector>
+#include "structure/stamp.hpp"
+
+namespace rm {
+
+typedef std::vector<std::vector<YoloRect>> DetectList;    // Detections of each frame
+
+struct DetectEval {
+    double map          = 0.0;              // Mean AP over classes present in reference
+    double mean_iou     = 0.0;              // Mean IoU of matched boxes
+    double corner_error = 0.0;              // Mean four-point distance of matched boxes, pixel
+    double precision    = 0.0;              // Matched / test detections
+    double recall       = 0.0;              // Matched / reference detections
+    int    matched      = 0;                // Detections matched to reference
+    int    missed       = 0;                // Reference detections without match
+    int    extra        = 0;                // Test detections without match
+    std::vector<double> ap;                 // AP of each class, -1 if class absent in reference
+};
+
+double getRectIoU(const cv::Rect& a, const cv::Rect& b);
+
+DetectEval evaluateDetection(
+    const DetectList& reference,
+    const DetectList& test,
+    double iou_threshold = 0.5);
+
+void reportDetectEval(
+    const std::string& name,
+    const DetectEval& eval,
+    const DetectEval* base = nullptr);
+
+bool writeDetections(const std::string& file, const DetectList& detections);
+bool readDetections(const std::string& file, DetectList& detections);
+
+}
+
+#endif
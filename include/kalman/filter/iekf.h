@@ -0,0 +1,120 @@
+#ifndef __OPENRM_KALMAN_FILTER_IEKF_H__
+#define __OPENRM_KALMAN_FILTER_IEKF_H__
+
+#include <Eigen/Dense>
+#include <ceres/jet.h>
+#include <algorithm>
+#include <type_traits>
+#include <opencv2/core/eigen.hpp>
+
+// Iterated EKF, same interface as EKF
+// The observation is relinearized around the latest estimate until the step is below epsilon,
+// which is a Gauss-Newton solve of the MAP problem. Prediction is the same as EKF.
+// FuncA / FuncH may provide jacobian(x, J) as in SEKF to skip Jet evaluation.
+
+template<int dimX, int dimY>
+class IEKF {
+public:
+    using MatXX = Eigen::Matrix<double, dimX, dimX>;
+    using MatXY = Eigen::Matrix<double, dimX, dimY>;
+    using MatYX = Eigen::Matrix<double, dimY, dimX>;
+    using MatYY = Eigen::Matrix<double, dimY, dimY>;
+    using VecX = Eigen::Matrix<double, dimX, 1>;
+    using VecY = Eigen::Matrix<double, dimY, 1>;
+
+    IEKF():
+        estimate_X(VecX::Zero()),
+        P(MatXX::Identity()),
+        Q(MatXX::Identity()),
+        R(MatYY::Identity()) {}
+
+    IEKF(const MatXX& Q0, const MatYY& R0):
+        estimate_X(VecX::Zero()),
+        P(MatXX::Identity()),
+        Q(Q0),
+        R(R0) {}
+
+    void restart() {
+        estimate_X = VecX::Zero();
+        P = MatXX::Identity();
+    }
+
+    VecX estimate_X;
+    VecX predict_X;
+    VecY predict_Y;
+    MatXX jacobi_F;
+    MatYX jacobi_H;
+    MatXX P;
+    MatXX Q;
+    MatYY R;
+    MatXY K;
+
+    int    max_iter = 5;                    // Maximum relinearization count
+    double epsilon = 1e-6;                  // Stop when step norm is below epsilon
+    int    iter_count = 0;                  // Iterations used by last update
+
+    template<class Func>
+    VecX predict(Func&& func) {
+        evaluate(func, estimate_X, predict_X, jacobi_F);
+        P = jacobi_F * P * jacobi_F.transpose() + Q;
+        return predict_X;
+    }
+
+    template<class Func>
+    VecX update(Func&& func, const VecY& Y) {
+        VecX X = predict_X;
+        VecY h;
+
+        for (iter_count = 1; iter_count <= max_iter; iter_count++) {
+            evaluate(func, X, h, jacobi_H);
+
+            MatYX HP = jacobi_H * P;
+            MatYY S = HP * jacobi_H.transpose() + R;
+            K = S.ldlt().solve(HP).transpose();
+
+            // x_{i+1} = x_pred + K * (y - h(x_i) - H_i * (x_pred - x_i))
+            VecX X_next = predict_X + K * (Y - h - jacobi_H * (predict_X - X));
+            double step = (X_next - X).norm();
+            X = X_next;
+            if (step < epsilon) break;
+        }
+        iter_count = std::min(iter_count, max_iter);
+
+        predict_Y = h;
+        estimate_X = X;
+
+        // 以最后一次线性化的K与H做Joseph形式更新
+        MatXX A = P - K * (jacobi_H * P);
+        P = A - (A * jacobi_H.transpose()) * K.transpose() + K * R * K.transpose();
+        P = 0.5 * (P + P.transpose()).eval();
+
+        return estimate_X;
+    }
+
+private:
+    template<class Func, int dimO>
+    void evaluate(Func&& func, const VecX& X, Eigen::Matrix<double, dimO, 1>& out, Eigen::Matrix<double, dimO, dimX>& J) {
+        using F = std::remove_cvref_t<Func>;
+
+        if constexpr (requires(F f, const double* x, Eigen::Matrix<double, dimO, dimX>& M) { f.jacobian(x, M); }) {
+            func(X.data(), out.data());
+            func.jacobian(X.data(), J);
+        } else {
+            ceres::Jet<double, dimX> jet_X[dimX];
+            for (int i = 0; i < dimX; i++) {
+                jet_X[i].a = X[i];
+                jet_X[i].v[i] = 1;
+            }
+
+            ceres::Jet<double, dimX> jet_out[dimO];
+            func(jet_X, jet_out);
+
+            for (int i = 0; i < dimO; i++) {
+                out[i] = jet_out[i].a;
+                J.row(i) = jet_out[i].v.transpose();
+            }
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef __OPENRM_KALMAN_FILTER_REPLAY_H__
+#define __OPENRM_KALMAN_FILTER_REPLAY_H__
+
+#include <array>
+#include <utils/timer.h>
+
+// Out-of-sequence measurement wrapper for KF-like filters (EKF, SEKF, SREKF, UKF, IEKF)
+// Keeps the last Size measurements with their posterior state and covariance, sorted by time.
+// A measurement older than the latest one rolls the filter back to the last posterior before it
+// and replays every later measurement, so predict never sees a negative dt.
+// FuncA must expose the public member dt as every FuncA in kalman/interface does.
+
+template<class Filter, int Size = 16>
+class ReplayFilter : public Filter {
+public:
+    using typename Filter::MatXX;
+    using typename Filter::VecX;
+    using typename Filter::VecY;
+
+    ReplayFilter() : Filter() {}
+
+    void restart() {
+        Filter::restart();
+        count_ = 0;
+    }
+
+    // 返回false表示测量早于缓存中最早的一帧，已被丢弃
+    template<class FuncA, class FuncH>
+    bool push(FuncA& funcA, FuncH& funcH, const VecY& Y, TimePoint t) {
+        if (count_ == 0) {
+            funcA.dt = 0;
+            step(funcA, funcH, Y);
+            insert(0, t, Y);
+            return true;
+        }
+
+        // 按时间顺序到达时直接更新
+        if (getDoubleOfS(history_[count_ - 1].t, t) >= 0) {
+            funcA.dt = getDoubleOfS(history_[count_ - 1].t, t);
+            step(funcA, funcH, Y);
+            insert(count_, t, Y);
+            return true;
+        }
+
+        // 找到最后一个早于该测量的后验，回滚后依次重放
+        int index = count_ - 1;
+        while (index >= 0 && getDoubleOfS(history_[index].t, t) < 0) index--;
+        if (index < 0) return false;
+
+        this->estimate_X = history_[index].X;
+        if constexpr (requires(Filter f, const MatXX& m) { f.setP(m); }) {
+            this->setP(history_[index].P);
+        } else {
+            this->P = history_[index].P;
+        }
+        funcA.dt = getDoubleOfS(history_[index].t, t);
+        step(funcA, funcH, Y);
+        int pos = insert(index + 1, t, Y);
+
+        for (int i = pos + 1; i < count_; i++) {
+            funcA.dt = getDoubleOfS(history_[i - 1].t, history_[i].t);
+            step(funcA, funcH, history_[i].Y);
+            history_[i].X = this->estimate_X;
+            history_[i].P = this->P;
+        }
+        replay_count_++;
+        return true;
+    }
+
+    TimePoint getLastTime() const { return history_[count_ - 1].t; }       // Time of the newest measurement
+    int getHistorySize() const { return count_; }                          // Measurements kept for replay
+    int getReplayCount() const { return replay_count_; }                   // Out-of-sequence measurements handled
+
+private:
+    struct Entry {
+        TimePoint t;
+        VecY      Y;
+        VecX      X;
+        MatXX     P;
+    };
+
+    template<class FuncA, class FuncH>
+    void step(FuncA& funcA, FuncH& funcH, const VecY& Y) {
+        this->predict(funcA);
+        this->update(funcH, Y);
+    }
+
+    // 在pos处插入当前后验，缓存满时丢弃最早的一帧，返回插入后的位置
+    int insert(int pos, TimePoint t, const VecY& Y) {
+        if (count_ == Size) {
+            for (int i = 1; i < Size; i++) history_[i - 1] = history_[i];
+            count_--;
+            pos--;
+        }
+        for (int i = count_; i > pos; i--) history_[i] = history_[i - 1];
+        history_[pos] = Entry{t, Y, this->estimate_X, this->P};
+        count_++;
+        return pos;
+    }
+
+    std::array<Entry, Size> history_;       // Posterior of each measurement, sorted by time
+    int count_ = 0;                         // Valid entries in history_
+    int replay_count_ = 0;                  // Out-of-sequence measurements handled
+};
+
+#endif
@@ -0,0 +1,139 @@
+#ifndef __OPENRM_KALMAN_FILTER_SEKF_H__
+#define __OPENRM_KALMAN_FILTER_SEKF_H__
+
+#include <Eigen/Dense>
+#include <ceres/jet.h>
+#include <type_traits>
+#include <opencv2/core/eigen.hpp>
+
+// Sparse EKF, same interface as EKF
+//
+// Optional members of FuncA / FuncH:
+//   void jacobian(const double x[dimX], MatXX& F)   analytic Jacobian, skips Jet evaluation
+//   static constexpr int sparsity[][2]              entries of F that differ from identity
+//
+// With sparsity, F * P * F^T is propagated as P + E * P + P * E^T + E * P * E^T (F = I + E),
+// which costs O(nnz * dimX) instead of O(dimX^3).
+
+template<int dimX, int dimY>
+class SEKF {
+public:
+    using MatXX = Eigen::Matrix<double, dimX, dimX>;
+    using MatXY = Eigen::Matrix<double, dimX, dimY>;
+    using MatYX = Eigen::Matrix<double, dimY, dimX>;
+    using MatYY = Eigen::Matrix<double, dimY, dimY>;
+    using VecX = Eigen::Matrix<double, dimX, 1>;
+    using VecY = Eigen::Matrix<double, dimY, 1>;
+
+    SEKF():
+        estimate_X(VecX::Zero()),
+        P(MatXX::Identity()),
+        Q(MatXX::Identity()),
+        R(MatYY::Identity()) {}
+
+    SEKF(const MatXX& Q0, const MatYY& R0):
+        estimate_X(VecX::Zero()),
+        P(MatXX::Identity()),
+        Q(Q0),
+        R(R0) {}
+
+    void restart() {
+        estimate_X = VecX::Zero();
+        P = MatXX::Identity();
+    }
+
+    VecX estimate_X;
+    VecX predict_X;
+    VecY predict_Y;
+    MatXX jacobi_F;
+    MatYX jacobi_H;
+    MatXX P;
+    MatXX Q;
+    MatYY R;
+    MatXY K;
+
+    template<class Func>
+    VecX predict(Func&& func) {
+        using F = std::remove_cvref_t<Func>;
+
+        if constexpr (requires(F f, const double* x, MatXX& J) { f.jacobian(x, J); }) {
+            func(estimate_X.data(), predict_X.data());
+            func.jacobian(estimate_X.data(), jacobi_F);
+        } else {
+            ceres::Jet<double, dimX> estimate_jet_X[dimX];
+            for (int i = 0; i < dimX; i++) {
+                estimate_jet_X[i].a = estimate_X[i];
+                estimate_jet_X[i].v[i] = 1;
+            }
+
+            ceres::Jet<double, dimX> predict_jet_X[dimX];
+            func(estimate_jet_X, predict_jet_X);
+
+            for (int i = 0; i < dimX; i++) {
+                predict_X[i] = predict_jet_X[i].a;
+                jacobi_F.row(i) = predict_jet_X[i].v.transpose();
+            }
+        }
+
+        if constexpr (requires { F::sparsity; }) {
+            // EP = E * P，只遍历F中偏离单位阵的元素
+            MatXX EP = MatXX::Zero();
+            for (const auto& e : F::sparsity) {
+                double value = jacobi_F(e[0], e[1]) - (e[0] == e[1] ? 1.0 : 0.0);
+                EP.row(e[0]) += value * P.row(e[1]);
+            }
+            MatXX EPE = MatXX::Zero();
+            for (const auto& e : F::sparsity) {
+                double value = jacobi_F(e[0], e[1]) - (e[0] == e[1] ? 1.0 : 0.0);
+                EPE.col(e[0]) += value * EP.col(e[1]);
+            }
+            // 以 M + M^T 形式累加，舍入误差也保持对称，避免长时间运行后P发散
+            MatXX M = EP + 0.5 * EPE;
+            P += M + M.transpose() + Q;
+        } else {
+            P = jacobi_F * P * jacobi_F.transpose() + Q;
+        }
+
+        return predict_X;
+    }
+
+    template<class Func>
+    VecX update(Func&& func, const VecY& Y) {
+        using F = std::remove_cvref_t<Func>;
+
+        if constexpr (requires(F f, const double* x, MatYX& J) { f.jacobian(x, J); }) {
+            func(predict_X.data(), predict_Y.data());
+            func.jacobian(predict_X.data(), jacobi_H);
+        } else {
+            ceres::Jet<double, dimX> predict_jet_X[dimX];
+            for (int i = 0; i < dimX; i++) {
+                predict_jet_X[i].a = predict_X[i];
+                predict_jet_X[i].v[i] = 1;
+            }
+
+            ceres::Jet<double, dimX> predict_jet_Y[dimY];
+            func(predict_jet_X, predict_jet_Y);
+
+            for (int i = 0; i < dimY; i++) {
+                predict_Y[i] = predict_jet_Y[i].a;
+                jacobi_H.row(i) = predict_jet_Y[i].v.transpose();
+            }
+        }
+
+        // K = P * H^T * S^-1，P与S对称，由 S * K^T = H * P 求解
+        MatYX HP = jacobi_H * P;
+        MatYY S = HP * jacobi_H.transpose() + R;
+        K = S.ldlt().solve(HP).transpose();
+        estimate_X = predict_X + K * (Y - predict_Y);
+
+        // Joseph形式 (I-KH)P(I-KH)^T + KRK^T，K存在误差时P也不会失去正定性
+        // 按 A = P - K*HP，A - (A*H^T)*K^T 的顺序结合，只需 O(dimX^2 * dimY)
+        MatXX A = P - K * HP;
+        P = A - (A * jacobi_H.transpose()) * K.transpose() + K * R * K.transpose();
+        P = 0.5 * (P + P.transpose()).eval();
+
+        return estimate_X;
+    }
+};
+
+#endif
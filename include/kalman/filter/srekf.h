@@ -0,0 +1,123 @@
+#ifndef __OPENRM_KALMAN_FILTER_SREKF_H__
+#define __OPENRM_KALMAN_FILTER_SREKF_H__
+
+#include <Eigen/Dense>
+#include <ceres/jet.h>
+#include <type_traits>
+#include <opencv2/core/eigen.hpp>
+#include <kalman/filter/srkf.h>
+
+// Square-root EKF, same interface as EKF
+// FuncA / FuncH may provide jacobian(x, J) as in SEKF to skip Jet evaluation.
+
+template<int dimX, int dimY>
+class SREKF {
+public:
+    using MatXX = Eigen::Matrix<double, dimX, dimX>;
+    using MatXY = Eigen::Matrix<double, dimX, dimY>;
+    using MatYX = Eigen::Matrix<double, dimY, dimX>;
+    using MatYY = Eigen::Matrix<double, dimY, dimY>;
+    using VecX = Eigen::Matrix<double, dimX, 1>;
+    using VecY = Eigen::Matrix<double, dimY, 1>;
+
+    SREKF():
+        estimate_X(VecX::Zero()),
+        P(MatXX::Identity()),
+        S(MatXX::Identity()),
+        Q(MatXX::Identity()),
+        R(MatYY::Identity()) {}
+
+    SREKF(const MatXX& Q0, const MatYY& R0):
+        estimate_X(VecX::Zero()),
+        P(MatXX::Identity()),
+        S(MatXX::Identity()),
+        Q(Q0),
+        R(R0) {}
+
+    void restart() {
+        estimate_X = VecX::Zero();
+        P = MatXX::Identity();
+        S = MatXX::Identity();
+    }
+
+    void setP(const MatXX& P0) {
+        S = srkfSqrt<dimX>(P0);
+        P = S * S.transpose();
+    }
+
+    VecX estimate_X;
+    VecX predict_X;
+    VecY predict_Y;
+    MatXX jacobi_F;
+    MatYX jacobi_H;
+    MatXX P;
+    MatXX S;
+    MatXX Q;
+    MatYY R;
+    MatXY K;
+
+    template<class Func>
+    VecX predict(Func&& func) {
+        using F = std::remove_cvref_t<Func>;
+
+        if constexpr (requires(F f, const double* x, MatXX& J) { f.jacobian(x, J); }) {
+            func(estimate_X.data(), predict_X.data());
+            func.jacobian(estimate_X.data(), jacobi_F);
+        } else {
+            ceres::Jet<double, dimX> estimate_jet_X[dimX];
+            for (int i = 0; i < dimX; i++) {
+                estimate_jet_X[i].a = estimate_X[i];
+                estimate_jet_X[i].v[i] = 1;
+            }
+
+            ceres::Jet<double, dimX> predict_jet_X[dimX];
+            func(estimate_jet_X, predict_jet_X);
+
+            for (int i = 0; i < dimX; i++) {
+                predict_X[i] = predict_jet_X[i].a;
+                jacobi_F.row(i) = predict_jet_X[i].v.transpose();
+            }
+        }
+
+        srkfPredict<dimX>(S, jacobi_F, sqrt_Q_.get(Q));
+        P = S * S.transpose();
+
+        return predict_X;
+    }
+
+    template<class Func>
+    VecX update(Func&& func, const VecY& Y) {
+        using F = std::remove_cvref_t<Func>;
+
+        if constexpr (requires(F f, const double* x, MatYX& J) { f.jacobian(x, J); }) {
+            func(predict_X.data(), predict_Y.data());
+            func.jacobian(predict_X.data(), jacobi_H);
+        } else {
+            ceres::Jet<double, dimX> predict_jet_X[dimX];
+            for (int i = 0; i < dimX; i++) {
+                predict_jet_X[i].a = predict_X[i];
+                predict_jet_X[i].v[i] = 1;
+            }
+
+            ceres::Jet<double, dimX> predict_jet_Y[dimY];
+            func(predict_jet_X, predict_jet_Y);
+
+            for (int i = 0; i < dimY; i++) {
+                predict_Y[i] = predict_jet_Y[i].a;
+                jacobi_H.row(i) = predict_jet_Y[i].v.transpose();
+            }
+        }
+
+        srkfCorrect<dimX, dimY>(S, jacobi_H, sqrt_R_.get(R), K);
+        estimate_X = predict_X + K * (Y - predict_Y);
+        P = S * S.transpose();
+
+        return estimate_X;
+    }
+
+private:
+    SrkfSqrtCache<dimX> sqrt_Q_;
+    SrkfSqrtCache<dimY> sqrt_R_;
+};
+
+#endif
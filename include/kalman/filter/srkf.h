@@ -0,0 +1,156 @@
+#ifndef __OPENRM_KALMAN_FILTER_SRKF_H__
+#define __OPENRM_KALMAN_FILTER_SRKF_H__
+
+#include <Eigen/Dense>
+#include <opencv2/core/eigen.hpp>
+
+// Square-root KF, same interface as KF
+// Covariance is kept as P = S * S^T with S lower triangular and propagated by QR,
+// so P stays symmetric positive semi-definite at any update rate.
+// P is refreshed from S after every step for read access, use setP to overwrite it.
+
+// Lower triangular L with L * L^T = A^T * A
+template<int rows, int cols>
+Eigen::Matrix<double, cols, cols> srkfTria(const Eigen::Matrix<double, rows, cols>& A) {
+    Eigen::HouseholderQR<Eigen::Matrix<double, rows, cols>> qr(A);
+    Eigen::Matrix<double, cols, cols> R = qr.matrixQR().template topRows<cols>().template triangularView<Eigen::Upper>();
+    return R.transpose();
+}
+
+// Square root of a positive semi-definite matrix, allows zeros on the diagonal of Q
+template<int N>
+Eigen::Matrix<double, N, N> srkfSqrt(const Eigen::Matrix<double, N, N>& A) {
+    Eigen::LDLT<Eigen::Matrix<double, N, N>> ldlt(A);
+    Eigen::Matrix<double, N, N> L = ldlt.matrixL();
+    Eigen::Matrix<double, N, 1> d = ldlt.vectorD().cwiseMax(0.0).cwiseSqrt();
+    return ldlt.transpositionsP().transpose() * (L * d.asDiagonal());
+}
+
+// Q与R通常只在初始化时设置，分解结果缓存到矩阵变化为止
+template<int N>
+class SrkfSqrtCache {
+public:
+    const Eigen::Matrix<double, N, N>& get(const Eigen::Matrix<double, N, N>& A) {
+        if (!valid_ || A != last_) {
+            last_ = A;
+            root_ = srkfSqrt<N>(A);
+            valid_ = true;
+        }
+        return root_;
+    }
+
+private:
+    Eigen::Matrix<double, N, N> last_;
+    Eigen::Matrix<double, N, N> root_;
+    bool valid_ = false;
+};
+
+// [ (F*S)^T ; sqrt(Q)^T ] 三角化得到 sqrt(F*P*F^T + Q)
+template<int dimX>
+void srkfPredict(
+    Eigen::Matrix<double, dimX, dimX>& S,
+    const Eigen::Matrix<double, dimX, dimX>& F,
+    const Eigen::Matrix<double, dimX, dimX>& sqrt_Q
+) {
+    Eigen::Matrix<double, 2 * dimX, dimX> pre;
+    pre.template topRows<dimX>() = (F * S).transpose();
+    pre.template bottomRows<dimX>() = sqrt_Q.transpose();
+    S = srkfTria<2 * dimX, dimX>(pre);
+}
+
+// [ sqrt(R)  H*S ]  三角化  [ Sy   0  ]
+// [   0       S  ]   --->   [ Kb  S+  ]    K = Kb * Sy^-1
+template<int dimX, int dimY>
+void srkfCorrect(
+    Eigen::Matrix<double, dimX, dimX>& S,
+    const Eigen::Matrix<double, dimY, dimX>& H,
+    const Eigen::Matrix<double, dimY, dimY>& sqrt_R,
+    Eigen::Matrix<double, dimX, dimY>& K
+) {
+    using MatZZ = Eigen::Matrix<double, dimX + dimY, dimX + dimY>;
+    MatZZ pre = MatZZ::Zero();
+    pre.template topLeftCorner<dimY, dimY>() = sqrt_R;
+    pre.template topRightCorner<dimY, dimX>() = H * S;
+    pre.template bottomRightCorner<dimX, dimX>() = S;
+
+    MatZZ post = srkfTria<dimX + dimY, dimX + dimY>(pre.transpose());
+    Eigen::Matrix<double, dimY, dimY> Sy = post.template topLeftCorner<dimY, dimY>();
+    Eigen::Matrix<double, dimX, dimY> Kb = post.template bottomLeftCorner<dimX, dimY>();
+
+    K = Sy.transpose().template triangularView<Eigen::Upper>().solve(Kb.transpose()).transpose();
+    S = post.template bottomRightCorner<dimX, dimX>();
+}
+
+template<int dimX, int dimY>
+class SRKF {
+public:
+    using MatXX = Eigen::Matrix<double, dimX, dimX>;
+    using MatXY = Eigen::Matrix<double, dimX, dimY>;
+    using MatYX = Eigen::Matrix<double, dimY, dimX>;
+    using MatYY = Eigen::Matrix<double, dimY, dimY>;
+    using VecX = Eigen::Matrix<double, dimX, 1>;
+    using VecY = Eigen::Matrix<double, dimY, 1>;
+
+    SRKF():
+        estimate_X(VecX::Zero()),
+        P(MatXX::Identity()),
+        S(MatXX::Identity()),
+        Q(MatXX::Identity()),
+        R(MatYY::Identity()) {}
+
+    SRKF(const MatXX& Q0, const MatYY& R0):
+        estimate_X(VecX::Zero()),
+        P(MatXX::Identity()),
+        S(MatXX::Identity()),
+        Q(Q0),
+        R(R0) {}
+
+    void restart() {
+        estimate_X = VecX::Zero();
+        P = MatXX::Identity();
+        S = MatXX::Identity();
+    }
+
+    void setP(const MatXX& P0) {
+        S = srkfSqrt<dimX>(P0);
+        P = S * S.transpose();
+    }
+
+    VecX estimate_X;
+    VecX predict_X;
+    MatXX A;
+    MatYX H;
+    MatXX P;
+    MatXX S;
+    MatXX Q;
+    MatYY R;
+    MatXY K;
+
+    template<class Func>
+    VecX predict(Func&& func) {
+
+        func(A);
+        predict_X = A * estimate_X;
+        srkfPredict<dimX>(S, A, sqrt_Q_.get(Q));
+        P = S * S.transpose();
+
+        return predict_X;
+    }
+
+    template<class Func>
+    VecX update(Func&& func, const VecY& Y) {
+
+        func(H);
+        srkfCorrect<dimX, dimY>(S, H, sqrt_R_.get(R), K);
+        estimate_X = predict_X + K * (Y - H * predict_X);
+        P = S * S.transpose();
+
+        return estimate_X;
+    }
+
+private:
+    SrkfSqrtCache<dimX> sqrt_Q_;
+    SrkfSqrtCache<dimY> sqrt_R_;
+};
+
+#endif
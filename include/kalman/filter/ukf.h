@@ -0,0 +1,123 @@
+#ifndef __OPENRM_KALMAN_FILTER_UKF_H__
+#define __OPENRM_KALMAN_FILTER_UKF_H__
+
+#include <Eigen/Dense>
+#include <opencv2/core/eigen.hpp>
+#include <kalman/filter/srkf.h>
+
+// Unscented KF, same interface as EKF
+// FuncA / FuncH are evaluated on 2 * dimX + 1 sigma points with T = double, no Jacobian is needed.
+// Scaled unscented transform, default alpha = 1, beta = 2, kappa = 3 - dimX (sigma spread of sqrt(3) std).
+
+template<int dimX, int dimY>
+class UKF {
+public:
+    using MatXX = Eigen::Matrix<double, dimX, dimX>;
+    using MatXY = Eigen::Matrix<double, dimX, dimY>;
+    using MatYX = Eigen::Matrix<double, dimY, dimX>;
+    using MatYY = Eigen::Matrix<double, dimY, dimY>;
+    using VecX = Eigen::Matrix<double, dimX, 1>;
+    using VecY = Eigen::Matrix<double, dimY, 1>;
+
+    static constexpr int dimS = 2 * dimX + 1;
+    using MatXS = Eigen::Matrix<double, dimX, dimS>;
+    using MatYS = Eigen::Matrix<double, dimY, dimS>;
+    using VecS = Eigen::Matrix<double, dimS, 1>;
+
+    UKF():
+        estimate_X(VecX::Zero()),
+        P(MatXX::Identity()),
+        Q(MatXX::Identity()),
+        R(MatYY::Identity()) { setScaling(1.0, 2.0, 3.0 - dimX); }
+
+    UKF(const MatXX& Q0, const MatYY& R0):
+        estimate_X(VecX::Zero()),
+        P(MatXX::Identity()),
+        Q(Q0),
+        R(R0) { setScaling(1.0, 2.0, 3.0 - dimX); }
+
+    void restart() {
+        estimate_X = VecX::Zero();
+        P = MatXX::Identity();
+    }
+
+    void setScaling(double alpha, double beta, double kappa) {
+        double lambda = alpha * alpha * (dimX + kappa) - dimX;
+        scale_ = dimX + lambda;
+        Wm_.setConstant(0.5 / scale_);
+        Wc_.setConstant(0.5 / scale_);
+        Wm_(0) = lambda / scale_;
+        Wc_(0) = lambda / scale_ + (1 - alpha * alpha + beta);
+    }
+
+    VecX estimate_X;
+    VecX predict_X;
+    VecY predict_Y;
+    MatXX P;
+    MatXX Q;
+    MatYY R;
+    MatXY K;
+
+    template<class Func>
+    VecX predict(Func&& func) {
+        getSigma(estimate_X);
+
+        MatXS sigma_predict;
+        for (int i = 0; i < dimS; i++) {
+            func(sigma_X_.col(i).data(), sigma_predict.col(i).data());
+        }
+
+        predict_X = sigma_predict * Wm_;
+        MatXS dX = sigma_predict.colwise() - predict_X;
+        P = dX * Wc_.asDiagonal() * dX.transpose() + Q;
+
+        return predict_X;
+    }
+
+    template<class Func>
+    VecX update(Func&& func, const VecY& Y) {
+        // 由预测协方差重新采样，使过程噪声Q也反映到观测的分布中
+        getSigma(predict_X);
+
+        MatYS sigma_Y;
+        for (int i = 0; i < dimS; i++) {
+            func(sigma_X_.col(i).data(), sigma_Y.col(i).data());
+        }
+
+        predict_Y = sigma_Y * Wm_;
+        MatYS dY = sigma_Y.colwise() - predict_Y;
+        MatXS dX = sigma_X_.colwise() - predict_X;
+        MatYY S = dY * Wc_.asDiagonal() * dY.transpose() + R;
+        MatXY C = dX * Wc_.asDiagonal() * dY.transpose();
+
+        K = S.ldlt().solve(C.transpose()).transpose();
+        estimate_X = predict_X + K * (Y - predict_Y);
+        P -= K * S * K.transpose();
+        P = 0.5 * (P + P.transpose()).eval();
+
+        return estimate_X;
+    }
+
+private:
+    void getSigma(const VecX& X) {
+        MatXX root;
+        Eigen::LLT<MatXX> llt(scale_ * P);
+        if (llt.info() == Eigen::Success) {
+            root = llt.matrixL();
+        } else {
+            root = srkfSqrt<dimX>(scale_ * P);
+        }
+        sigma_X_.col(0) = X;
+        for (int i = 0; i < dimX; i++) {
+            sigma_X_.col(1 + i) = X + root.col(i);
+            sigma_X_.col(1 + dimX + i) = X - root.col(i);
+        }
+    }
+
+    double scale_;                          // dimX + lambda
+    VecS   Wm_;                             // Weights of mean
+    VecS   Wc_;                             // Weights of covariance
+    MatXS  sigma_X_;                        // Sigma points of last step
+};
+
+#endif
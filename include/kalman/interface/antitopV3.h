@@ -1,10 +1,17 @@
 #ifndef __OPENRM_KALMAN_INTERFACE_ANTITOP_V3_H__
 #define __OPENRM_KALMAN_INTERFACE_ANTITOP_V3_H__
 #include <utils/timer.h>
+#include <structure/trajectory.hpp>
 #include <kalman/filter/ekf.h>
+#include <kalman/filter/sekf.h>
+#include <kalman/filter/srkf.h>
+#include <kalman/filter/srekf.h>
+#include <kalman/filter/ukf.h>
+#include <kalman/filter/iekf.h>
 #include <kalman/filter/kf.h>
 #include <structure/slidestd.hpp>
 #include <structure/slideweighted.hpp>
+#include <kalman/tuner.h>
 #include <algorithm>
 
 // [ x, y, z, theta, vx, vy, vz, omega, r ]  [ x, y, z, theta]
@@ -18,6 +25,26 @@
 
 namespace rm {
 
+// High update rates can define OPENRM_SQRT_KALMAN to keep P positive definite with square-root filters
+// The r * cos(theta) observation can define OPENRM_UKF_KALMAN or OPENRM_IEKF_KALMAN to switch motion model filter
+#if defined(OPENRM_UKF_KALMAN)
+typedef UKF<9, 4>   AntitopV3_Model;
+#elif defined(OPENRM_IEKF_KALMAN)
+typedef IEKF<9, 4>  AntitopV3_Model;
+#elif defined(OPENRM_SQRT_KALMAN)
+typedef SREKF<9, 4> AntitopV3_Model;
+#else
+typedef SEKF<9, 4>  AntitopV3_Model;
+#endif
+
+#ifdef OPENRM_SQRT_KALMAN
+typedef SRKF<4, 2>  AntitopV3_CenterModel;
+typedef SRKF<3, 1>  AntitopV3_OmegaModel;
+#else
+typedef KF<4, 2>    AntitopV3_CenterModel;
+typedef KF<3, 1>    AntitopV3_OmegaModel;
+#endif
+
 struct AntitopV3_FuncA {
     template<class T>
     void operator()(const T x0[9], T x1[9]) {
@@ -31,6 +58,15 @@ struct AntitopV3_FuncA {
         x1[7] = x0[7];
         x1[8] = x0[8];
     }
+    template<class M>
+    void jacobian(const double*, M& F) {
+        F = M::Identity();
+        F(0, 4) = dt;
+        F(1, 5) = dt;
+        F(2, 6) = dt;
+        F(3, 7) = dt;
+    }
+    static constexpr int sparsity[][2] = {{0, 4}, {1, 5}, {2, 6}, {3, 7}};
     double dt;
 };
 
@@ -42,6 +78,19 @@ struct AntitopV3_FuncH {
         y[2] = x[2];
         y[3] = x[3];
     }
+    template<class M>
+    void jacobian(const double x[9], M& H) {
+        double c = cos(x[3]), s = sin(x[3]);
+        H = M::Zero();
+        H(0, 0) = 1;
+        H(0, 3) = x[8] * s;
+        H(0, 8) = -c;
+        H(1, 1) = 1;
+        H(1, 3) = -x[8] * c;
+        H(1, 8) = -s;
+        H(2, 2) = 1;
+        H(3, 3) = 1;
+    }
 };
 
 struct AntitopV3_CenterFuncA{
@@ -82,8 +131,6 @@ struct AntitopV3_OmegaFuncH {
     }
 };
 
-
-
 // AntitopV3 class
 // Uses Extended Kalman Filter based center prediction model
 class AntitopV3 {
@@ -96,6 +143,8 @@ public:
     void push(const Eigen::Matrix<double, 4, 1>& pose, TimePoint t);
     Eigen::Matrix<double, 4, 1> getPose(double append_delay);
     Eigen::Matrix<double, 4, 1> getCenter(double append_delay);
+    Eigen::Matrix<double, 3, 3> getPoseCov(double append_delay);            // Position covariance of getPose, infinite without target
+    template<int N> Trajectory<N> getTrajectory(double t0, double dt);      // Poses at append delay t0 + i * dt from one state snapshot
 
     void setMatrixQ(double, double, double, double, double, double, double, double, double);
     void setMatrixR(double, double, double, double);
@@ -105,6 +154,8 @@ public:
     void setOmegaMatrixR(double);
     void setRadiusRange(double r_min, double r_max) { r_min_ = r_min; r_max_ = r_max; }
     void setArmorNum(int armor_num) { armor_num_ = armor_num; }
+    void setRecord(bool record);                                            // Record measurements of push for rm::tuneCMAES
+    bool saveRecord(const std::string& file) { return writeTunerLog(file, record_); }
     void setFireValue(int update_num, double delay, double armor_angle, double center_angle) {
         fire_update_ = update_num;
         fire_delay_ = delay;
@@ -117,14 +168,16 @@ public:
     bool   getFireArmor(const Eigen::Matrix<double, 4, 1>& pose);
     bool   getFireCenter(const Eigen::Matrix<double, 4, 1>& pose);
 
+    // 装甲板切换的角度处理, push 与调参重放 AntitopV3_TunerAlign 共用
+    static double getSafeSub(const double, const double);                               // Safe subtraction for angles
+    static double getAngleTrans(const double, const double, int armor_num);             // Convert angle in model to approach new angle
+    static double getAngleTrans(const double, const double, double, int armor_num);     // Convert angle in model to approach new angle, considering prediction
+    static int    getToggle(const double, const double, int toggle, int armor_num);     // Get toggle label
+    static bool   isAngleTrans(const double, const double, int armor_num);              // Determine if toggle occurs based on angle
+
 private:
-    double getSafeSub(const double, const double);                  // Safe subtraction for angles
-    double getAngleTrans(const double, const double);               // Convert angle in model to approach new angle
-    double getAngleTrans(const double, const double, double);       // Convert angle in model to approach new angle, considering prediction
     double getAngleMin(const double, const double, const double);   // Get minimum angle
-    int    getToggle(const double, const double);                   // Get toggle label
     double getWeightByTheta(const double);                          // Get weight based on angle
-    bool   isAngleTrans(const double, const double);                
 
     double   r_[2] = {0.25, 0.25};                                  // Radius of two poses
     double   z_[2] = {0, 0};                                        // Height of two poses
@@ -143,9 +196,9 @@ private:
 
     bool     enable_weighted_ = false;                              // Whether to use weighted average z value
     
-    EKF<9, 4>              model_;                                  // Motion model
-    KF<4, 2>               center_model_;                           // Center model
-    KF<3, 1>               omega_model_;                            // Angular velocity model
+    AntitopV3_Model        model_;                                  // Motion model
+    AntitopV3_CenterModel  center_model_;                           // Center model
+    AntitopV3_OmegaModel   omega_model_;                            // Angular velocity model
 
     SlideWeightedAvg<double>* weighted_z_;                          // Weighted average z value
     
@@ -157,8 +210,72 @@ private:
     AntitopV3_OmegaFuncH   omega_funcH_;                            // Observation function of angular velocity model
 
     TimePoint t_;                                                   // Last update time
+
+    bool      record_flag_ = false;                                 // Whether to record measurements
+    TimePoint record_t0_;                                           // Time origin of recorded measurements
+    TunerLog  record_;                                              // Recorded measurements
 };
 
+// 重放记录时复现 push 中的装甲板切换: 按整块装甲板平移角度，按 toggle 切换两组半径与高度
+// 独立的角速度 KF 不参与重放，角度与角速度直接取自运动模型
+struct AntitopV3_TunerAlign {
+    template<class M>
+    bool operator()(const TunerSample& sample, double dt, M& X) {
+        double theta = sample.pose[3];
+        if (!started) {
+            r[0] = r[1] = X[8];
+            z[0] = z[1] = X[2];
+            started = true;
+            return true;
+        }
+        z[toggle] = X[2];
+        r[toggle] = std::clamp(X[8], r_min, r_max);
+
+        if (armor_num == 2) {
+            toggle = 0;
+            if (dt > 0.05) {
+                X[3] = theta;
+                return false;
+            }
+        } else {
+            toggle = AntitopV3::getToggle(theta, X[3], toggle, armor_num);
+            if (AntitopV3::isAngleTrans(theta, X[3] + X[7] * dt, armor_num)) {
+                X[3] = theta;
+                return false;
+            }
+        }
+
+        X[3] = AntitopV3::getAngleTrans(theta, X[3], X[3] + X[7] * dt, armor_num);
+        X[2] = z[toggle];
+        X[8] = r[toggle];
+        return true;
+    }
+
+    int    armor_num = 4;
+    double r_min = 0.15;
+    double r_max = 0.4;
+    int    toggle = 0;
+    bool   started = false;
+    double r[2] = {0.25, 0.25};
+    double z[2] = {0.0, 0.0};
+};
+
+template<int N>
+Trajectory<N> AntitopV3::getTrajectory(double t0, double dt) {
+    Trajectory<N> trajectory(t0, dt);
+    double sys_delay = getDoubleOfS(t_, trajectory.base);
+    if (sys_delay > fire_delay_) return trajectory;
+
+    double h[2];
+    for (int i = 0; i < 2; i++) h[i] = enable_weighted_ ? weighted_z_[i].getAvg() : z_[i];
+    int toggle = (armor_num_ < 4) ? 0 : toggle_;
+    getSpinTrajectory<N>(
+        trajectory, trajectory.delay + sys_delay,
+        model_.estimate_X[0], model_.estimate_X[1], model_.estimate_X[4], model_.estimate_X[5], 0.0,
+        omega_model_.estimate_X[0], omega_model_.estimate_X[1], armor_num_, r_, h, toggle);
+    return trajectory;
+}
+
 }
 
 #endif
\ No newline at end of file
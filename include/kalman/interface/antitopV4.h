@@ -0,0 +1,118 @@
+#ifndef __OPENRM_KALMAN_INTERFACE_ANTITOP_V4_H__
+#define __OPENRM_KALMAN_INTERFACE_ANTITOP_V4_H__
+#include <utils/timer.h>
+#include <structure/trajectory.hpp>
+#include <kalman/filter/sekf.h>
+#include <kalman/filter/srekf.h>
+#include <kalman/interface/antitopV3.h>
+#include <Eigen/Dense>
+#include <string>
+#include <vector>
+
+// [ x, y, z, theta, vx, vy, vz, omega, r ]  [ x, y, z, theta ]
+// [ 0, 1, 2,   3,   4,  5,  6,    7,   8 ]  [ 0, 1, 2,   3   ]
+
+// Each hypothesis assumes an armor number and an initial radius,
+// all hypotheses share the AntitopV3 motion model and are updated on every push.
+
+namespace rm {
+
+constexpr int ANTITOP_ARMOR_HYPO_V4 = 3;                            // Armor number 2, 3 and 4
+constexpr int ANTITOP_RADIUS_HYPO_V4 = 2;                           // Initial radius for each armor number
+constexpr int ANTITOP_HYPO_NUM_V4 = ANTITOP_ARMOR_HYPO_V4 * ANTITOP_RADIUS_HYPO_V4;
+
+#ifdef OPENRM_SQRT_KALMAN
+typedef SREKF<9, 4> AntitopV4_Model;
+#else
+typedef SEKF<9, 4>  AntitopV4_Model;
+#endif
+
+
+// AntitopV4 class
+// Multi-hypothesis antitop, armor number and radius are chosen by likelihood instead of configured
+class AntitopV4 {
+
+public:
+    AntitopV4();
+    AntitopV4(double r_min, double r_max);
+    ~AntitopV4() {}
+
+    void push(const Eigen::Matrix<double, 4, 1>& pose, TimePoint t);
+    Eigen::Matrix<double, 4, 1> getPose(double append_delay);
+    Eigen::Matrix<double, 4, 1> getCenter(double append_delay);
+    template<int N> Trajectory<N> getTrajectory(double t0, double dt);      // Poses at append delay t0 + i * dt from one state snapshot
+
+    void setMatrixQ(double, double, double, double, double, double, double, double, double);
+    void setMatrixR(double, double, double, double);
+    void setRadiusRange(double r_min, double r_max) { r_min_ = r_min; r_max_ = r_max; }
+    void setRadiusInit(double r0, double r1) { r_init_[0] = r0; r_init_[1] = r1; }
+    void setForget(double forget) { forget_ = forget; }             // Decay of accumulated log likelihood per push
+    void setSwitchMargin(double margin) { switch_margin_ = margin; }
+    void setFireValue(int update_num, double delay, double armor_angle, double center_angle) {
+        fire_update_ = update_num;
+        fire_delay_ = delay;
+        fire_armor_angle_ = armor_angle;
+        fire_center_angle_ = center_angle;
+    }
+
+    int    getArmorNum() { return armor_num_[best_]; }             // Armor number of chosen hypothesis
+    double getProbability(int armor_num);                           // Probability of armor number over all radii
+    double getOmega() { return model_[best_].estimate_X[7]; }
+    void   getStateStr(std::vector<std::string>& str);
+    bool   getFireArmor(const Eigen::Matrix<double, 4, 1>& pose);
+    bool   getFireCenter(const Eigen::Matrix<double, 4, 1>& pose);
+
+private:
+    void   restart(const Eigen::Matrix<double, 4, 1>& pose);
+    double step(int index, const Eigen::Matrix<double, 4, 1>& pose);  // Predict and update one hypothesis, return log likelihood
+    double getSafeSub(const double, const double);                  // Safe subtraction for angles
+    double getAngleAlign(double angle, double target, int armor_num, int& shift);   // Shift angle by whole armors to approach target
+
+    double   r_min_ = 0.15;                                         // Minimum radius
+    double   r_max_ = 0.4;                                          // Maximum radius
+    double   r_init_[ANTITOP_RADIUS_HYPO_V4] = {0.2, 0.3};          // Initial radius of hypotheses
+    double   forget_ = 0.95;                                        // Decay of accumulated log likelihood
+    double   switch_margin_ = 2.0;                                  // Log likelihood margin to change chosen hypothesis
+
+    int      fire_update_ = 100;                                    // Fire update count
+    double   fire_delay_ = 0.5;                                     // Maximum delay considered for model availability
+    double   fire_armor_angle_ = 0.5;                               // Fire angle in follow mode
+    double   fire_center_angle_ = 0.2;                              // Fire angle for armor plate in center mode
+
+    int      update_num_ = 0;                                       // Update count
+    int      best_ = 0;                                             // Index of chosen hypothesis
+
+    // 假设的标量状态按列存放, 似然归一化一次处理全部假设
+    // 只有标量采用结构数组, 各假设的滤波器仍是 SEKF 数组, 其定长矩阵运算已由 Eigen 向量化
+    Eigen::Array<int, ANTITOP_HYPO_NUM_V4, 1>    armor_num_;        // Armor number of hypotheses
+    Eigen::Array<int, ANTITOP_HYPO_NUM_V4, 1>    toggle_;           // Toggle label of hypotheses
+    Eigen::Array<double, ANTITOP_HYPO_NUM_V4, 2> r_;                // Radius of two armor pairs
+    Eigen::Array<double, ANTITOP_HYPO_NUM_V4, 2> z_;                // Height of two armor pairs
+    Eigen::Array<double, ANTITOP_HYPO_NUM_V4, 1> score_;            // Accumulated log likelihood
+    Eigen::Array<double, ANTITOP_HYPO_NUM_V4, 1> mu_;               // Hypothesis probabilities
+
+    AntitopV4_Model        model_[ANTITOP_HYPO_NUM_V4];             // Motion models run in parallel
+    AntitopV3_FuncA        funcA_;                                  // State transition function of all hypotheses
+    AntitopV3_FuncH        funcH_;                                  // Observation function of all hypotheses
+
+    TimePoint t_;                                                   // Last update time
+};
+
+template<int N>
+Trajectory<N> AntitopV4::getTrajectory(double t0, double dt) {
+    Trajectory<N> trajectory(t0, dt);
+    double sys_delay = getDoubleOfS(t_, trajectory.base);
+    if ((update_num_ == 0) || (sys_delay > fire_delay_)) return trajectory;
+
+    const auto& X = model_[best_].estimate_X;
+    double r[2] = {r_(best_, 0), r_(best_, 1)};
+    double h[2] = {z_(best_, 0), z_(best_, 1)};
+    getSpinTrajectory<N>(
+        trajectory, trajectory.delay + sys_delay,
+        X[0], X[1], X[4], X[5], 0.0, X[3], X[7], armor_num_[best_], r, h, toggle_[best_]);
+    return trajectory;
+}
+
+}
+
+#endif
@@ -0,0 +1,148 @@
+#ifndef __OPENRM_KALMAN_INTERFACE_IMM_V1_H__
+#define __OPENRM_KALMAN_INTERFACE_IMM_V1_H__
+#include <utils/timer.h>
+#include <structure/trajectory.hpp>
+#include <kalman/filter/sekf.h>
+#include <kalman/interface/antitopV3.h>
+#include <kalman/interface/outpostV2.h>
+
+// [ x, y, z, theta, vx, vy, vz, omega, r ]  [ x, y, z, theta ]
+// [ 0, 1, 2,   3,   4,  5,  6,    7,   8 ]  [ 0, 1, 2,   3   ]
+
+// All models share the state of AntitopV3 so they can be mixed,
+// the spin model is the AntitopV3 motion model itself.
+
+namespace rm {
+
+constexpr int IMM_MODEL_NUM_V1 = 3;
+constexpr int IMM_TRANSLATE_V1 = 0;     // Translation without spinning, as TrackQueueV4
+constexpr int IMM_SPIN_V1 = 1;          // Spinning with free omega and radius, as AntitopV3
+constexpr int IMM_OUTPOST_V1 = 2;       // Static center with fixed omega and radius, as OutpostV2
+
+typedef SEKF<9, 4> IMMV1_Model;
+
+struct IMMV1_TranslateFuncA {
+    template<class T>
+    void operator()(const T x0[9], T x1[9]) {
+        x1[0] = x0[0] + dt * x0[4];
+        x1[1] = x0[1] + dt * x0[5];
+        x1[2] = x0[2] + dt * x0[6];
+        x1[3] = x0[3];
+        x1[4] = x0[4];
+        x1[5] = x0[5];
+        x1[6] = x0[6];
+        x1[7] = T(0);
+        x1[8] = x0[8];
+    }
+    template<class M>
+    void jacobian(const double*, M& F) {
+        F = M::Identity();
+        F(0, 4) = dt;
+        F(1, 5) = dt;
+        F(2, 6) = dt;
+        F(7, 7) = 0;
+    }
+    static constexpr int sparsity[][2] = {{0, 4}, {1, 5}, {2, 6}, {7, 7}};
+    double dt;
+};
+
+struct IMMV1_OutpostFuncA {
+    template<class T>
+    void operator()(const T x0[9], T x1[9]) {
+        x1[0] = x0[0];
+        x1[1] = x0[1];
+        x1[2] = x0[2];
+        x1[3] = x0[3] + dt * x0[7];
+        x1[4] = T(0);
+        x1[5] = T(0);
+        x1[6] = T(0);
+        x1[7] = (x0[7] >= T(0)) ? T(OUTPOST_OMEGA_V2) : T(-OUTPOST_OMEGA_V2);
+        x1[8] = T(OUTPOST_R_V2);
+    }
+    template<class M>
+    void jacobian(const double*, M& F) {
+        F = M::Identity();
+        F(3, 7) = dt;
+        F(4, 4) = 0;
+        F(5, 5) = 0;
+        F(6, 6) = 0;
+        F(7, 7) = 0;
+        F(8, 8) = 0;
+    }
+    static constexpr int sparsity[][2] = {{3, 7}, {4, 4}, {5, 5}, {6, 6}, {7, 7}, {8, 8}};
+    double dt;
+};
+
+
+// IMMV1 class
+// Interacting multiple model estimator, runs translation, spin and outpost models in parallel
+class IMMV1 {
+
+public:
+    IMMV1();
+    IMMV1(int armor_num, double r_init = 0.25);
+    ~IMMV1() {}
+
+    void push(const Eigen::Matrix<double, 4, 1>& pose, TimePoint t);
+    Eigen::Matrix<double, 4, 1> getPose(double append_delay);
+    Eigen::Matrix<double, 4, 1> getCenter(double append_delay);
+    template<int N> Trajectory<N> getTrajectory(double t0, double dt);      // Poses at append delay t0 + i * dt from one state snapshot
+
+    void setMatrixQ(int index, double, double, double, double, double, double, double, double, double);
+    void setMatrixR(double, double, double, double);
+    void setTransition(double p_stay);                              // Probability of keeping the same model between two updates
+    void setTransition(const Eigen::Matrix<double, 3, 3>& p) { transition_ = p; }
+    void setArmorNum(int armor_num) { armor_num_ = armor_num; }
+    void setDelay(double delay) { delay_ = delay; }
+
+    int    getModelIndex();                                         // Most probable model
+    double getProbability(int index) { return mu_[index]; }         // Probability of model
+    double getOmega() { return estimate_X_[7]; }
+    void   getStateStr(std::vector<std::string>& str);
+
+private:
+    void   restart(const Eigen::Matrix<double, 4, 1>& pose);
+    void   mix();                                                   // Mix model states by Markov transition before predict
+    int    getArmorNum(int index);                                  // Armor number assumed by model
+    double getAngleAlign(double angle, double target, int armor_num);   // Shift angle by whole armors to approach target
+
+    template<class Func>
+    double step(int index, Func& funcA, const Eigen::Matrix<double, 4, 1>& pose);  // Predict and update one model, return log likelihood
+
+    int      armor_num_ = 4;                                        // Number of armor plates
+    double   r_init_ = 0.25;                                        // Initial radius
+    double   delay_ = 0.5;                                          // Maximum delay without reset
+    int      update_num_ = 0;                                       // Update count
+
+    IMMV1_Model                  model_[IMM_MODEL_NUM_V1];          // Models run in parallel
+    Eigen::Matrix<double, 9, 1>  estimate_X_;                       // Mixed state of all models
+    Eigen::Matrix<double, 9, 9>  P_;                                // Mixed covariance of all models
+    Eigen::Matrix<double, 3, 1>  mu_;                               // Model probabilities
+    Eigen::Matrix<double, 3, 3>  transition_;                       // Markov transition, transition_(i, j) = p(j | i)
+
+    IMMV1_TranslateFuncA   translate_funcA_;                        // State transition function of translation model
+    AntitopV3_FuncA        spin_funcA_;                             // State transition function of spin model
+    IMMV1_OutpostFuncA     outpost_funcA_;                          // State transition function of outpost model
+    AntitopV3_FuncH        funcH_;                                  // Observation function of all models
+
+    TimePoint t_;                                                   // Last update time
+};
+
+template<int N>
+Trajectory<N> IMMV1::getTrajectory(double t0, double dt) {
+    Trajectory<N> trajectory(t0, dt);
+    double sys_delay = getDoubleOfS(t_, trajectory.base);
+    if ((update_num_ == 0) || (sys_delay > delay_)) return trajectory;
+
+    double r[2] = {estimate_X_[8], estimate_X_[8]};
+    double h[2] = {estimate_X_[2], estimate_X_[2]};
+    getSpinTrajectory<N>(
+        trajectory, trajectory.delay + sys_delay,
+        estimate_X_[0], estimate_X_[1], estimate_X_[4], estimate_X_[5], estimate_X_[6],
+        estimate_X_[3], estimate_X_[7], getArmorNum(getModelIndex()), r, h, 0);
+    return trajectory;
+}
+
+}
+
+#endif
@@ -5,6 +5,7 @@
 #include <kalman/filter/kf.h>
 #include <structure/slidestd.hpp>
 #include <structure/slideweighted.hpp>
+#include <structure/trajectory.hpp>
 #include <algorithm>
 
 // [ x, y, z, theta， omega ]  [ x, y, z, theta]
@@ -68,6 +69,7 @@ public:
     void push(const Eigen::Matrix<double, 4, 1>& pose, TimePoint t);
     Eigen::Matrix<double, 4, 1> getPose(double append_delay);
     Eigen::Matrix<double, 4, 1> getCenter(double append_delay);
+    template<int N> Trajectory<N> getTrajectory(double t0, double dt);      // Poses at append delay t0 + i * dt from one state snapshot
 
     void setMatrixQ(double, double, double, double, double);
     void setMatrixR(double, double, double, double);
@@ -122,6 +124,22 @@ private:
     SlideWeightedAvg<double> weighted_z_;
 };
 
+template<int N>
+Trajectory<N> OutpostV1::getTrajectory(double t0, double dt) {
+    Trajectory<N> trajectory(t0, dt);
+    double sys_delay = getDoubleOfS(t_, trajectory.base);
+    if (sys_delay > fire_delay_) return trajectory;
+
+    double z_center = enable_weighted_ ? weighted_z_.getAvg() : center_z_.getAvg();
+    double omega = (omega_.getAvg() > 0) ? OUTPOST_OMEGA : -OUTPOST_OMEGA;
+    double r[2] = {OUTPOST_R, OUTPOST_R};
+    double h[2] = {z_center, z_center};
+    getSpinTrajectory<N>(
+        trajectory, trajectory.delay + sys_delay,
+        center_x_.getAvg(), center_y_.getAvg(), 0.0, 0.0, 0.0,
+        model_.estimate_X[3], omega, 3, r, h, 0);
+    return trajectory;
+}
 
 }
 
@@ -1,10 +1,16 @@
 #ifndef __OPENRM_KALMAN_INTERFACE_OUTPOST_V2_H__
 #define __OPENRM_KALMAN_INTERFACE_OUTPOST_V2_H__
 #include <utils/timer.h>
+#include <structure/trajectory.hpp>
 #include <kalman/filter/ekf.h>
+#include <kalman/filter/sekf.h>
+#include <kalman/filter/srkf.h>
+#include <kalman/filter/srekf.h>
 #include <kalman/filter/kf.h>
 #include <structure/slidestd.hpp>
+#include <kalman/tuner.h>
 #include <algorithm>
+#include <vector>
 
 // [ x, y, z, theta, vx, vy, vz, omega ]  [ x, y, z, theta]
 // [ 0, 1, 2,   3,   4,  5,  6,    7   ]  [ 0, 1, 2,   3  ]
@@ -16,6 +22,16 @@ namespace rm  {
 
 constexpr double OUTPOST_OMEGA_V2 = 0.8 * M_PI;
 constexpr double OUTPOST_R_V2 = 0.2765;
+constexpr double OUTPOST_OMEGA_LOCK_V2 = 0.1;     // Max relative deviation of omega from KF to OUTPOST_OMEGA_V2
+
+// High update rates can define OPENRM_SQRT_KALMAN to keep P positive definite with square-root filters
+#ifdef OPENRM_SQRT_KALMAN
+typedef SREKF<8, 4> OutpostV2_Model;
+typedef SRKF<2, 1>  OutpostV2_OmegaModel;
+#else
+typedef SEKF<8, 4>  OutpostV2_Model;
+typedef KF<2, 1>    OutpostV2_OmegaModel;
+#endif
 
 
 struct OutpostV2_FuncA {
@@ -30,6 +46,15 @@ struct OutpostV2_FuncA {
         x1[6] = x0[6];
         x1[7] = x0[7];
     }
+    template<class M>
+    void jacobian(const double*, M& F) {
+        F = M::Identity();
+        F(0, 4) = dt;
+        F(1, 5) = dt;
+        F(2, 6) = dt;
+        F(3, 7) = dt;
+    }
+    static constexpr int sparsity[][2] = {{0, 4}, {1, 5}, {2, 6}, {3, 7}};
     double dt;
 };
 
@@ -41,6 +66,16 @@ struct OutpostV2_FuncH {
         y[2] = x[2];
         y[3] = x[3];
     }
+    template<class M>
+    void jacobian(const double x[8], M& H) {
+        H = M::Zero();
+        H(0, 0) = 1;
+        H(0, 3) = OUTPOST_R_V2 * sin(x[3]);
+        H(1, 1) = 1;
+        H(1, 3) = -OUTPOST_R_V2 * cos(x[3]);
+        H(2, 2) = 1;
+        H(3, 3) = 1;
+    }
 };
 
 struct OutpostV2_OmegaFuncA {
@@ -60,6 +95,13 @@ struct OutpostV2_OmegaFuncH {
     }
 };
 
+// Bullets fired in [start, end] hit an armor within the fire angle
+struct OutpostFireWindow {
+    TimePoint start;                        // Earliest fire time, not earlier than now
+    TimePoint end;                          // Latest fire time
+    TimePoint best;                         // Fire time at which the armor is hit exactly facing
+};
+
 
 class OutpostV2 {
 
@@ -70,11 +112,14 @@ public:
     void push(const Eigen::Matrix<double, 4, 1>& pose, TimePoint t);
     Eigen::Matrix<double, 4, 1> getPose(double append_delay);
     Eigen::Matrix<double, 4, 1> getCenter(double append_delay);
+    template<int N> Trajectory<N> getTrajectory(double t0, double dt);      // Poses at append delay t0 + i * dt from one state snapshot
 
     void setMatrixQ(double, double, double, double, double, double, double, double);
     void setMatrixR(double, double, double, double);
     void setMatrixOmegaQ(double, double);
     void setMatrixOmegaR(double);
+    void setRecord(bool record);                                            // Record measurements of push for rm::tuneCMAES
+    bool saveRecord(const std::string& file) { return writeTunerLog(file, record_); }
     void setFireValue(int update_num, double delay, double armor_angle, double center_angle) {
         fire_update_ = update_num;
         fire_delay_ = delay;
@@ -87,12 +132,20 @@ public:
     bool   getFireArmor(const Eigen::Matrix<double, 4, 1>& pose);
     bool   getFireCenter(const Eigen::Matrix<double, 4, 1>& pose);
 
+    // fly_delay 为开火指令发出到命中的时间, 包括串口、拨弹和弹丸飞行
+    bool   isPhaseLocked();
+    double getPhaseOmega();
+    bool   getFireWindows(std::vector<OutpostFireWindow>& windows, double fly_delay, int num = 3, bool aim_center = true);
+    bool   getFireTime(TimePoint& t, double fly_delay, bool aim_center = true);
+
+    // 装甲板切换的角度处理, push 与调参重放 OutpostV2_TunerAlign 共用
+    static double getSafeSub(const double, const double);                  // Safe subtraction
+    static double getAngleTrans(const double, const double);               // Convert angle in model to approach new angle
+    static int    getToggle(const double, const double, int toggle);       // Get toggle label
+    static bool   isAngleTrans(const double, const double);                // Determine if toggle occurs based on angle
+
 private:
-    double getSafeSub(const double, const double);                  // Safe subtraction
-    double getAngleTrans(const double, const double);               // Convert angle in model to approach new angle
     double getAngleMin(const double, const double, const double);   // Get minimum angle
-    int    getToggle(const double, const double);                   // Get toggle label
-    bool   isAngleTrans(const double, const double);                // Determine if toggle occurs based on angle
 
 
     int    fire_update_ = 100;
@@ -104,8 +157,8 @@ private:
     int toggle_ = 0;
     int update_num_ = 0;
 
-    EKF<8, 4>       model_;
-    KF<2, 1>        omega_model_;
+    OutpostV2_Model      model_;
+    OutpostV2_OmegaModel omega_model_;
 
     OutpostV2_FuncA funcA_;
     OutpostV2_FuncH funcH_;
@@ -115,8 +168,43 @@ private:
 
     TimePoint t_;
     SlideAvg<double> omega_;
+
+    bool      record_flag_ = false;         // Whether to record measurements
+    TimePoint record_t0_;                   // Time origin of recorded measurements
+    TunerLog  record_;                      // Recorded measurements
 };
 
+// 重放记录时复现 push 中的装甲板切换: 角度按 2pi/3 平移贴近观测，角速度固定为规则转速
+struct OutpostV2_TunerAlign {
+    template<class M>
+    bool operator()(const TunerSample& sample, double, M& X) {
+        double theta = sample.pose[3];
+        if (X[7] != 0.0) X[7] = (X[7] > 0) ? OUTPOST_OMEGA_V2 : -OUTPOST_OMEGA_V2;
+        if (OutpostV2::isAngleTrans(theta, X[3])) {
+            X[3] = theta;
+            return false;
+        }
+        X[3] = OutpostV2::getAngleTrans(theta, X[3]);
+        return true;
+    }
+};
+
+template<int N>
+Trajectory<N> OutpostV2::getTrajectory(double t0, double dt) {
+    Trajectory<N> trajectory(t0, dt);
+    double sys_delay = getDoubleOfS(t_, trajectory.base);
+    if (sys_delay > fire_delay_) return trajectory;
+
+    double omega = (omega_.getAvg() > 0) ? OUTPOST_OMEGA_V2 : -OUTPOST_OMEGA_V2;
+    double r[2] = {OUTPOST_R_V2, OUTPOST_R_V2};
+    double h[2] = {model_.estimate_X[2], model_.estimate_X[2]};
+    getSpinTrajectory<N>(
+        trajectory, trajectory.delay + sys_delay,
+        model_.estimate_X[0], model_.estimate_X[1], model_.estimate_X[4], model_.estimate_X[5], 0.0,
+        model_.estimate_X[3], omega, 3, r, h, 0);
+    return trajectory;
+}
+
 
 }
 
@@ -3,7 +3,11 @@
 #include <utils/timer.h>
 #include <kalman/filter/ekf.h>
 #include <kalman/filter/kf.h>
+#include <kalman/filter/ukf.h>
+#include <kalman/filter/iekf.h>
 #include <structure/slidestd.hpp>
+#include <solver/runefit.hpp>
+#include <structure/trajectory.hpp>
 #include <algorithm>
 
 // a in [0.780, 1.045]
@@ -38,6 +42,18 @@ constexpr double B_BASE = 2.090;
 constexpr double SMALL_RUNE_SPD = M_PI / 3;
 constexpr double R = 0.69852;
 
+// The big rune phase term sin(p) is poorly linearized, define OPENRM_UKF_KALMAN or OPENRM_IEKF_KALMAN to switch filter
+#if defined(OPENRM_UKF_KALMAN)
+typedef UKF<6, 5>  SmallRuneV2_Model;
+typedef UKF<8, 5>  BigRuneV2_Model;
+#elif defined(OPENRM_IEKF_KALMAN)
+typedef IEKF<6, 5> SmallRuneV2_Model;
+typedef IEKF<8, 5> BigRuneV2_Model;
+#else
+typedef EKF<6, 5>  SmallRuneV2_Model;
+typedef EKF<8, 5>  BigRuneV2_Model;
+#endif
+
 struct SmallRuneV2_FuncA {
     template<class T>
     void operator()(const T x0[6], T x1[6]) {
@@ -116,6 +132,7 @@ public:
 
     void push(const Eigen::Matrix<double, 5, 1>& pose, TimePoint t);
     Eigen::Matrix<double, 4, 1> getPose(double append_delay);
+    template<int N> Trajectory<N> getTrajectory(double t0, double dt);      // Poses at append delay t0 + i * dt from one state snapshot
 
     void getStateStr(std::vector<std::string>& str);
     bool getFireFlag(double append_delay);
@@ -126,6 +143,7 @@ public:
     void setSpdMatrixQ(double, double);
     void setSpdMatrixR(double);
     void setRuneType(bool is_big_rune) { is_big_rune_ = is_big_rune; }
+    void setFitInterval(int interval) { fit_interval_ = interval; }    // Frames between two sliding window fits, 0 to disable
     void setAutoFire(double big_spd, double fire_after, double fire_flag_keep, double fire_interval, double to_center) {
         big_rune_fire_spd_ = big_spd;
         fire_after_trans_delay_ = fire_after;
@@ -139,9 +157,12 @@ private:
     double getAngleTrans(const double, const double);               // Convert angle in model to approach new angle
     bool   getRuneTrans(const double, const double);                // Determine if rune page toggle occurred
     double getSafeSub(const double, const double);                  // Safe subtraction
+    void   fitBigRune();                                            // Warm start big rune model by sliding window fit
 
     int      toggle_ = 0;                                           // Toggle label
     int      update_num_ = 0;                                       // Update count
+    int      fit_interval_ = 10;                                    // Frames between two sliding window fits
+    int      fit_frames_ = -1;                                      // Frames until first valid fit, -1 before converged
     bool     is_big_rune_ = false;                                  // Whether it is big rune
     bool     is_rune_trans_ = false;                                // Whether rune toggled
     bool     is_fire_flag_  = false;                                // Whether currently firing
@@ -153,8 +174,8 @@ private:
     double   turn_to_center_delay_   = 1.0;                         // Model retention time
     
     
-    EKF<6, 5>          small_model_;                                // Motion model
-    EKF<8, 5>          big_model_;                                  // Motion model
+    SmallRuneV2_Model  small_model_;                                // Motion model
+    BigRuneV2_Model    big_model_;                                  // Motion model
     KF<2, 1>           spd_model_;                                  // Angular velocity model
 
     SmallRuneV2_FuncA  small_funcA_;                                // State transition function of motion model
@@ -164,10 +185,12 @@ private:
     SmallRuneV2_FuncH  small_funcH_;                                // Observation function of motion model
     BigRuneV2_FuncH    big_funcH_;                                  // Observation function of motion model
     RuneV2_SpdFuncH    spd_funcH_;                                  // Observation function of angular velocity model
+    RuneFit            fit_;                                        // Sliding window fit of big rune a / w / p
 
     TimePoint t_;                                                   // Last update time
     TimePoint t_trans_;                                             // Last rune toggle time
     TimePoint t_fire_;                                              // Last fire time
+    TimePoint t_start_;                                             // Time origin of fit window
 
     SlideAvg<double> center_x_;                                     // Rune center point x coordinate
     SlideAvg<double> center_y_;                                     // Rune center point y coordinate
@@ -176,6 +199,45 @@ private:
     SlideAvg<double> spd_;                                          // Rune speed
 };
 
+template<int N>
+Trajectory<N> RuneV2::getTrajectory(double t0, double dt) {
+    Trajectory<N> trajectory(t0, dt);
+    double sys_delay = getDoubleOfS(t_, trajectory.base);
+    if (sys_delay > 2.0 || update_num_ < 100) return trajectory;
+
+    double x_center = center_x_.getAvg();
+    double y_center = center_y_.getAvg();
+    double z_center = center_z_.getAvg();
+    double theta = theta_.getAvg();
+    double sign = (spd_.getAvg() > 0) ? 1.0 : -1.0;
+
+    // 超过保持时间后所有采样都瞄准符中心
+    if (sys_delay > turn_to_center_delay_) {
+        trajectory.pose.colwise() = Eigen::Matrix<double, 4, 1>(x_center, y_center, z_center, 0);
+        trajectory.valid = true;
+        return trajectory;
+    }
+
+    Eigen::Array<double, 1, N> t = trajectory.delay + sys_delay;
+    Eigen::Array<double, 1, N> angle;
+    if (is_big_rune_) {
+        double p = big_model_.estimate_X[5];
+        double a = std::clamp(big_model_.estimate_X[6], A_MIN, A_MAX);
+        double w = std::clamp(big_model_.estimate_X[7], W_MIN, W_MAX);
+        double b = B_BASE - a;
+        angle = big_model_.estimate_X[4] + sign * b * t + sign * a / w * (cos(p) - (p + w * t).cos());
+    } else {
+        angle = small_model_.estimate_X[4] + sign * SMALL_RUNE_SPD * t;
+    }
+
+    trajectory.pose.row(0) = (x_center + R * angle.cos() * sin(theta)).matrix();
+    trajectory.pose.row(1) = (y_center - R * angle.cos() * cos(theta)).matrix();
+    trajectory.pose.row(2) = (z_center + R * angle.sin()).matrix();
+    trajectory.pose.row(3) = angle.matrix();
+    trajectory.valid = true;
+    return trajectory;
+}
+
 
 };
 
@@ -5,6 +5,7 @@
 #include <utils/timer.h>
 #include <kalman/filter/kf.h>
 #include <structure/slidestd.hpp>
+#include <structure/slotmap.hpp>
 
 // [ x, y, z, theta, vx, vy]  [ x, y, z, theta]
 // [ 0, 1, 2,   3,   4,  5 ]  [ 0, 1, 2,   3  ]
@@ -36,34 +37,20 @@ class TQstateV1 {
 public:
     TimePoint last_t;                       // Last time of target
     Eigen::Matrix<double, 4, 1> last_pose;  // Last position of target
-    KF<6, 4> *model;                        // Target motion model
-    SlideStd<double> *v_std;                // Velocity standard deviation of target motion model
+    KF<6, 4> model;                         // Target motion model
+    SlideStd<double, 10> v_std;             // Velocity standard deviation of target motion model
     int count;                              // Update count of this target
-    bool exist;                             // Whether target exists
     bool available;                         // Target information available
 
     TQstateV1() :
         last_t(getTime()),
         count(0),
-        exist(false),
-        available(false) {
-        model = new KF<6, 4>();
-        v_std = new SlideStd<double>(10);
-    }
-
-    void clear() {
-        this->count = 0;
-        this->exist = false;
-        this->available = false;
-        this->model->restart();
-        this->v_std->clear();
-    }
+        available(false) {}
 
     void update(const Eigen::Matrix<double, 4, 1>& pose, TimePoint t) {
         this->last_t = t;
         this->last_pose = pose;
         this->count += 2;
-        this->exist = true;
         this->available = true;
     }
 };
@@ -96,7 +83,7 @@ public:
 
 private:
     double getAngleOffset(const Eigen::Matrix<double, 4, 1>& pose);                  // Angle between target direction and its connection line with vehicle
-    int getMinAngleOffset();                                                         // Get target index with minimum angle
+    SlotHandle getMinAngleOffset();                                                  // Get target handle with minimum angle
     double getDistance(const Eigen::Matrix<double, 4, 1>& this_pose, const Eigen::Matrix<double, 4, 1>& last_pose);       // Distance between two targets
     bool isDistanceValid(double d);                                                  // Determine if can be considered same target based on movement distance 
     bool isDelayValid(const TimePoint& this_t, const TimePoint& last_t);             // Determine if should be discarded based on update delay
@@ -112,7 +99,7 @@ private:
     double toggle_angle_offset_ = 0.17;     // Angle difference condition to trigger toggle
     double max_std_ = 0.1;                  // Maximum value of velocity standard deviation
 
-    int last_index_ = -1;                   // Output target index of last update
+    SlotHandle last_handle_;                // Output target handle of last update
     int last_toggle_ = 0;                   // Toggle label of last update
 
     TrackQueueV1_FuncA funcA_;              // State transition function of motion model
@@ -121,7 +108,7 @@ private:
     Eigen::Matrix<double, 4, 4> matrixR_;   // Observation noise covariance matrix of motion model
 
 public:
-    std::vector<TQstateV1> list_;            // Target state list
+    SlotMap<TQstateV1> list_{TRACK_POOL_CAPACITY}; // Target state pool
 };
 
 }
@@ -5,6 +5,7 @@
 #include <utils/timer.h>
 #include <kalman/filter/ekf.h>
 #include <structure/slidestd.hpp>
+#include <structure/slotmap.hpp>
 
 // [ x, y, z, theta, vx, vy, vz, omega, ax, ay, b  ]  [ x, y, z, theta ]
 // [ 0, 1, 2,   3,   4,  5,  6,    7,   8,  9,  10 ]  [ 0, 1, 2,   3   ]
@@ -42,44 +43,25 @@ class TQstateV2 {
 public:
     TimePoint last_t;                       // Last time of target
     Eigen::Matrix<double, 4, 1> last_pose;  // Last position of target
-    EKF<11, 4> *model;                      // Target motion model
-    SlideStd<double> *v_std;                // Velocity standard deviation of target motion model
-    SlideStd<double> *a_std;                // Acceleration standard deviation of target motion model
-    SlideStd<double> *w_std;                // Angular velocity standard deviation of target motion model
+    EKF<11, 4> model;                       // Target motion model
+    SlideStd<double, 5> v_std;              // Velocity standard deviation of target motion model
+    SlideStd<double, 5> a_std;              // Acceleration standard deviation of target motion model
+    SlideStd<double, 5> w_std;              // Angular velocity standard deviation of target motion model
     int count;                              // Update count of this target
     int keep;                               // Keep count of this target
-    bool exist;                             // Whether target exists
     bool available;                         // Target information available
 
     TQstateV2() :
         last_t(getTime()),
         count(0),
         keep(5),
-        exist(false),
-        available(false) {
-        model = new EKF<11, 4>();
-        v_std = new SlideStd<double>(5);
-        a_std = new SlideStd<double>(5);
-        w_std = new SlideStd<double>(5);
-    }
-
-    void clear() {
-        this->count = 0;
-        this->keep = 5;
-        this->exist = false;
-        this->available = false;
-        this->model->restart();
-        this->v_std->clear();
-        this->a_std->clear();
-        this->w_std->clear();
-    }
+        available(false) {}
 
     void update(const Eigen::Matrix<double, 4, 1>& pose, TimePoint t) {
         this->last_t = t;
         this->last_pose = pose;
         this->count += 1;
         this->keep = 5;
-        this->exist = true;
         this->available = true;
     }
 };
@@ -128,7 +110,7 @@ private:
         const Eigen::Matrix<double, 4, 1>& last_pose);                               // Distance between two targets
     double getAngleDiff(double angle0, double angle1);                               // Absolute value of difference between any two angles
     double getAngleOffset(const Eigen::Matrix<double, 4, 1>& pose);                  // Angle between target direction and vehicle connection line
-    int    getMinAngleOffset();                                                      // Get target index with minimum angle
+    SlotHandle getMinAngleOffset();                                                  // Get target handle with minimum angle
     
     
 private:
@@ -138,7 +120,7 @@ private:
     double angle_diff_   = 0.5;             // Maximum angle difference to be considered same plate
     double toggle_angle_ = 0.17;            // Angle difference condition to trigger toggle
 
-    int    last_index_   = -1;              // Output target index of last update
+    SlotHandle last_handle_;                // Output target handle of last update
     int    last_toggle_  = 0;               // Toggle label of last update
 
     double fire_std_v_   = 0.1;             // Fire velocity standard deviation
@@ -153,7 +135,7 @@ private:
     Eigen::Matrix<double, 4, 4> matrixR_;   // Observation noise covariance matrix of motion model
 
 public:
-    std::vector<TQstateV2> list_;          // Target state list
+    SlotMap<TQstateV2> list_{TRACK_POOL_CAPACITY}; // Target state pool
 };
 
 }
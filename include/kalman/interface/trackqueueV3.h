@@ -1,10 +1,14 @@
 #ifndef __OPENRM_KALMAN_INTERFACE_TRACK_QUEUE_V3_H__
 #define __OPENRM_KALMAN_INTERFACE_TRACK_QUEUE_V3_H__
 #include <memory>
+#include <mutex>
 #include <vector>
 #include <utils/timer.h>
 #include <kalman/filter/ekf.h>
 #include <structure/slidestd.hpp>
+#include <structure/slotmap.hpp>
+#include <structure/seqlock.hpp>
+#include <structure/trajectory.hpp>
 
 // [ x, y, z, theta, vx, vy, vz, omega, ax, ay, b  ]  [ x, y, z, theta ]
 // [ 0, 1, 2,   3,   4,  5,  6,    7,   8,  9,  10 ]  [ 0, 1, 2,   3   ]
@@ -42,14 +46,13 @@ class TQstateV3 {
 public:
     TimePoint last_t;                       // Last time of target
     Eigen::Matrix<double, 4, 1> last_pose;  // Last position of target
-    EKF<11, 4> *model;                      // Target motion model
+    EKF<11, 4> model;                       // Target motion model
     int count;                              // Update count of this target
     int keep;                               // Keep count of this target
     bool available;                         // Whether this target is available
 
     TQstateV3() : count(0), keep(5), available(false) {
         last_t = getTime();
-        model = new EKF<11, 4>();
     }
 
     void refresh(const Eigen::Matrix<double, 4, 1>& pose, TimePoint t) {
@@ -61,10 +64,19 @@ public:
     }
 };
 
+struct TQsnapshotV3 {
+    TimePoint last_t;                       // Last time of output target
+    double state[11];                       // Model state of output target
+    int count;                              // Update count of output target
+    bool valid;                             // Whether an output target is selected
+};
+
 class TrackQueueV3 {
 public:
     TrackQueueV3() {}
     TrackQueueV3(int count, double distance, double delay);
+    TrackQueueV3(const TrackQueueV3& other);                                         // Copy state, the copy gets its own mutex
+    TrackQueueV3& operator=(const TrackQueueV3& other);                              // Copy state, the mutex is not shared
     ~TrackQueueV3() {}
 
     void push(Eigen::Matrix<double, 4, 1>& pose, TimePoint t);                       // Push single target information
@@ -77,14 +89,16 @@ public:
     void setMatrixQ(double, double, double, double, double, double, double, double, double, double, double);
     void setMatrixR(double, double, double, double);
 
-    Eigen::Matrix<double, 4, 1> getPose(double append_delay);                        // Get pose predicted by model
+    Eigen::Matrix<double, 4, 1> getPose(double append_delay);                        // Get pose predicted by model, lock-free
     bool getPose(Eigen::Matrix<double, 4, 1>& pose, TimePoint& t);                    // Get
+    template<int N> Trajectory<N> getTrajectory(double t0, double dt);               // Poses at append delay t0 + i * dt from one snapshot, lock-free
     
     void getStateStr(std::vector<std::string>& str);                                 // Get target state information string
-    bool getFireFlag();                                                              // Determine if fire condition is met
+    bool getFireFlag();                                                              // Determine if fire condition is met, lock-free
 
 
 private:
+    void publish();                                                                  // Select output target and publish its snapshot
     double getDistance(
         const Eigen::Matrix<double, 4, 1>& this_pose,
         const Eigen::Matrix<double, 4, 1>& last_pose);                               // Distance between two targets
@@ -94,7 +108,7 @@ private:
     double distance_     = 0.15;            // Maximum movement distance to be considered same target
     double delay_        = 0.5;             // Maximum update delay to be considered same target
 
-    TQstateV3* last_state_   = nullptr;     // Last state
+    SlotHandle last_handle_;                // Handle of last state
 
     TrackQueueV3_FuncA funcA_;              // State transition function of motion model
     TrackQueueV3_FuncH funcH_;              // Observation function of motion model
@@ -102,10 +116,32 @@ private:
     Eigen::Matrix<double, 11, 11> matrixQ_; // Process noise covariance matrix of motion model
     Eigen::Matrix<double, 4, 4> matrixR_;   // Observation noise covariance matrix of motion model
 
+    mutable std::mutex mtx_;                // Guards list_ of this instance, never shared by copies
+    SeqLock<TQsnapshotV3> snapshot_;        // Output target published for lock-free readers
+
 public:
-    std::vector<TQstateV3*> list_;          // Target state list
+    SlotMap<TQstateV3> list_{TRACK_POOL_CAPACITY}; // Target state pool
 };
 
+template<int N>
+Trajectory<N> TrackQueueV3::getTrajectory(double t0, double dt) {
+    // 只读取一次快照，所有采样来自同一状态
+    Trajectory<N> trajectory(t0, dt);
+    TQsnapshotV3 snapshot = snapshot_.load();
+    if(!snapshot.valid) return trajectory;
+
+    double sys_delay = getDoubleOfS(snapshot.last_t, trajectory.base);
+    if(sys_delay >= delay_) return trajectory;
+
+    Eigen::Array<double, 1, N> t = trajectory.delay + sys_delay;
+    trajectory.pose.row(0) = (snapshot.state[0] + t * snapshot.state[4]).matrix();
+    trajectory.pose.row(1) = (snapshot.state[1] + t * snapshot.state[5]).matrix();
+    trajectory.pose.row(2).setConstant(snapshot.state[2]);
+    trajectory.pose.row(3) = (snapshot.state[3] + t * snapshot.state[7]).matrix();
+    trajectory.valid = true;
+    return trajectory;
+}
+
 }
 
 #endif
\ No newline at end of file
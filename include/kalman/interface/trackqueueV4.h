@@ -1,10 +1,19 @@
 #ifndef __OPENRM_KALMAN_INTERFACE_TRACK_QUEUE_V4_H__
 #define __OPENRM_KALMAN_INTERFACE_TRACK_QUEUE_V4_H__
+#include <map>
 #include <memory>
+#include <mutex>
 #include <vector>
 #include <utils/timer.h>
+#include <structure/trajectory.hpp>
 #include <kalman/filter/ekf.h>
+#include <kalman/filter/sekf.h>
+#include <kalman/filter/replay.h>
 #include <structure/slidestd.hpp>
+#include <structure/slotmap.hpp>
+#include <structure/seqlock.hpp>
+#include <solver/hungarian.hpp>
+#include <kalman/tuner.h>
 
 // [ x, y, z, v, vz, angle, w, a ]  [ x, y, z ]
 // [ 0, 1, 2, 3, 4,    5,   6, 7 ]  [ 0, 1, 2 ]
@@ -23,6 +32,22 @@ struct TrackQueueV4_FuncA {
         x1[6] = x0[6];
         x1[7] = x0[7];
     }
+    template<class M>
+    void jacobian(const double x0[8], M& F) {
+        double c = cos(x0[5]), s = sin(x0[5]);
+        double v = x0[3] + 0.5 * dt * x0[7];
+        F = M::Identity();
+        F(0, 3) = dt * c;
+        F(0, 5) = -dt * v * s;
+        F(0, 7) = 0.5 * dt * dt * c;
+        F(1, 3) = dt * s;
+        F(1, 5) = dt * v * c;
+        F(1, 7) = 0.5 * dt * dt * s;
+        F(2, 4) = dt;
+        F(3, 7) = dt;
+        F(5, 6) = dt;
+    }
+    static constexpr int sparsity[][2] = {{0, 3}, {0, 5}, {0, 7}, {1, 3}, {1, 5}, {1, 7}, {2, 4}, {3, 7}, {5, 6}};
     double dt;
 };
 
@@ -33,55 +58,82 @@ struct TrackQueueV4_FuncH {
         y[1] = x[1];
         y[2] = x[2];
     }
+    template<class M>
+    void jacobian(const double*, M& H) {
+        H = M::Zero();
+        H(0, 0) = 1;
+        H(1, 1) = 1;
+        H(2, 2) = 1;
+    }
 };
 
 class TQstateV4 {
 public:
     TimePoint last_t;                       // Last time of target
     Eigen::Matrix<double, 4, 1> last_pose;  // Last position of target
-    EKF<8, 3> *model;                      // Target motion model
+    ReplayFilter<SEKF<8, 3>> model;         // Target motion model, replays out-of-sequence measurements
+    int id;                                 // Unique id of this target
     int count;                              // Update count of this target
     int keep;                               // Keep count of this target
     bool available;                         // Whether this target is available
 
-    TQstateV4() : count(0), keep(5), available(false) {
+    TQstateV4(int id = -1) : id(id), count(0), keep(5), available(false) {
         last_t = getTime();
-        model = new EKF<8, 3>();
     }
 
     void refresh(const Eigen::Matrix<double, 4, 1>& pose, TimePoint t) {
-        this->last_t = t;
-        this->last_pose = pose;
+        // 乱序到达的旧测量不回退最新时间
+        if (this->count == 0 || getDoubleOfS(this->last_t, t) >= 0) {
+            this->last_t = t;
+            this->last_pose = pose;
+        }
         this->count += 1;
         this->keep = 5;
         this->available = true;
     }
 };
 
+struct TQsnapshotV4 {
+    TimePoint last_t;                       // Last time of output target
+    double state[8];                        // Model state of output target
+    double cov[36];                         // Covariance of x, y, z, v, vz, angle, row-major
+    int count;                              // Update count of output target
+    bool valid;                             // Whether an output target is selected
+};
+
 class TrackQueueV4 {
 public:
     TrackQueueV4() {}
     TrackQueueV4(int count, double distance, double delay);
+    TrackQueueV4(const TrackQueueV4& other);                                         // Copy state, the copy gets its own mutex
+    TrackQueueV4& operator=(const TrackQueueV4& other);                              // Copy state, the mutex is not shared
     ~TrackQueueV4() {}
 
     void push(Eigen::Matrix<double, 4, 1>& pose, TimePoint t);                       // Push single target information
+    void push(std::vector<Eigen::Matrix<double, 4, 1>>& poses, TimePoint t);         // Push all targets of one frame with global association
     void update();                                                                   // Update once per frame
 
 public:
     void setCount(int c) { this->count_ = c; }                                       // Set minimum update count for model availability
     void setDistance(double d) { this->distance_ = d; }                              // Set maximum movement distance to be considered same target
     void setDelay(double d) { this->delay_ = d; }                                    // Set maximum delay without model reset
+    void setGate(double g) { this->gate_ = g; }                                      // Set Mahalanobis gate (squared, chi-square with 3 dof)
     void setMatrixQ(double, double, double, double, double, double, double, double);
     void setMatrixR(double, double, double);
+    void setRecord(bool record);                                                     // Record measurements of each target for rm::tuneCMAES
+    bool saveRecord(const std::string& prefix);                                      // Save one log per target as <prefix>_<id>.txt
 
-    Eigen::Matrix<double, 4, 1> getPose(double append_delay);                        // Get pose predicted by model
+    Eigen::Matrix<double, 4, 1> getPose(double append_delay);                        // Get pose predicted by model, lock-free
     bool getPose(Eigen::Matrix<double, 4, 1>& pose, TimePoint& t);                    // Get
+    Eigen::Matrix<double, 3, 3> getPoseCov(double append_delay);                     // Position covariance of getPose, infinite without target, lock-free
+    template<int N> Trajectory<N> getTrajectory(double t0, double dt);               // Poses at append delay t0 + i * dt from one snapshot, lock-free
     
     void getStateStr(std::vector<std::string>& str);                                 // Get target state information string
-    bool getFireFlag();                                                              // Determine if fire condition is met
+    bool getFireFlag();                                                              // Determine if fire condition is met, lock-free
 
 
 private:
+    void publish();                                                                  // Select output target and publish its snapshot
     double getDistance(
         const Eigen::Matrix<double, 4, 1>& this_pose,
         const Eigen::Matrix<double, 4, 1>& last_pose);                               // Distance between two targets
@@ -93,8 +145,13 @@ private:
     int    count_        = 10;              // Minimum update count to maintain stable state
     double distance_     = 0.15;            // Maximum movement distance to be considered same target
     double delay_        = 0.5;             // Maximum update delay to be considered same target
+    double gate_         = 11.34;           // Squared Mahalanobis gate, 99% of chi-square with 3 dof
+
+    SlotHandle last_handle_;                // Handle of last state
+    int    next_id_      = 0;               // Id of next new target
 
-    TQstateV4* last_state_   = nullptr;     // Last state
+    std::vector<double> cost_;              // Association cost matrix, tracks x measurements
+    std::vector<int>    assign_;            // Measurement assigned to each track
 
     TrackQueueV4_FuncA funcA_;              // State transition function of motion model
     TrackQueueV4_FuncH funcH_;              // Observation function of motion model
@@ -102,10 +159,36 @@ private:
     Eigen::Matrix<double, 8, 8> matrixQ_; // Process noise covariance matrix of motion model
     Eigen::Matrix<double, 3, 3> matrixR_;   // Observation noise covariance matrix of motion model
 
+    mutable std::mutex mtx_;                // Guards list_ of this instance, never shared by copies
+    SeqLock<TQsnapshotV4> snapshot_;        // Output target published for lock-free readers
+
+    bool      record_flag_ = false;         // Whether to record measurements
+    TimePoint record_t0_;                   // Time origin of recorded measurements
+    std::map<int, TunerLog> record_;        // Recorded measurements of each target id
+
 public:
-    std::vector<TQstateV4*> list_;          // Target state list
+    SlotMap<TQstateV4> list_{TRACK_POOL_CAPACITY}; // Target state pool
 };
 
+template<int N>
+Trajectory<N> TrackQueueV4::getTrajectory(double t0, double dt) {
+    // 只读取一次快照，所有采样来自同一状态
+    Trajectory<N> trajectory(t0, dt);
+    TQsnapshotV4 snapshot = snapshot_.load();
+    if(!snapshot.valid) return trajectory;
+
+    double sys_delay = getDoubleOfS(snapshot.last_t, trajectory.base);
+    if(sys_delay >= delay_) return trajectory;
+
+    Eigen::Array<double, 1, N> t = trajectory.delay + sys_delay;
+    trajectory.pose.row(0) = (snapshot.state[0] + t * snapshot.state[3] * cos(snapshot.state[5])).matrix();
+    trajectory.pose.row(1) = (snapshot.state[1] + t * snapshot.state[3] * sin(snapshot.state[5])).matrix();
+    trajectory.pose.row(2) = (snapshot.state[2] + t * snapshot.state[4]).matrix();
+    trajectory.pose.row(3).setZero();
+    trajectory.valid = true;
+    return trajectory;
+}
+
 }
 
 #endif
\ No newline at end of file
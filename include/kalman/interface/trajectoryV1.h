@@ -1,6 +1,7 @@
 #ifndef __OPENRM_KALMAN_INTERFACE_TRAJECTORY_V1_H__
 #define __OPENRM_KALMAN_INTERFACE_TRAJECTORY_V1_H__
 #include <utils/timer.h>
+#include <structure/trajectory.hpp>
 #include <kalman/filter/ekf.h>
 #include <algorithm>
 
@@ -43,6 +44,7 @@ public:
 
     void push(Eigen::Matrix<double, 4, 1>& pose, TimePoint t);
     Eigen::Matrix<double, 4, 1> getPose(double append_delay);
+    template<int N> Trajectory<N> getTrajectory(double t0, double dt);      // Poses at append delay t0 + i * dt from one state snapshot
     double getDistance(double append_delay, double x, double y);
 
     void setMatrixQ(double, double, double, double, double, double, double, double, double);
@@ -61,6 +63,21 @@ private:
     TimePoint t_;
 };
 
+template<int N>
+Trajectory<N> TrajectoryV1::getTrajectory(double t0, double dt) {
+    Trajectory<N> trajectory(t0, dt);
+    double sys_delay = getDoubleOfS(t_, trajectory.base);
+    if (sys_delay > keep_delay_) return trajectory;
+
+    Eigen::Array<double, 1, N> t = trajectory.delay + sys_delay;
+    trajectory.pose.row(0) = (model_.estimate_X[0] + model_.estimate_X[3] * t).matrix();
+    trajectory.pose.row(1) = (model_.estimate_X[1] + model_.estimate_X[4] * t).matrix();
+    trajectory.pose.row(2) = (model_.estimate_X[2] + model_.estimate_X[5] * t).matrix();
+    trajectory.pose.row(3).setOnes();
+    trajectory.valid = true;
+    return trajectory;
+}
+
 }
 
 #endif
\ No newline at end of file
@@ -3,6 +3,12 @@
 
 #include <kalman/filter/ekf.h>
 #include <kalman/filter/kf.h>
+#include <kalman/filter/sekf.h>
+#include <kalman/filter/srkf.h>
+#include <kalman/filter/srekf.h>
+#include <kalman/filter/ukf.h>
+#include <kalman/filter/iekf.h>
+#include <kalman/filter/replay.h>
 
 #include <kalman/model/ekf_center_model.h>
 #include <kalman/model/ekf_single_model.h>
@@ -11,6 +17,7 @@
 // #include <kalman/interface/antitopV1.h>
 // #include <kalman/interface/antitopV2.h>
 #include <kalman/interface/antitopV3.h>
+#include <kalman/interface/antitopV4.h>
 
 // #include <kalman/interface/trackqueueV1.h>
 // #include <kalman/interface/trackqueueV2.h>
@@ -22,5 +29,8 @@
 #include <kalman/interface/outpostV1.h>
 #include <kalman/interface/outpostV2.h>
 #include <kalman/interface/trajectoryV1.h>
+#include <kalman/interface/immV1.h>
+
+#include <kalman/tuner.h>
 
 #endif
\ No newline at end of file
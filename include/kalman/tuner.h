@@ -0,0 +1,152 @@
+#ifndef __OPENRM_KALMAN_TUNER_H__
+#define __OPENRM_KALMAN_TUNER_H__
+
+#include <cmath>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <functional>
+#include <Eigen/Dense>
+
+namespace rm {
+
+struct TunerSample {
+    double t;                               // Time of measurement, s
+    Eigen::Matrix<double, 4, 1> pose;       // Measured pose [x, y, z, theta]
+};
+
+typedef std::vector<TunerSample> TunerLog; // Measurements of one target, sorted by time
+
+enum TunerCost {
+    TUNER_COST_MSE,                         // Position error of prediction at append_delay
+    TUNER_COST_NIS                          // Distance of mean NIS from its expectation dimY
+};
+
+struct TunerConfig {
+    int      max_iter   = 100;              // Generations of CMA-ES
+    int      population = 0;                // Samples per generation, 0 for 4 + 3 ln(n)
+    double   sigma      = 1.0;              // Initial step size, in log10 of Q / R
+    double   lower      = -8.0;             // Lower bound of parameters, log10
+    double   upper      = 2.0;              // Upper bound of parameters, log10
+    int      threads    = 0;                // Worker threads, 0 for all cores
+    unsigned seed       = 0;                // Random seed
+};
+
+struct TunerResult {
+    std::vector<double> params;             // Best parameters, log10 of Q / R diagonals
+    double cost        = 0.0;               // Summed cost of best parameters over all logs
+    int    evaluations = 0;                 // Parameter sets evaluated
+};
+
+// params 为 Q、R 对角线的 log10 值，返回在一条记录上的代价
+typedef std::function<double(const std::vector<double>& params, const TunerLog& log)> TunerObjective;
+
+// 每行一个测量: t x y z theta
+bool writeTunerLog(const std::string& file, const TunerLog& log);
+bool readTunerLog(const std::string& file, TunerLog& log);
+
+// CMA-ES 在所有记录上最小化代价之和，每代的样本分配到多个线程并行评估
+TunerResult tuneCMAES(
+    const TunerObjective& objective,
+    const std::vector<TunerLog>& logs,
+    const std::vector<double>& init,
+    const TunerConfig& config = TunerConfig());
+
+// 生成可直接粘贴的 setMatrixQ / setMatrixR 调用
+std::string getTunerParamStr(const std::vector<double>& params, int dimX);
+
+
+// 以接口的运动模型重放记录, Filter 为 EKF / SEKF / IEKF 等带 jacobi_H 的滤波器
+// 记录为接口 push 收到的原始测量 (见各接口的 setRecord)
+// init(sample, X) 由第一帧测量初始化状态, 默认将测量写入状态前 dimY 维
+// align(sample, dt, X) 在预测前按接口的装甲板切换逻辑平移角度、切换半径与高度,
+// 返回 false 时与接口一样跳过该帧; 计算预测代价时也用它把预测对齐到真值所在的装甲板
+// 前 warmup 帧只更新不计入代价; 参数发散时返回大代价以便搜索跳过
+template<class Filter, class FuncA, class FuncH, class Init = std::nullptr_t, class Align = std::nullptr_t>
+double replayFilterCost(
+    const std::vector<double>& params,
+    const TunerLog& log,
+    double append_delay,
+    TunerCost cost = TUNER_COST_MSE,
+    Init init = nullptr,
+    Align align = nullptr,
+    int warmup = 10
+) {
+    constexpr int dimX = Filter::VecX::RowsAtCompileTime;
+    constexpr int dimY = Filter::VecY::RowsAtCompileTime;
+    static_assert(dimY <= 4, "Measurement of tuner log has 4 dims");
+    constexpr double diverge = 1e10;
+
+    Filter filter;
+    FuncA funcA;
+    FuncH funcH;
+    filter.Q.setZero();
+    filter.R.setZero();
+    for (int i = 0; i < dimX; i++) filter.Q(i, i) = std::pow(10.0, params[i]);
+    for (int i = 0; i < dimY; i++) filter.R(i, i) = std::pow(10.0, params[dimX + i]);
+
+    double sum = 0.0;
+    int count = 0;
+    size_t future = 0;
+
+    for (size_t k = 0; k < log.size(); k++) {
+        typename Filter::VecY Y = log[k].pose.template head<dimY>();
+
+        if (k == 0) {
+            filter.estimate_X.setZero();
+            if constexpr (std::is_same_v<Init, std::nullptr_t>) filter.estimate_X.template head<dimY>() = Y;
+            else init(log[k], filter.estimate_X);
+        }
+        funcA.dt = (k == 0) ? 0.0 : log[k].t - log[k - 1].t;
+        if constexpr (!std::is_same_v<Align, std::nullptr_t>) {
+            if (!align(log[k], funcA.dt, filter.estimate_X)) continue;
+        }
+        filter.predict(funcA);
+        typename Filter::MatXX P = filter.P;
+        filter.update(funcH, Y);
+
+        if (!filter.estimate_X.allFinite()) return diverge;
+        if ((int)k < warmup) continue;
+
+        if (cost == TUNER_COST_NIS) {
+            typename Filter::VecY e = Y - filter.predict_Y;
+            if constexpr (dimY == 4) e[3] = std::remainder(e[3], 2 * M_PI);   // pose[3] 为角度
+            typename Filter::MatYY S = filter.jacobi_H * P * filter.jacobi_H.transpose() + filter.R;
+            sum += e.dot(S.ldlt().solve(e));
+            count++;
+        } else {
+            // 取 append_delay 之后的第一帧测量作为真值
+            double target_t = log[k].t + append_delay;
+            if (future <= k) future = k + 1;
+            while (future < log.size() && log[future].t < target_t) future++;
+            if (future >= log.size()) break;
+
+            FuncA predict_funcA = funcA;
+            predict_funcA.dt = log[future].t - log[k].t;
+            typename Filter::VecX X;
+            typename Filter::VecY predict_Y;
+            predict_funcA(filter.estimate_X.data(), X.data());
+            if constexpr (!std::is_same_v<Align, std::nullptr_t>) {
+                Align peek = align;
+                peek(log[future], 0.0, X);
+            }
+            funcH(X.data(), predict_Y.data());
+
+            constexpr int dimP = std::min(dimY, 3);
+            sum += (predict_Y.template head<dimP>() - log[future].pose.template head<dimP>()).squaredNorm();
+            count++;
+        }
+    }
+
+    if (count == 0) return diverge;
+    double mean = sum / count;
+    if (!std::isfinite(mean)) return diverge;
+    if (cost == TUNER_COST_NIS) return std::pow(std::log(mean / dimY), 2);
+    return mean;
+}
+
+}
+
+#endif
@@ -7,18 +7,29 @@
 #include <attack/deadlocker.h>
 #include <attack/freshcenter.h>
 #include <attack/filtrate.h>
+#include <attack/scorer.h>
+
+#include <infer/cache.h>
+#include <infer/calib.h>
+#include <infer/evaluate.h>
 
 #include <kalman/kalman.h>
 
 #include <pointer/pointer.h>
 
 #include <solver/solvepnp.h>
+#include <solver/solvevehicle.h>
 #include <solver/ternary.hpp>
+#include <solver/hungarian.hpp>
+#include <solver/hitprob.hpp>
 
 #include <structure/cyclequeue.hpp>
 #include <structure/slidestd.hpp>
 #include <structure/swapbuffer.hpp>
 #include <structure/speedqueue.hpp>
+#include <structure/slotmap.hpp>
+#include <structure/seqlock.hpp>
+#include <structure/trajectory.hpp>
 
 #include <structure/enums.hpp>
 #include <structure/stamp.hpp>
@@ -35,6 +46,7 @@
 
 #include <utils/timer.h>
 #include <utils/delay.h>
+#include <utils/latency.h>
 #include <utils/tf.h>
 #include <utils/serial.h>
 #include <utils/print.h>
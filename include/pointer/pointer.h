@@ -107,6 +107,12 @@ void findCircleCenterFromContours(
     const std::vector<std::vector<cv::Point>>& contours,
     std::vector<cv::Point2f>& circles,
     double area_threshold, double circularity_threshold);                               // 从轮廓中获取圆心
+bool findRune(const cv::Mat& src, Rune& rune, ArmorColor color,
+              double threshold = 0.4,
+              double min_target_area = 50.0,
+              double min_circularity = 0.7,
+              double max_ratio_error = 0.35,
+              double ratio_radius = 4.66);                                              // 识别R标与待激活扇叶，rune上一帧有效时只在其roi内搜索
 
 
 void setLightbarRotatedRect(Lightbar& lightbar);                                        // 设置灯条最小外接旋转矩形
@@ -0,0 +1,82 @@
+#ifndef __OPENRM_SOLVER_BRENT_H__
+#define __OPENRM_SOLVER_BRENT_H__
+#include <cmath>
+#include <utility>
+
+namespace rm {
+
+// Brent 一维极小值搜索: 抛物线插值 + 黄金分割兜底
+// seed 为区间内的初始猜测, 初值越准收敛越快, 不分配任何堆内存
+template<typename T>
+double brentSearch(double left, double right, double seed, const T& func, double epsilon, int max_iter = 30, int* iter_count = nullptr) {
+    constexpr double golden = 0.3819660112501051;
+    constexpr double tiny = 1e-10;
+
+    if (left > right) std::swap(left, right);
+    if (!(seed > left && seed < right)) seed = left + golden * (right - left);
+
+    double x = seed, w = seed, v = seed;
+    double fx = func(x), fw = fx, fv = fx;
+    double d = 0.0, e = 0.0;
+    int iter = 0;
+
+    for (; iter < max_iter; iter++) {
+        double mid = 0.5 * (left + right);
+        double tol1 = epsilon * 0.5 + tiny * std::fabs(x);
+        double tol2 = 2.0 * tol1;
+
+        // 区间已收缩到精度内
+        if (std::fabs(x - mid) <= tol2 - 0.5 * (right - left)) break;
+
+        bool golden_step = true;
+        if (std::fabs(e) > tol1) {
+            // 过 x, w, v 三点做抛物线
+            double r = (x - w) * (fx - fv);
+            double q = (x - v) * (fx - fw);
+            double p = (x - v) * q - (x - w) * r;
+            q = 2.0 * (q - r);
+            if (q > 0.0) p = -p;
+            q = std::fabs(q);
+            double e_last = e;
+            e = d;
+
+            // 抛物线步长需落在区间内且小于上上步的一半
+            if (std::fabs(p) < std::fabs(0.5 * q * e_last) && p > q * (left - x) && p < q * (right - x)) {
+                d = p / q;
+                double u = x + d;
+                if (u - left < tol2 || right - u < tol2) {
+                    d = (mid - x >= 0.0) ? tol1 : -tol1;
+                }
+                golden_step = false;
+            }
+        }
+        if (golden_step) {
+            e = (x >= mid) ? left - x : right - x;
+            d = golden * e;
+        }
+
+        double u = (std::fabs(d) >= tol1) ? x + d : x + ((d >= 0.0) ? tol1 : -tol1);
+        double fu = func(u);
+
+        if (fu <= fx) {
+            if (u >= x) left = x; else right = x;
+            v = w; fv = fw;
+            w = x; fw = fx;
+            x = u; fx = fu;
+        } else {
+            if (u < x) left = u; else right = u;
+            if (fu <= fw || w == x) {
+                v = w; fv = fw;
+                w = u; fw = fu;
+            } else if (fu <= fv || v == x || v == w) {
+                v = u; fv = fu;
+            }
+        }
+    }
+
+    if (iter_count != nullptr) *iter_count = iter;
+    return x;
+}
+
+}
+#endif
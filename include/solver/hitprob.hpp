@@ -0,0 +1,71 @@
+#ifndef __OPENRM_SOLVER_HITPROB_HPP__
+#define __OPENRM_SOLVER_HITPROB_HPP__
+#include <cmath>
+#include <algorithm>
+#include <Eigen/Dense>
+#include <structure/enums.hpp>
+
+namespace rm {
+
+// Striking zone of armor plates, m
+constexpr double ARMOR_HIT_WIDTH_SMALL = 0.135;
+constexpr double ARMOR_HIT_WIDTH_BIG = 0.230;
+constexpr double ARMOR_HIT_HEIGHT = 0.125;
+constexpr double ARMOR_HIT_PITCH = 15.0 / 180.0 * M_PI;   // Armor plates lean back by 15 degrees
+
+// Bullet dispersion at the target, independent of tracker uncertainty
+struct HitDispersion {
+    double base = 0.01;                     // Constant spread, m
+    double angle = 0.004;                   // Angular spread of barrel, rad
+    double speed = 0.3;                     // Standard deviation of muzzle speed, m/s
+};
+
+// 命中概率: 目标位置协方差和弹丸散布投影到垂直于视线的平面, 在装甲板有效矩形上积分
+// target 为装甲板中心相对枪口的位置, cov 为其协方差 (各预测器的 getPoseCov),
+// 预测器无目标时协方差为无穷大, 此时命中概率为 0
+// armor_yaw 与 getPose 的 theta 一致, offset 为瞄准点相对装甲板中心的偏差
+// 平面内两轴的相关项忽略, 矩形积分化为两个一维正态分布函数之积
+inline double getHitProbability(
+    const Eigen::Matrix<double, 3, 1>& target,
+    const Eigen::Matrix<double, 3, 3>& cov,
+    const double armor_yaw,
+    const ArmorSize size,
+    const double speed,
+    const HitDispersion& dispersion = HitDispersion(),
+    const Eigen::Matrix<double, 3, 1>& offset = Eigen::Matrix<double, 3, 1>::Zero()
+) {
+    double range = target.norm();
+    double distance = std::hypot(target[0], target[1]);
+    if ((range < 1e-6) || (speed <= 0.0) || !cov.allFinite()) return 0.0;
+
+    // 视线垂直平面的水平轴 u 与竖直轴 w
+    double yaw = std::atan2(target[1], target[0]);
+    double pitch = std::atan2(target[2], distance);
+    Eigen::Matrix<double, 2, 3> B;
+    B << -std::sin(yaw), std::cos(yaw), 0.0,
+         -std::sin(pitch) * std::cos(yaw), -std::sin(pitch) * std::sin(yaw), std::cos(pitch);
+
+    Eigen::Matrix<double, 2, 2> S = B * cov * B.transpose();
+    Eigen::Matrix<double, 2, 1> m = B * offset;
+
+    // 角度散布随距离放大, 初速波动主要影响下坠 g * d^2 / (2 v^2)
+    double spread = dispersion.base * dispersion.base + std::pow(dispersion.angle * range, 2);
+    double drop = 9.8 * distance * distance * dispersion.speed / (speed * speed * speed);
+    S(0, 0) += spread;
+    S(1, 1) += spread + drop * drop;
+
+    // 装甲板斜对视线时有效宽度按夹角缩小, 高度按后仰角与俯视角缩小
+    double width = (size == ARMOR_SIZE_BIG_ARMOR) ? ARMOR_HIT_WIDTH_BIG : ARMOR_HIT_WIDTH_SMALL;
+    double half_u = 0.5 * width * std::fabs(std::cos(yaw - armor_yaw));
+    double half_w = 0.5 * ARMOR_HIT_HEIGHT * std::fabs(std::cos(ARMOR_HIT_PITCH + pitch));
+
+    auto interval = [](double half, double mean, double var) {
+        double k = 1.0 / std::sqrt(2.0 * std::max(var, 1e-12));
+        return 0.5 * (std::erf((half - mean) * k) - std::erf((-half - mean) * k));
+    };
+    return interval(half_u, m[0], S(0, 0)) * interval(half_w, m[1], S(1, 1));
+}
+
+}
+
+#endif
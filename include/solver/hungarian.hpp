@@ -0,0 +1,90 @@
+#ifndef __OPENRM_SOLVER_HUNGARIAN_H__
+#define __OPENRM_SOLVER_HUNGARIAN_H__
+#include <vector>
+#include <limits>
+#include <algorithm>
+
+namespace rm {
+
+// 匈牙利算法 (Kuhn-Munkres), 复杂度 O(min^2 * max)
+// cost 为 rows x cols 的行主序代价矩阵, assign[i] 为第 i 行匹配的列, 未匹配为 -1
+// 代价不小于 gate 的配对视为未匹配, 先将代价截断到 gate 再求解, 结果即为带门限的最优匹配
+// 返回已匹配配对的总代价
+inline double hungarianSolve(
+    const std::vector<double>& cost, int rows, int cols,
+    std::vector<int>& assign,
+    double gate = std::numeric_limits<double>::infinity()
+) {
+    assign.assign(rows, -1);
+    if (rows == 0 || cols == 0) return 0.0;
+
+    // 算法要求行数不大于列数, 否则按转置求解
+    const bool transpose = rows > cols;
+    const int n = transpose ? cols : rows;
+    const int m = transpose ? rows : cols;
+    auto at = [&](int i, int j) {
+        double c = transpose ? cost[j * cols + i] : cost[i * cols + j];
+        return std::min(c, gate);
+    };
+
+    const double inf = std::numeric_limits<double>::infinity();
+    std::vector<double> u(n + 1, 0.0), v(m + 1, 0.0), minv(m + 1);
+    std::vector<int> p(m + 1, 0), way(m + 1, 0);
+    std::vector<char> used(m + 1);
+
+    for (int i = 1; i <= n; i++) {
+        p[0] = i;
+        int j0 = 0;
+        std::fill(minv.begin(), minv.end(), inf);
+        std::fill(used.begin(), used.end(), 0);
+
+        // 沿增广路扩展, 同时更新势能 u, v
+        do {
+            used[j0] = 1;
+            int i0 = p[j0], j1 = 0;
+            double delta = inf;
+            for (int j = 1; j <= m; j++) {
+                if (used[j]) continue;
+                double cur = at(i0 - 1, j - 1) - u[i0] - v[j];
+                if (cur < minv[j]) {
+                    minv[j] = cur;
+                    way[j] = j0;
+                }
+                if (minv[j] < delta) {
+                    delta = minv[j];
+                    j1 = j;
+                }
+            }
+            for (int j = 0; j <= m; j++) {
+                if (used[j]) {
+                    u[p[j]] += delta;
+                    v[j] -= delta;
+                } else {
+                    minv[j] -= delta;
+                }
+            }
+            j0 = j1;
+        } while (p[j0] != 0);
+
+        do {
+            int j1 = way[j0];
+            p[j0] = p[j1];
+            j0 = j1;
+        } while (j0 != 0);
+    }
+
+    double total = 0.0;
+    for (int j = 1; j <= m; j++) {
+        if (p[j] == 0) continue;
+        int r = transpose ? j - 1 : p[j] - 1;
+        int c = transpose ? p[j] - 1 : j - 1;
+        double value = cost[r * cols + c];
+        if (value >= gate) continue;
+        assign[r] = c;
+        total += value;
+    }
+    return total;
+}
+
+}
+#endif
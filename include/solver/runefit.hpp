@@ -0,0 +1,197 @@
+#ifndef __OPENRM_SOLVER_RUNEFIT_HPP__
+#define __OPENRM_SOLVER_RUNEFIT_HPP__
+#include <cmath>
+#include <deque>
+#include <algorithm>
+#include <Eigen/Dense>
+
+// spd   = a * sin(w * t + p) + base - a
+// angle = c + sign * ((base - a) * t - a / w * cos(w * t + p))
+
+namespace rm {
+
+struct RuneFitResult {
+    double a = 0.0;                         // Amplitude of speed
+    double w = 0.0;                         // Angular frequency of speed
+    double p = 0.0;                         // Phase at the last sample, as state p of big rune model
+    double rms = 0.0;                       // RMS angle residual, rad
+    bool   valid = false;                   // Whether the fit is usable
+};
+
+// 大符速度参数滑动窗口拟合
+// 对固定的 (w, p) 模型对 (c, a) 线性, 先在 (w, p) 网格上做线性最小二乘选出若干初值,
+// 再对 (c, a, w, p) 做 LM 迭代, 取残差最小的结果
+class RuneFit {
+
+public:
+    RuneFit() : RuneFit(300) {}
+    RuneFit(int size) : size_((size_t)size) {}
+    ~RuneFit() {}
+
+    void setBound(double a_min, double a_max, double w_min, double w_max, double base) {
+        a_min_ = a_min; a_max_ = a_max;
+        w_min_ = w_min; w_max_ = w_max;
+        base_ = base;
+    }
+    void setStep(double step) { step_ = step; }         // Angle between two leaves, samples are unwrapped by it
+    void setMinSpan(double span) { min_span_ = span; }  // Minimal time span of window to fit
+    void setMaxRms(double rms) { max_rms_ = rms; }      // Maximal RMS residual of a valid fit
+
+    // 切换符叶后角度跳变整数个 step, 按上一个样本展开保持连续
+    void push(double t, double angle) {
+        if (!t_.empty()) {
+            double last = angle_.back();
+            angle += step_ * std::round((last - angle) / step_);
+        }
+        t_.push_back(t);
+        angle_.push_back(angle);
+        while (t_.size() > size_) {
+            t_.pop_front();
+            angle_.pop_front();
+        }
+    }
+
+    void clear() {
+        t_.clear();
+        angle_.clear();
+    }
+
+    size_t getSize() const { return t_.size(); }
+    double getSpan() const { return t_.empty() ? 0.0 : t_.back() - t_.front(); }
+
+    bool fit(double sign, RuneFitResult& result) const {
+        result.valid = false;
+        if ((t_.size() < 10) || (getSpan() < min_span_)) return false;
+
+        const int n = (int)t_.size();
+        Eigen::ArrayXd T(n), Y(n);
+        for (int i = 0; i < n; i++) {
+            T[i] = t_[i] - t_.front();
+            Y[i] = sign * angle_[i];                    // 统一为正向旋转
+        }
+        Eigen::ArrayXd Z = Y - base_ * T;               // Z = c - a * (t + cos(w t + p) / w)
+
+        // 网格粗搜, 保留残差最小的几个初值
+        constexpr int W_NUM = 3, P_NUM = 12, START_NUM = 2;
+        Eigen::Vector4d starts[START_NUM];
+        double start_cost[START_NUM];
+        std::fill(start_cost, start_cost + START_NUM, INFINITY);
+
+        for (int i = 0; i < W_NUM; i++) {
+            double w = w_min_ + (w_max_ - w_min_) * i / (W_NUM - 1);
+            // cos(w t + p) = cos(w t) cos(p) - sin(w t) sin(p), 每个 w 只计算一次三角函数
+            Eigen::ArrayXd C = (w * T).cos(), S = (w * T).sin();
+            for (int j = 0; j < P_NUM; j++) {
+                double p = 2 * M_PI * j / P_NUM;
+                Eigen::ArrayXd G = -(T + (C * cos(p) - S * sin(p)) / w);
+
+                // [n, sum G; sum G, sum G^2] [c; a] = [sum Z; sum G Z]
+                double sg = G.sum(), sgg = G.square().sum();
+                double sz = Z.sum(), sgz = (G * Z).sum();
+                double det = n * sgg - sg * sg;
+                if (fabs(det) < 1e-12) continue;
+                double a = std::clamp((n * sgz - sg * sz) / det, a_min_, a_max_);
+                double c = (sz - a * sg) / n;
+                double cost = (Z - c - a * G).square().sum();
+
+                int worst = std::max_element(start_cost, start_cost + START_NUM) - start_cost;
+                if (cost < start_cost[worst]) {
+                    start_cost[worst] = cost;
+                    starts[worst] << c, a, w, p;
+                }
+            }
+        }
+
+        Eigen::Vector4d best;
+        double best_cost = INFINITY;
+        for (int k = 0; k < START_NUM; k++) {
+            if (!std::isfinite(start_cost[k])) continue;
+            Eigen::Vector4d x = starts[k];
+            double cost = refine(T, Z, x);
+            if (cost < best_cost) {
+                best_cost = cost;
+                best = x;
+            }
+        }
+        if (!std::isfinite(best_cost)) return false;
+
+        result.a = best[1];
+        result.w = best[2];
+        result.p = std::remainder(best[2] * T[n - 1] + best[3], 2 * M_PI);
+        result.rms = std::sqrt(best_cost / n);
+        result.valid = result.rms < max_rms_;
+        return result.valid;
+    }
+
+private:
+    // x = [c, a, w, p], 在 Z 上做 LM, 返回残差平方和
+    double refine(const Eigen::ArrayXd& T, const Eigen::ArrayXd& Z, Eigen::Vector4d& x) const {
+        const int n = (int)T.size();
+        Eigen::ArrayXd phi, cs, sn, r;
+        Eigen::Matrix<double, Eigen::Dynamic, 4> J(n, 4);
+
+        auto residual = [&](const Eigen::Vector4d& v, Eigen::ArrayXd& res) {
+            res = Z - v[0] + v[1] * (T + (v[2] * T + v[3]).cos() / v[2]);
+            return res.square().sum();
+        };
+
+        double cost = residual(x, r);
+        double lambda = 1e-3;
+        for (int iter = 0; iter < 20; iter++) {
+            double a = x[1], w = x[2], p = x[3];
+            phi = w * T + p;
+            cs = phi.cos();
+            sn = phi.sin();
+
+            // 模型 m = c - a * (t + cos(phi) / w) 的雅可比
+            J.col(0).setOnes();
+            J.col(1) = -(T + cs / w).matrix();
+            J.col(2) = (a * cs / (w * w) + a * T * sn / w).matrix();
+            J.col(3) = (a * sn / w).matrix();
+
+            Eigen::Matrix4d JtJ = J.transpose() * J;
+            Eigen::Vector4d Jtr = J.transpose() * r.matrix();
+
+            bool improved = false;
+            for (int k = 0; k < 10; k++) {
+                Eigen::Matrix4d A = JtJ;
+                A.diagonal() += lambda * JtJ.diagonal().cwiseMax(1e-9);
+                Eigen::Vector4d step = A.ldlt().solve(Jtr);
+                Eigen::Vector4d next = x + step;
+                next[1] = std::clamp(next[1], a_min_, a_max_);
+                next[2] = std::clamp(next[2], w_min_, w_max_);
+
+                Eigen::ArrayXd next_r;
+                double next_cost = residual(next, next_r);
+                if (next_cost < cost) {
+                    improved = (cost - next_cost) > 1e-6 * cost;
+                    x = next;
+                    r = next_r;
+                    cost = next_cost;
+                    lambda = std::max(lambda * 0.1, 1e-9);
+                    break;
+                }
+                lambda *= 10;
+            }
+            if (!improved) break;
+        }
+        return cost;
+    }
+
+    size_t size_;                           // Maximal number of samples in window
+    double a_min_ = 0.780;                  // Bounds of a
+    double a_max_ = 1.045;
+    double w_min_ = 1.884;                  // Bounds of w
+    double w_max_ = 2.000;
+    double base_ = 2.090;                   // Speed offset, b = base - a
+    double step_ = 2 * M_PI / 5;            // Angle between two leaves
+    double min_span_ = 1.0;                 // Minimal time span to fit, s
+    double max_rms_ = 0.05;                 // Maximal RMS residual, rad
+
+    std::deque<double> t_;                  // Sample time, s
+    std::deque<double> angle_;              // Unwrapped sample angle, rad
+};
+
+}
+
+#endif
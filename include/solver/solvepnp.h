@@ -4,6 +4,7 @@
 #include <structure/camera.hpp>
 #include <opencv2/opencv.hpp>
 #include <Eigen/Core>
+#include <cmath>
 #include <utils/tf.h>
 
 namespace rm {
@@ -17,8 +18,11 @@ constexpr double ANGLE_BOUNDARY_DOWN = 0;
 
 class YawPnP {
 public:
+    typedef Eigen::Matrix<double, 4, 4> Points4d;   // 四点齐次坐标，每列一个点
+    typedef Eigen::Matrix<double, 2, 4> Points2d;   // 四点像素坐标，每列一个点
+
     YawPnP() {}
-    YawPnP(ArmorElevation elevation) : elevation(elevation) {}
+    YawPnP(ArmorElevation elevation) { setElevation(elevation); }
 
     void setWorldPoints(const std::vector<cv::Point3f>& object_points);
     void setImagePoints(const std::vector<cv::Point2f>& image_points);
@@ -27,33 +31,113 @@ public:
 
     ArmorElevation setElevation(double pitch);
     ArmorElevation setElevation(rm::ArmorID armor_id);
-    std::vector<Eigen::Vector4d> getMapping(double append_yaw) const;
-    std::vector<Eigen::Vector2d> getProject(const std::vector<Eigen::Vector4d>& P_world) const;
-    double getCost(const std::vector<Eigen::Vector2d>& P_project, double append_yaw) const;
-    double getPixelCost(const std::vector<Eigen::Vector2d>& P_project, double append_yaw) const;
-    double getAngleCost(const std::vector<Eigen::Vector2d>& P_project, double append_yaw) const;
+    ArmorElevation setElevation(ArmorElevation elevation);
+    Points4d getMapping(double append_yaw) const;
+    Points2d getProject(const Points4d& P_world) const;
+    double getCost(const Points2d& P_project, double append_yaw) const;
+    double getPixelCost(const Points2d& P_project) const;
+    double getAngleCost(const Points2d& P_project) const;
 
     double getCost(double append_yaw) const;
     double getPixelCost(double append_yaw) const;
     double getAngleCost(double append_yaw) const;
 
+    // 一次计算N个候选yaw的代价，映射与投影按列批量完成
+    template<int N>
+    void getMapping(const Eigen::Matrix<double, 1, N>& append_yaw, Eigen::Matrix<double, 4, 4 * N>& P_mapping) const;
+    template<int N>
+    void getProject(const Eigen::Matrix<double, 4, 4 * N>& P_mapping, Eigen::Matrix<double, 2, 4 * N>& P_project) const;
+    template<int N>
+    Eigen::Matrix<double, 1, N> getPixelCost(const Eigen::Matrix<double, 1, N>& append_yaw) const;
+    template<int N>
+    Eigen::Matrix<double, 1, N> getAngleCost(const Eigen::Matrix<double, 1, N>& append_yaw) const;
+
     double getYawByPixelCost(double left, double right, double epsilon) const;
     double getYawByAngleCost(double left, double right, double epsilon) const;
+    double getYawByPixelCost(double left, double right, double seed, double epsilon) const;
+    double getYawByAngleCost(double left, double right, double seed, double epsilon) const;
     double getYawByMix(double pixel_yaw, double angle_yaw) const;
 
 
-    double          sys_yaw;
+    double          sys_yaw = 0.0;
     Eigen::Vector4d pose;
     ArmorElevation  elevation;
+    double          elevation_sin = 0.0;       // 装甲板仰角正弦 (映射时使用的俯仰角)
+    double          elevation_cos = 1.0;       // 装甲板仰角余弦
+    bool            world_valid = false;       // 世界坐标四点是否完整
+    bool            pixel_valid = false;       // 像素坐标四点是否完整
 
-    std::vector<Eigen::Vector2d> P_pixel;      // 四点真实像素坐标
-    std::vector<Eigen::Vector4d> P_world;      // 四点正对世界坐标
+    Points2d P_pixel;                          // 四点真实像素坐标
+    Points4d P_world;                          // 四点正对世界坐标
 
     Eigen::Matrix3d Kc;                        // 相机内参矩阵
     Eigen::Matrix4d T;                         // 图像坐标系在陀螺仪坐标系下的表示
     Eigen::Matrix4d T_inv;                     // 陀螺仪坐标系在图像坐标系下的表示
 };
 
+template<int N>
+void YawPnP::getMapping(const Eigen::Matrix<double, 1, N>& append_yaw, Eigen::Matrix<double, 4, 4 * N>& P_mapping) const {
+    // P_world第一行恒为0，映射只需要M的第二、三列
+    for (int i = 0; i < N; i++) {
+        double yaw = sys_yaw + append_yaw(i);
+        double s = sin(yaw), c = cos(yaw);
+        Eigen::Matrix<double, 4, 3> M;
+        M << -s, -elevation_sin * c, pose(0),
+              c, -elevation_sin * s, pose(1),
+              0,      elevation_cos, pose(2),
+              0,                  0,       1;
+        P_mapping.template middleCols<4>(4 * i).noalias() = M * P_world.template bottomRows<3>();
+    }
+}
+
+template<int N>
+void YawPnP::getProject(const Eigen::Matrix<double, 4, 4 * N>& P_mapping, Eigen::Matrix<double, 2, 4 * N>& P_project) const {
+    Eigen::Matrix<double, 3, 4> KT = Kc * T_inv.topRows<3>();
+    Eigen::Matrix<double, 3, 4 * N> P_camera = KT * P_mapping;
+    P_project = P_camera.template topRows<2>().array().rowwise() / P_camera.row(2).array();
+}
+
+template<int N>
+Eigen::Matrix<double, 1, N> YawPnP::getPixelCost(const Eigen::Matrix<double, 1, N>& append_yaw) const {
+    Eigen::Matrix<double, 4, 4 * N> P_mapping;
+    Eigen::Matrix<double, 2, 4 * N> P_project;
+    getMapping<N>(append_yaw, P_mapping);
+    getProject<N>(P_mapping, P_project);
+
+    Eigen::Matrix<double, 1, N> cost;
+    for (int i = 0; i < N; i++) {
+        cost(i) = getPixelCost(P_project.template middleCols<4>(4 * i));
+    }
+    return cost;
+}
+
+template<int N>
+Eigen::Matrix<double, 1, N> YawPnP::getAngleCost(const Eigen::Matrix<double, 1, N>& append_yaw) const {
+    Eigen::Matrix<double, 4, 4 * N> P_mapping;
+    Eigen::Matrix<double, 2, 4 * N> P_project;
+    getMapping<N>(append_yaw, P_mapping);
+    getProject<N>(P_mapping, P_project);
+
+    Eigen::Matrix<double, 1, N> cost;
+    for (int i = 0; i < N; i++) {
+        cost(i) = getAngleCost(P_project.template middleCols<4>(4 * i));
+    }
+    return cost;
+}
+
+
+struct YawPnPShared {
+    Eigen::Matrix4d T;                         // 图像坐标系在陀螺仪坐标系下的表示
+    Eigen::Matrix4d T_inv;                     // 陀螺仪坐标系在图像坐标系下的表示
+    Eigen::Matrix3d Kc;                        // 相机内参矩阵
+    Eigen::Matrix3d rotate_pnp2world;          // pnp坐标系到世界坐标系的旋转
+};
+
+void getYawPnPShared(
+    Camera* camera,
+    const Eigen::Matrix3d& rotate_head2world,
+    const Eigen::Matrix4d& trans_head2world,
+    YawPnPShared& shared);
 
 double solveYawPnP(
     const double yaw,
@@ -66,6 +150,41 @@ double solveYawPnP(
     rm::ArmorID armor_id = rm::ARMOR_ID_UNKNOWN,
     bool display_flag = false);
 
+double solveYawPnP(
+    const double yaw,
+    Camera* camera,
+    const YawPnPShared& shared,
+    Eigen::Vector4d& ret_pose,
+    const std::vector<cv::Point3f>& object_points,
+    const std::vector<cv::Point2f>& image_points,
+    rm::ArmorID armor_id = rm::ARMOR_ID_UNKNOWN,
+    ArmorElevation* ret_elevation = nullptr);
+
+int solveYawPnPBatch(
+    Frame& frame,
+    const std::vector<Armor>& armors,
+    const double yaw,
+    Camera* camera,
+    const std::vector<cv::Point3f>& small_object_points,
+    const std::vector<cv::Point3f>& big_object_points,
+    const Eigen::Matrix3d& rotate_head2world,
+    const Eigen::Matrix4d& trans_head2world,
+    bool elevation_by_id = false);
+
+// 由R标与靶心四点解算符的位姿，输出 RuneV2::push 所需的 [x, y, z, theta, angle]
+// radius 为R标到靶心的距离，target_radius 为识别到的靶心圆半径
+bool solveRunePose(
+    Camera* camera,
+    const YawPnPShared& shared,
+    const Rune& rune,
+    Eigen::Matrix<double, 5, 1>& pose,
+    double radius = 0.69852,
+    double target_radius = 0.15);
+
+double getYawPnPSeed(
+    const double yaw,
+    const double armor_yaw);
+
 void displayYawPnP(YawPnP* yaw_pnp);
 
 }
@@ -0,0 +1,55 @@
+#ifndef __OPENRM_SOLVER_SOLVEVEHICLE_H__
+#define __OPENRM_SOLVER_SOLVEVEHICLE_H__
+#include <solver/solvepnp.h>
+#include <structure/stamp.hpp>
+#include <Eigen/Core>
+#include <vector>
+
+namespace rm {
+
+constexpr int VEHICLE_ARMOR_MAX = 4;
+
+struct VehicleArmor {
+    YawPnP::Points4d P_world;                  // 四点正对世界坐标
+    YawPnP::Points2d P_pixel;                  // 四点真实像素坐标
+    ArmorElevation   elevation;                // 装甲板仰角
+    Eigen::Vector4d  pose;                     // 单装甲板解算位置，作为初值
+    double           yaw;                      // 单装甲板解算朝向，作为初值
+};
+
+struct VehiclePose {
+    Eigen::Vector3d center = Eigen::Vector3d::Zero();   // 车体中心，z为两组装甲板平均高度
+    double yaw = 0.0;                                   // 参考装甲板(输入的第一个)朝向
+    double r[2] = {0.25, 0.25};                         // 两组装甲板半径
+    double z[2] = {0.0, 0.0};                           // 两组装甲板高度
+    int    index[VEHICLE_ARMOR_MAX] = {0, 0, 0, 0};     // 各装甲板相对参考装甲板的序号
+    int    armor_num = 4;                               // 车体装甲板数量
+    int    iterations = 0;                              // 迭代次数
+    double cost = 0.0;                                  // 平均重投影误差 pixel
+    bool   converged = false;                           // 是否在预算内收敛
+};
+
+bool getVehicleArmor(
+    const Armor& armor,
+    const Target& target,
+    const std::vector<cv::Point3f>& small_object_points,
+    const std::vector<cv::Point3f>& big_object_points,
+    VehicleArmor& vehicle_armor);
+
+// 同一车体的多块装甲板联合求解中心、朝向与半径，按装甲板数量约束相邻装甲板夹角
+bool solveVehiclePnP(
+    const YawPnPShared& shared,
+    const std::vector<VehicleArmor>& armors,
+    VehiclePose& vehicle,
+    int armor_num = 4,
+    double time_budget = 5e-4,
+    int max_iter = 20);
+
+// 车体第index块装甲板的位姿 [x, y, z, theta]
+Eigen::Vector4d getVehicleArmorPose(
+    const VehiclePose& vehicle,
+    int index);
+
+}
+
+#endif
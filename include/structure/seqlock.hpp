@@ -0,0 +1,59 @@
+#ifndef __OPENRM_STRUCTURE_SEQLOCK_HPP__
+#define __OPENRM_STRUCTURE_SEQLOCK_HPP__
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace rm {
+
+// 顺序锁: 单写多读, 读端不加锁也不阻塞写端, 读到写入中途的数据时重试
+// 数据按 8 字节拆分为原子字存储, 读写两端都没有数据竞争; 多个写端需要在外部串行
+template<class T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable_v<T>, "SeqLock requires a trivially copyable type");
+    static constexpr int N = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+public:
+    SeqLock() { store(T{}); }
+    SeqLock(const SeqLock& other) { store(other.load()); }
+    SeqLock& operator=(const SeqLock& other) {
+        if (this != &other) store(other.load());
+        return *this;
+    }
+    ~SeqLock() {}
+
+    void store(const T& value) {
+        uint64_t words[N] = {};
+        std::memcpy(words, &value, sizeof(T));
+
+        uint32_t seq = seq_.load(std::memory_order_relaxed);
+        seq_.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (int i = 0; i < N; i++) data_[i].store(words[i], std::memory_order_relaxed);
+        seq_.store(seq + 2, std::memory_order_release);
+    }
+
+    T load() const {
+        uint64_t words[N];
+        uint32_t seq0, seq1;
+        do {
+            seq0 = seq_.load(std::memory_order_acquire);
+            for (int i = 0; i < N; i++) words[i] = data_[i].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            seq1 = seq_.load(std::memory_order_relaxed);
+        } while ((seq0 != seq1) || (seq0 & 1));
+
+        T value;
+        std::memcpy(&value, words, sizeof(T));
+        return value;
+    }
+
+private:
+    std::atomic<uint32_t> seq_{0};          // Odd while a write is in progress
+    std::atomic<uint64_t> data_[N];         // Value split into atomic words
+};
+
+}
+
+#endif
@@ -1,48 +1,60 @@
 #ifndef __OPENRM_STRUCTURE_SLIDE_STD_HPP__
 #define __OPENRM_STRUCTURE_SLIDE_STD_HPP__
+#include <array>
 #include <deque>
+#include <vector>
+#include <type_traits>
 #include <cmath>
 #include <algorithm>
 #include <numeric>
 
 namespace rm {
 
-template<typename T>
+// 环形缓冲: 窗口在构造时一次性分配, 之后 push 不再申请内存
+// N 大于 0 时窗口内嵌为定长数组, 窗口长度不超过 N, 放入目标池时不产生任何堆分配
+template<typename T, size_t N = 0>
 class SlideStd {
     
 public:
-    SlideStd() : size_((size_t)20), sum_((T)0) {}
-    SlideStd(int size) : size_((size_t)size), sum_((T)0) {}
+    SlideStd() : SlideStd((N > 0) ? (int)N : 20) {}
+    SlideStd(int size) : size_((size_t)size), sum_((T)0) {
+        if constexpr (N > 0) size_ = std::min(size_, N);
+        else values_.resize(size_);
+    }
     ~SlideStd() {}
 
     void push(T value) {
-        if (values_.size() < size_) {
-            values_.push_back(value); 
+        if (count_ < size_) {
+            values_[(head_ + count_) % size_] = value;
+            count_++;
         } else {
-            sum_ -= values_.front();
-            values_.pop_front();
-            values_.push_back(value);
+            sum_ -= values_[head_];
+            values_[head_] = value;
+            head_ = (head_ + 1) % size_;
         }
         sum_ += value;
-        T average = sum_ / values_.size();
+        T average = sum_ / count_;
         avg_ = average;
-        var_ = std::accumulate(values_.begin(), values_.end(), 0.0, [average](double acc, T value) { 
+        var_ = std::accumulate(values_.begin(), values_.begin() + count_, 0.0, [average](double acc, T value) { 
                             return acc + std::pow(value - average, 2); 
-                        } ) / values_.size();
+                        } ) / count_;
         std_ = sqrt(var_);
     }
     double getStd() {return std_;};
     double getVar() {return var_;};
     double getAvg() {return avg_;};
-    size_t getSize() {return values_.size();};
+    size_t getSize() {return count_;};
     void clear() {
-        values_.clear();
+        head_ = 0;
+        count_ = 0;
         sum_ = (T)0;
         avg_ = (T)0;
     }
 
 private:
-    std::deque<T> values_;
+    std::conditional_t<(N > 0), std::array<T, N>, std::vector<T>> values_;  // Ring buffer of window values
+    size_t head_ = 0;                       // Index of the oldest value
+    size_t count_ = 0;                      // Number of values in window
     size_t size_;
     T sum_;
     T avg_;
@@ -0,0 +1,131 @@
+#ifndef __OPENRM_STRUCTURE_SLOTMAP_HPP__
+#define __OPENRM_STRUCTURE_SLOTMAP_HPP__
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace rm {
+
+constexpr int TRACK_POOL_CAPACITY = 32;     // Capacity of the target state pool of every TrackQueue version
+
+struct SlotHandle {
+    int      index = -1;                    // Slot index, -1 for null handle
+    uint32_t generation = 0;                // Generation of slot when the handle was issued
+
+    bool operator==(const SlotHandle& other) const = default;
+};
+
+// 定容槽位表: 元素连续存放便于遍历, 删除时用末尾元素填补空位
+// 容量在构造时一次性分配, 之后插入删除都不再申请内存
+// 句柄带代数校验, 元素删除后旧句柄失效; 元素指针在任何删除后都可能失效, 跨帧保存请使用句柄
+template<typename T>
+class SlotMap {
+
+public:
+    SlotMap() : SlotMap(16) {}
+    SlotMap(int capacity) : slots_(capacity) {
+        values_.reserve(capacity);
+        owner_.reserve(capacity);
+        free_.reserve(capacity);
+        for (int i = capacity - 1; i >= 0; i--) free_.push_back(i);
+    }
+    ~SlotMap() {}
+
+    // 容量已满时返回空句柄
+    template<typename... Args>
+    SlotHandle emplace(Args&&... args) {
+        if (free_.empty()) return SlotHandle();
+        int slot = free_.back();
+        free_.pop_back();
+        slots_[slot].dense = (int)values_.size();
+        values_.emplace_back(std::forward<Args>(args)...);
+        owner_.push_back(slot);
+        return SlotHandle{slot, slots_[slot].generation};
+    }
+
+    bool valid(SlotHandle handle) const {
+        return (handle.index >= 0) && (handle.index < (int)slots_.size()) &&
+               (slots_[handle.index].dense >= 0) &&
+               (slots_[handle.index].generation == handle.generation);
+    }
+
+    T* get(SlotHandle handle) {
+        if (!valid(handle)) return nullptr;
+        return &values_[slots_[handle.index].dense];
+    }
+
+    bool erase(SlotHandle handle) {
+        if (!valid(handle)) return false;
+        eraseDense(slots_[handle.index].dense);
+        return true;
+    }
+
+    // 从后向前遍历, 填补空位的元素都已判断过
+    template<typename Pred>
+    int eraseIf(Pred pred) {
+        int count = 0;
+        for (int i = (int)values_.size() - 1; i >= 0; i--) {
+            if (pred(values_[i])) {
+                eraseDense(i);
+                count++;
+            }
+        }
+        return count;
+    }
+
+    void clear() {
+        values_.clear();
+        owner_.clear();
+        free_.clear();
+        for (int i = (int)slots_.size() - 1; i >= 0; i--) {
+            if (slots_[i].dense >= 0) slots_[i].generation++;
+            slots_[i].dense = -1;
+            free_.push_back(i);
+        }
+    }
+
+    SlotHandle getHandle(int i) const { return SlotHandle{owner_[i], slots_[owner_[i]].generation}; }
+    T& operator[](int i) { return values_[i]; }
+    const T& operator[](int i) const { return values_[i]; }
+
+    typename std::vector<T>::iterator begin() { return values_.begin(); }
+    typename std::vector<T>::iterator end() { return values_.end(); }
+    typename std::vector<T>::const_iterator begin() const { return values_.begin(); }
+    typename std::vector<T>::const_iterator end() const { return values_.end(); }
+
+    size_t size() const { return values_.size(); }
+    size_t capacity() const { return slots_.size(); }
+    bool empty() const { return values_.empty(); }
+    bool full() const { return free_.empty(); }
+
+private:
+    void eraseDense(int i) {
+        int slot = owner_[i];
+        int last = (int)values_.size() - 1;
+        if (i != last) {
+            values_[i] = std::move(values_[last]);
+            owner_[i] = owner_[last];
+            slots_[owner_[i]].dense = i;
+        }
+        values_.pop_back();
+        owner_.pop_back();
+        slots_[slot].dense = -1;
+        slots_[slot].generation++;
+        free_.push_back(slot);
+    }
+
+    struct Slot {
+        int      dense = -1;                // Index in values_, -1 for free slot
+        uint32_t generation = 0;            // Incremented every time the slot is freed
+    };
+
+    std::vector<T>    values_;              // Contiguous elements
+    std::vector<int>  owner_;               // Slot of each element
+    std::vector<Slot> slots_;               // Slot table
+    std::vector<int>  free_;                // Free slots
+};
+
+}
+
+#endif
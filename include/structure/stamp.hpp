@@ -38,6 +38,17 @@ struct Armor {
     Armor() = default;
 };
 
+struct Rune {
+    cv::Point2f               center;        // R标中心
+    cv::Point2f               target;        // 待激活扇叶靶心
+    std::vector<cv::Point2f>  four_points;   // 靶心圆沿扇叶方向的远、右、近、左四点
+    cv::Rect                  roi;           // 下一帧搜索区域
+    double                    radius = 0;    // R标到靶心的像素距离
+    double                    angle = 0;     // 扇叶像素角度，逆时针为正
+    bool                      valid = false; // 是否识别成功
+    Rune() = default;
+};
+
 struct LightbarPair {
     Lightbar                  first;         // 灯条0
     Lightbar                  second;        // 灯条1
@@ -0,0 +1,76 @@
+#ifndef __OPENRM_STRUCTURE_TRAJECTORY_HPP__
+#define __OPENRM_STRUCTURE_TRAJECTORY_HPP__
+#include <cmath>
+#include <utils/timer.h>
+#include <Eigen/Dense>
+
+namespace rm {
+
+// 预测器一次给出的 N 个未来位姿, 第 i 列与同一时刻调用 getPose(delay[i]) 一致
+// 所有采样共用一次状态快照和一次 getTime(), 同一帧内的决策互相一致
+template<int N>
+struct Trajectory {
+    TimePoint base;                                 // Time of the call, sample i is at base + delay[i]
+    Eigen::Array<double, 1, N> delay;               // Append delay of each sample, s
+    Eigen::Matrix<double, 4, N> pose;               // Predicted pose of each sample, as getPose
+    bool valid = false;                             // False when the predictor has no available target
+
+    Trajectory() : Trajectory(0.0, 0.0) {}
+    Trajectory(double t0, double dt) {
+        base = getTime();
+        delay = t0 + dt * Eigen::Array<double, 1, N>::LinSpaced(N, 0, N - 1);
+        pose.setZero();
+    }
+
+    Eigen::Matrix<double, 4, 1> getPose(int i) const { return pose.col(i); }
+    TimePoint getTimePoint(int i) const {
+        return base + std::chrono::duration_cast<TimePoint::duration>(Duration_s(delay[i]));
+    }
+};
+
+// 绕中心旋转的装甲板轨迹, 每个采样选择正对中心连线的装甲板
+// t 为各采样相对状态时间戳的预测时长, r / h 为 toggle 两组装甲板的半径和高度
+// 第 3 行 yaw 取与中心连线角 atan2(y, x) 相差不超过半个装甲板间隔的一支, 范围为 [-pi - pi / armor_num, pi + pi / armor_num]
+// 各预测器的 getPose 按同样规则选取 yaw, 两者不会相差 2pi
+template<int N>
+void getSpinTrajectory(
+    Trajectory<N>& trajectory,
+    const Eigen::Array<double, 1, N>& t,
+    const double x,
+    const double y,
+    const double vx,
+    const double vy,
+    const double vz,
+    const double theta,
+    const double omega,
+    const int armor_num,
+    const double r[2],
+    const double h[2],
+    const int toggle
+) {
+    Eigen::Array<double, 1, N> x_center = x + vx * t;
+    Eigen::Array<double, 1, N> y_center = y + vy * t;
+    Eigen::Array<double, 1, N> center_angle = y_center.binaryExpr(
+        x_center, [](double a, double b) { return std::atan2(a, b); });
+
+    // 按整块装甲板平移到中心连线附近, 平移奇数块时四装甲板切换到另一组
+    double step = 2 * M_PI / armor_num;
+    Eigen::Array<double, 1, N> angle = theta + omega * t;
+    Eigen::Array<double, 1, N> shift = ((center_angle - angle) / step).round();
+    angle += step * shift;
+
+    double pair = (armor_num == 4) ? 1.0 : 0.0;
+    Eigen::Array<double, 1, N> odd = pair * (shift.abs() - 2 * (shift.abs() / 2).floor());
+    Eigen::Array<double, 1, N> radius = r[toggle] + (r[toggle ^ 1] - r[toggle]) * odd;
+    Eigen::Array<double, 1, N> height = h[toggle] + (h[toggle ^ 1] - h[toggle]) * odd;
+
+    trajectory.pose.row(0) = (x_center - radius * angle.cos()).matrix();
+    trajectory.pose.row(1) = (y_center - radius * angle.sin()).matrix();
+    trajectory.pose.row(2) = (height + vz * t).matrix();
+    trajectory.pose.row(3) = angle.matrix();
+    trajectory.valid = true;
+}
+
+}
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef __OPENRM_TENSORRT_CALIBRATOR_H__
+#define __OPENRM_TENSORRT_CALIBRATOR_H__
+
+#include <NvInfer.h>
+#include <string>
+#include <vector>
+#include "infer/calib.h"
+
+namespace rm {
+
+class Int8Calibrator : public nvinfer1::IInt8EntropyCalibrator2 {
+public:
+    Int8Calibrator(
+        const std::string& calib_dir,
+        const std::string& cache_file,
+        const std::string& input_name,
+        int input_width,
+        int input_height,
+        int batch_size = 1,
+        int max_num = 0);
+    ~Int8Calibrator() override;
+
+    int32_t getBatchSize() const noexcept override;
+    bool getBatch(void* bindings[], char const* names[], int32_t nb_bindings) noexcept override;
+    void const* readCalibrationCache(size_t& length) noexcept override;
+    void writeCalibrationCache(void const* cache, size_t length) noexcept override;
+
+private:
+    CalibLoader loader_;                    // Recorded frames with letterbox preprocessing
+    std::string cache_file_;                // Calibration cache file
+    std::string input_name_;                // Name of network input tensor
+
+    std::vector<float> host_buffer_;        // Host buffer of one batch
+    void* device_buffer_ = nullptr;         // Device buffer of one batch
+    std::vector<char> cache_;               // Calibration cache read from file
+};
+
+}
+
+#endif
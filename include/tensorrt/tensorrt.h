@@ -5,8 +5,11 @@
 #include <NvInferRuntime.h>
 #include <NvOnnxParser.h>
 #include <string>
+#include <functional>
 #include "structure/stamp.hpp"
 #include "tensorrt/logging.h"
+#include "infer/cache.h"
+#include "infer/evaluate.h"
 
 namespace rm {
 
@@ -22,6 +25,15 @@ bool initTrtEngine(
     nvinfer1::IExecutionContext** context
 );
 
+bool initTrtCache(
+    const std::string& onnx_file,
+    const std::string& cache_dir,
+    nvinfer1::IExecutionContext** context,
+    EnginePrecision precision = ENGINE_FP16,
+    unsigned int batch_size = 1U,
+    const std::string& calib_dir = ""
+);
+
 bool initCudaStream(
     cudaStream_t* stream
 );
@@ -167,6 +179,22 @@ std::vector<YoloRect> yoloArmorNMS_FPX(
     int infer_height
 );
 
+// NMS of one frame, called with output host buffer and the original image size
+typedef std::function<std::vector<YoloRect>(float* output_host_buffer, int input_width, int input_height)> DetectNMS;
+
+// Run every frame of a directory through the engine, detections are written by frame index
+bool detectDirectory(
+    nvinfer1::IExecutionContext** context,
+    const std::string& image_dir,
+    const DetectNMS& nms,
+    DetectList& detections,
+    size_t output_struct_size,
+    int bboxes_num,
+    int infer_width = 640,
+    int infer_height = 640,
+    int max_num = 0
+);
+
 }
 
 #endif
\ No newline at end of file
@@ -1,37 +1,129 @@
 #ifndef __OPENRM_UTILS_DELAY_H__
 #define __OPENRM_UTILS_DELAY_H__
+#include <cmath>
+#include <vector>
 
 namespace rm {
 
+// Quadratic drag a = -k * |v| * v, k = 0.5 * rho * Cd * A / m
+constexpr double DRAG_K_17MM = 0.019;
+constexpr double DRAG_K_42MM = 0.0095;
+
+// target 在云台 yaw 轴坐标系下; head 为 pitch 轴相对 yaw 轴的偏移 (随 yaw 转动),
+// barrel 为枪口相对 pitch 轴的偏移 (随 yaw / pitch 转动), barrel_yaw / barrel_pitch 为枪管安装角
+// drag_k 为 0 时使用无阻力抛物线
 double getFlyDelay(
     double& yaw,
-    double& pitch, 
+    double& pitch,
     const double speed,
     const double target_x,
     const double target_y,
     const double target_z,
-    const double head_dx, 
-    const double head_dy, 
+    const double head_dx,
+    const double head_dy,
     const double head_dz,
-    const double barrel_dx, 
-    const double barrel_dy, 
+    const double barrel_dx,
+    const double barrel_dy,
     const double barrel_dz,
     const double barrel_yaw,
-    const double barrel_pitch);
+    const double barrel_pitch,
+    const double drag_k = 0.0);
 
 double getFlyDelay(
     double& yaw,
-    double& pitch, 
+    double& pitch,
     const double speed,
     const double target_x,
     const double target_y,
-    const double target_z);
+    const double target_z,
+    const double drag_k = 0.0);
+
+// 以 pitch 射出后 RK4 积分到水平距离 distance, 返回飞行时间, height 为此时高度
+// 到达不了时返回负值
+double getFlyTrajectory(
+    double& height,
+    const double speed,
+    const double pitch,
+    const double distance,
+    const double drag_k);
+
+// Gimbal slew limits used by getRotateDelay without explicit limits
+constexpr double ROTATE_SPEED_MAX = 10.0;   // rad/s
+constexpr double ROTATE_ACCEL_MAX = 60.0;   // rad/s^2
 
+// 梯形速度曲线: 以最大加速度加速到最大角速度, 再对称减速停在目标角度
 double getRotateDelay(
     const double current_yaw,
     const double target_yaw);
 
+double getRotateDelay(
+    const double current_yaw,
+    const double target_yaw,
+    const double max_speed,
+    const double max_accel);
+
+// 目标位置依赖飞行时间, 迭代 "预测位置 -> 弹道解算" 直到飞行时间收敛
+// get_pose(append_delay) 返回 [x, y, z, ...], 与各预测器的 getPose 一致
+template<class Func>
+double getFlyDelayIter(
+    double& yaw,
+    double& pitch,
+    const double speed,
+    Func&& get_pose,
+    const double append_delay = 0.0,
+    const double drag_k = 0.0,
+    const int max_iter = 10,
+    const double tolerance = 1e-4
+) {
+    double t = 0.0;
+    for (int i = 0; i < max_iter; i++) {
+        auto pose = get_pose(t + append_delay);
+        double t_new = getFlyDelay(yaw, pitch, speed, pose[0], pose[1], pose[2], drag_k);
+        bool converge = std::fabs(t_new - t) < tolerance;
+        t = t_new;
+        if (converge) break;
+    }
+    return t;
+}
+
+
+// BallisticTable class
+// Precomputed (distance, height) -> (pitch, time) with bilinear lookup
+class BallisticTable {
+
+public:
+    BallisticTable() {}
+    ~BallisticTable() {}
+
+    bool build(
+        const double speed,
+        const double drag_k,
+        const double distance_min,
+        const double distance_max,
+        const double height_min,
+        const double height_max,
+        const double step);
+
+    // 超出表格范围或邻近格点不可达时返回 false, 调用方应回退到 getFlyDelay
+    bool query(const double distance, const double height, double& pitch, double& time) const;
+    bool query(double& yaw, double& pitch, double& time, const double target_x, const double target_y, const double target_z) const;
+
+    bool   empty() const { return pitch_.empty(); }
+    double getSpeed() const { return speed_; }
+
+private:
+    double speed_ = 0.0;                    // Bullet speed of table
+    double drag_k_ = 0.0;                   // Drag coefficient of table
+    double distance_min_ = 0.0;             // Horizontal distance of first column
+    double height_min_ = 0.0;               // Height of first row
+    double step_ = 0.0;                     // Grid spacing
+    int    rows_ = 0;                       // Number of heights
+    int    cols_ = 0;                       // Number of distances
+    std::vector<double> pitch_;             // Pitch of each grid point, NaN for unreachable
+    std::vector<double> time_;              // Fly time of each grid point, NaN for unreachable
+};
+
 }
 
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,98 @@
+#ifndef __OPENRM_UTILS_LATENCY_H__
+#define __OPENRM_UTILS_LATENCY_H__
+#include <mutex>
+#include <string>
+#include <vector>
+#include <utils/timer.h>
+#include <utils/delay.h>
+
+namespace rm {
+
+enum LatencyStage {
+    LATENCY_CAPTURE = 0,                // Exposure to Frame::time_point, usually pushed as a constant
+    LATENCY_DETECT,                     // Frame::time_point to detection done
+    LATENCY_PNP,                        // Detection done to pose solved
+    LATENCY_PREDICT,                    // Pose solved to prediction done
+    LATENCY_SERIAL,                     // Prediction done to serial write returned
+    LATENCY_STAGE_NUM
+};
+
+// 延迟预算: 在线估计流水线各阶段耗时, 给出 getPose 需要额外补偿的延迟
+// 预测器 getPose 已经计入 Frame::time_point 到调用时刻的耗时 (检测、解算、预测),
+// append_delay 只需补偿时间戳之前的曝光, 调用之后的串口、下位机控制和云台转动
+class LatencyBudget {
+
+public:
+    LatencyBudget(double alpha = 0.05);
+    ~LatencyBudget() {}
+
+    void push(LatencyStage stage, double latency);
+    void push(LatencyStage stage, const TimePoint& start, const TimePoint& end);
+
+    void setAlpha(double alpha) { alpha_ = alpha; }
+    void setControlDelay(double delay) { control_delay_ = delay; }                // Serial received to motor output on MCU
+    void setRotateLimit(double max_speed, double max_accel);                      // Gimbal slew limits for getRotateDelay
+
+    double getStage(LatencyStage stage);                                          // Mean latency of stage, s
+    double getStageStd(LatencyStage stage);                                       // Standard deviation of stage, s
+    double getTotal(double sigma = 0.0);                                          // Capture to serial, mean + sigma * std
+    double getAppendDelay(double current_yaw, double target_yaw);                 // Delay after getPose, including gimbal slew
+    void   getStateStr(std::vector<std::string>& str);
+
+    // 与 getFlyDelayIter 相同的 "预测位置 -> 弹道解算" 迭代, 每轮按新的目标 yaw 重新计算 append_delay
+    // 返回飞行时间, append_delay 为最终传给 get_pose 的额外补偿 (不含飞行时间)
+    template<class Func>
+    double getFlyDelay(
+        double& yaw,
+        double& pitch,
+        double& append_delay,
+        const double speed,
+        const double current_yaw,
+        Func&& get_pose,
+        const double drag_k = 0.0,
+        const int max_iter = 10,
+        const double tolerance = 1e-4);
+
+private:
+    double alpha_;                                          // Smoothing factor of exponential moving average
+    double control_delay_ = 0.0;                            // Delay of MCU control loop
+    double rotate_speed_;                                   // Max gimbal speed
+    double rotate_accel_;                                   // Max gimbal acceleration
+
+    double mean_[LATENCY_STAGE_NUM] = {};                   // Moving mean of each stage
+    double var_[LATENCY_STAGE_NUM] = {};                    // Moving variance of each stage
+    int    count_[LATENCY_STAGE_NUM] = {};                  // Sample count of each stage
+
+    std::mutex mtx_;                                        // Stages are pushed from different threads
+};
+
+template<class Func>
+double LatencyBudget::getFlyDelay(
+    double& yaw,
+    double& pitch,
+    double& append_delay,
+    const double speed,
+    const double current_yaw,
+    Func&& get_pose,
+    const double drag_k,
+    const int max_iter,
+    const double tolerance
+) {
+    double t = 0.0;
+    yaw = current_yaw;
+    append_delay = getAppendDelay(current_yaw, yaw);
+    for (int i = 0; i < max_iter; i++) {
+        auto pose = get_pose(t + append_delay);
+        double t_new = rm::getFlyDelay(yaw, pitch, speed, pose[0], pose[1], pose[2], drag_k);
+        double append_new = getAppendDelay(current_yaw, yaw);
+        bool converge = std::fabs(t_new + append_new - t - append_delay) < tolerance;
+        t = t_new;
+        append_delay = append_new;
+        if (converge) break;
+    }
+    return t;
+}
+
+}
+
+#endif
@@ -5,6 +5,7 @@
 #include <vector>
 #include <cstring>
 #include <cstdint>
+#include <type_traits>
 #include "utils/timer.h"
 
 namespace rm {
@@ -31,7 +32,8 @@ enum SerialStatus {
     SERIAL_STATUS_INIT_HEAD_FAILED,
     SERIAL_STATUS_SOF_ERROR,
     SERIAL_STATUS_CRC_ERROR,
-    SERIAL_STATUS_LENGTH_ERROR
+    SERIAL_STATUS_LENGTH_ERROR,
+    SERIAL_STATUS_INCOMPLETE
 };
 
 SerialStatus getSerialPortList(std::vector<std::string>& port_list, SerialType type = SERIAL_TYPE_TTY_USB);
@@ -81,6 +83,64 @@ SerialStatus initSerialHead(
     const unsigned char sof = 0xA5
 );
 
+// Frame: [ sof | length (2, little endian) | payload | crc16 (2, little endian) ]
+// crc16 covers sof, length and payload, CRC-16/MCR as used by the referee system
+constexpr size_t SERIAL_FRAME_HEAD = 3;
+constexpr size_t SERIAL_FRAME_TAIL = 2;
+
+uint16_t getCRC16(const unsigned char* data, size_t length, uint16_t crc = 0xFFFF);
+size_t packSerialFrame(
+    const unsigned char* payload,
+    uint16_t length,
+    unsigned char* frame,
+    const unsigned char sof = 0xA5
+);
+
+struct SerialCounter {
+    uint64_t bytes = 0;                     // Bytes received
+    uint64_t frame = 0;                     // Valid frames popped
+    uint64_t sof_error = 0;                 // Bytes dropped while searching sof
+    uint64_t length_error = 0;              // Headers with unexpected length
+    uint64_t crc_error = 0;                 // Frames with crc mismatch
+    uint64_t overflow = 0;                  // Bytes dropped when ring buffer is full
+    uint64_t read_error = 0;                // Failed reads of file descriptor
+};
+
+// Streaming framer over a ring buffer, never blocks longer than the poll timeout
+// Bad bytes are dropped one at a time so the next sof inside a broken frame is found
+// Streams mixing several payload types pop with max_length and dispatch by the returned length
+class SerialFramer {
+public:
+    SerialFramer(size_t capacity = 4096, const unsigned char sof = 0xA5);
+    ~SerialFramer() {}
+
+    SerialStatus read(int file_descriptor, int timeout_ms = 0);     // Read available bytes, wait at most timeout_ms
+    size_t       feed(const unsigned char* data, size_t length);    // Append bytes from another source
+    SerialStatus pop(unsigned char* data, size_t length);           // Pop next valid frame with this payload length
+    SerialStatus pop(unsigned char* data, size_t max_length, size_t& length);  // Pop next valid frame of any payload length up to max_length
+    template<class T> SerialStatus pop(T& data) {
+        static_assert(std::is_trivially_copyable_v<T>, "Serial frame payload must be trivially copyable");
+        return pop(reinterpret_cast<unsigned char*>(&data), sizeof(T));
+    }
+
+    void   clear() { head_ = tail_ = 0; }
+    size_t size() const { return tail_ - head_; }
+    const SerialCounter& getCounter() const { return counter_; }
+
+private:
+    unsigned char at(size_t index) const { return buffer_[(head_ + index) & mask_]; }
+    void   drop(size_t length) { head_ += length; }
+    void   copy(size_t index, unsigned char* data, size_t length) const;  // Copy bytes out of ring buffer across wrap
+    uint16_t getCRC16(size_t length) const;                          // CRC16 of first length bytes across wrap
+    SerialStatus popFrame(unsigned char* data, size_t min_length, size_t max_length, size_t& length);  // Pop frame with payload length in range
+
+    std::vector<unsigned char> buffer_;     // Ring buffer, capacity is power of two
+    size_t        mask_;                    // Capacity - 1
+    size_t        head_ = 0;                // Read index, grows monotonically
+    size_t        tail_ = 0;                // Write index, grows monotonically
+    unsigned char sof_;                     // Start of frame byte
+    SerialCounter counter_;                 // Error counters
+};
 
 }
 #endif
\ No newline at end of file
@@ -0,0 +1,88 @@
+#include "attack/scorer.h"
+#include <algorithm>
+using namespace rm;
+
+Scorer::Scorer() : AttackInterface() {
+    state_.resize(ArmorID::ARMOR_ID_COUNT);
+    priority_.assign(ArmorID::ARMOR_ID_COUNT, 0.5);
+    priority_[ARMOR_ID_HERO] = 1.0;
+    priority_[ARMOR_ID_SENTRY] = 0.8;
+    priority_[ARMOR_ID_ENGINEER] = 0.2;
+    priority_[ARMOR_ID_TOWER] = 0.3;
+    active_.reserve(ArmorID::ARMOR_ID_COUNT);
+    this->clear();
+}
+
+void Scorer::push(ArmorID armor_id, double angle, TimePoint t) {
+    push(armor_id, angle, 0.0, 0.0, ARMOR_SIZE_UNKNOWN, t);
+}
+
+void Scorer::push(ArmorID armor_id, double angle, double distance, double hit, ArmorSize size, TimePoint t) {
+    if (!isValidArmorID(armor_id, valid_byte_)) return;
+    ScorerState& state = state_[armor_id];
+    if (!state.exist) active_.push_back(armor_id);
+
+    state.angle = angle;
+    state.distance = distance;
+    state.hit = hit;
+    state.size = size;
+    state.last_t = t;
+    state.exist = true;
+}
+
+ArmorID Scorer::pop() {
+    expire(getTime());
+
+    // 只遍历存在的目标, 当前目标带切换代价, 新目标需高出该余量才会切换
+    ArmorID best_id = ARMOR_ID_UNKNOWN;
+    double best_score = 0.0;
+    for (ArmorID armor_id : active_) {
+        ScorerState& state = state_[armor_id];
+        state.score = getStateScore(state, armor_id);
+
+        double score = state.score;
+        if (armor_id == focus_id_) score += weight_.switch_cost;
+        if ((best_id == ARMOR_ID_UNKNOWN) || (score > best_score)) {
+            best_id = armor_id;
+            best_score = score;
+        }
+    }
+    focus_id_ = best_id;
+    return focus_id_;
+}
+
+void Scorer::refresh() {
+    focus_id_ = ARMOR_ID_UNKNOWN;
+    expire(getTime());
+}
+
+void Scorer::clear() {
+    for (auto& state : state_) {
+        state = ScorerState();
+    }
+    active_.clear();
+    focus_id_ = ARMOR_ID_UNKNOWN;
+}
+
+void Scorer::expire(TimePoint now_t) {
+    for (size_t i = 0; i < active_.size();) {
+        ScorerState& state = state_[active_[i]];
+        bool valid = isValidArmorID(active_[i], valid_byte_);
+        if (valid && (getDoubleOfS(state.last_t, now_t) <= exist_dt_)) {
+            i++;
+            continue;
+        }
+        state.exist = false;
+        active_[i] = active_.back();
+        active_.pop_back();
+    }
+}
+
+double Scorer::getStateScore(const ScorerState& state, ArmorID armor_id) {
+    double score = weight_.priority * priority_[armor_id]
+                 + weight_.hit * std::clamp(state.hit, 0.0, 1.0)
+                 - weight_.distance * state.distance
+                 - weight_.angle * std::min(state.angle, M_PI);
+    if (state.size == ARMOR_SIZE_BIG_ARMOR) score += weight_.size;
+    return score;
+}
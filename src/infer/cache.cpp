@@ -0,0 +1,299 @@
+#include "infer/cache.h"
+#include "uniterm/uniterm.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+using namespace rm;
+using namespace std;
+
+namespace fs = std::filesystem;
+
+static const char     CACHE_MAGIC[8]       = {'O', 'R', 'M', 'E', 'N', 'G', 'C', '\0'};
+static const uint32_t CACHE_FORMAT_VERSION = 1;
+static const uint64_t FNV_OFFSET_BASIS     = 0xcbf29ce484222325ULL;
+static const uint64_t FNV_PRIME            = 0x100000001b3ULL;
+
+struct EngineCacheHeader {
+    char     magic[8];                      // Fixed magic "ORMENGC"
+    uint32_t format_version;                // Layout version of the cache file
+    uint32_t precision;                     // Key: engine precision
+    uint32_t max_batch;                     // Key: max batch size
+    uint32_t reserved;
+    uint64_t onnx_hash;                     // Key: hash of the ONNX file
+    uint64_t lib_version;                   // Key: version of the inference library
+    uint64_t payload_size;                  // Size of the serialized engine
+    uint8_t  padding[16];                   // Keep the payload 64-byte aligned
+};
+static_assert(sizeof(EngineCacheHeader) == 64, "EngineCacheHeader must be 64 bytes");
+
+static bool mapReadOnly(const std::string& file, void** addr, size_t* size) {
+    int fd = open(file.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return false;
+    }
+
+    void* ptr = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (ptr == MAP_FAILED) return false;
+
+    // 引擎反序列化为顺序读取
+    madvise(ptr, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+
+    *addr = ptr;
+    *size = static_cast<size_t>(st.st_size);
+    return true;
+}
+
+static std::string getStemStr(const std::string& file) {
+    return fs::path(file).stem().string();
+}
+
+// 文件名形如 <stem>_<16位hash>_<precision>_b<batch>_v<version>.engine
+static bool isCacheNameOf(const std::string& name, const std::string& stem) {
+    size_t pos = stem.size() + 1;
+    if (name.size() <= pos + 17) return false;
+    if (name.compare(0, stem.size(), stem) != 0 || name[stem.size()] != '_') return false;
+    for (size_t i = pos; i < pos + 16; i++) {
+        if (!isxdigit(static_cast<unsigned char>(name[i]))) return false;
+    }
+    return name[pos + 16] == '_';
+}
+
+// 文件名中的 hash 与推理库版本, .calib 文件没有头部, 只能从文件名取得
+static bool getCacheNameKey(const std::string& name, const std::string& stem, uint64_t& onnx_hash, uint64_t& lib_version) {
+    size_t version_pos = name.rfind("_v");
+    size_t dot_pos = name.rfind('.');
+    if (version_pos == std::string::npos || dot_pos == std::string::npos || dot_pos <= version_pos + 2) return false;
+
+    std::string version_str = name.substr(version_pos + 2, dot_pos - version_pos - 2);
+    if (!all_of(version_str.begin(), version_str.end(), [](unsigned char c) { return isdigit(c); })) return false;
+    onnx_hash = strtoull(name.substr(stem.size() + 1, 16).c_str(), nullptr, 16);
+    lib_version = strtoull(version_str.c_str(), nullptr, 10);
+    return true;
+}
+
+// 只读取头部, 魔数或格式版本不符时视为损坏
+static bool readCacheHeader(const std::string& file, EngineCacheHeader& header) {
+    FILE* fp = fopen(file.c_str(), "rb");
+    if (fp == nullptr) return false;
+    bool ok = fread(&header, sizeof(header), 1, fp) == 1;
+    fclose(fp);
+    return ok && (memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) == 0)
+              && (header.format_version == CACHE_FORMAT_VERSION);
+}
+
+bool rm::getFileHash(const std::string& file, uint64_t& hash) {
+    void* addr = nullptr;
+    size_t size = 0;
+    if (!mapReadOnly(file, &addr, &size)) {
+        rm::message("Engine cache : failed to map " + file, rm::MSG_ERROR);
+        return false;
+    }
+
+    const uint8_t* data = static_cast<const uint8_t*>(addr);
+    uint64_t h = FNV_OFFSET_BASIS;
+    for (size_t i = 0; i < size; i++) {
+        h ^= data[i];
+        h *= FNV_PRIME;
+    }
+    munmap(addr, size);
+
+    hash = h;
+    return true;
+}
+
+bool rm::getEngineCacheKey(
+    const std::string& onnx_file,
+    EnginePrecision precision,
+    unsigned int max_batch,
+    uint64_t lib_version,
+    EngineCacheKey& key
+) {
+    uint64_t hash;
+    if (!getFileHash(onnx_file, hash)) return false;
+
+    key.onnx_hash = hash;
+    key.precision = static_cast<uint32_t>(precision);
+    key.max_batch = std::max(max_batch, 1U);
+    key.lib_version = lib_version;
+    return true;
+}
+
+std::string rm::getPrecisionStr(EnginePrecision precision) {
+    switch (precision) {
+        case ENGINE_FP32: return "fp32";
+        case ENGINE_FP16: return "fp16";
+        case ENGINE_INT8: return "int8";
+        default:          return "unknown";
+    }
+}
+
+std::string rm::getEngineCachePath(
+    const std::string& cache_dir,
+    const std::string& onnx_file,
+    const EngineCacheKey& key
+) {
+    char key_str[96];
+    snprintf(key_str, sizeof(key_str), "_%016llx_%s_b%u_v%llu.engine",
+        static_cast<unsigned long long>(key.onnx_hash),
+        getPrecisionStr(static_cast<EnginePrecision>(key.precision)).c_str(),
+        key.max_batch,
+        static_cast<unsigned long long>(key.lib_version));
+    return (fs::path(cache_dir) / (getStemStr(onnx_file) + key_str)).string();
+}
+
+bool rm::writeEngineCache(
+    const std::string& cache_file,
+    const EngineCacheKey& key,
+    const void* data,
+    size_t size
+) {
+    if (data == nullptr || size == 0) {
+        rm::message("Engine cache : empty engine", rm::MSG_ERROR);
+        return false;
+    }
+
+    std::error_code ec;
+    fs::path parent = fs::path(cache_file).parent_path();
+    if (!parent.empty()) fs::create_directories(parent, ec);
+
+    EngineCacheHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.format_version = CACHE_FORMAT_VERSION;
+    header.precision = key.precision;
+    header.max_batch = key.max_batch;
+    header.onnx_hash = key.onnx_hash;
+    header.lib_version = key.lib_version;
+    header.payload_size = size;
+
+    // 先写入临时文件再重命名，掉电或重启时不会留下半截缓存
+    std::string tmp_file = cache_file + ".tmp";
+    FILE* fp = fopen(tmp_file.c_str(), "wb");
+    if (fp == nullptr) {
+        rm::message("Engine cache : failed to open " + tmp_file, rm::MSG_ERROR);
+        return false;
+    }
+    bool ok = (fwrite(&header, sizeof(header), 1, fp) == 1) && (fwrite(data, 1, size, fp) == size);
+    ok = (fflush(fp) == 0) && ok;
+    ok = (fsync(fileno(fp)) == 0) && ok;
+    fclose(fp);
+
+    if (!ok || rename(tmp_file.c_str(), cache_file.c_str()) != 0) {
+        unlink(tmp_file.c_str());
+        rm::message("Engine cache : failed to write " + cache_file, rm::MSG_ERROR);
+        return false;
+    }
+    return true;
+}
+
+bool rm::mapEngineCache(
+    const std::string& cache_file,
+    const EngineCacheKey& key,
+    EngineCache& cache
+) {
+    cache = EngineCache();
+    if (access(cache_file.c_str(), F_OK) != 0) return false;
+
+    void* addr = nullptr;
+    size_t size = 0;
+    if (!mapReadOnly(cache_file, &addr, &size)) {
+        rm::message("Engine cache : failed to map " + cache_file, rm::MSG_WARNING);
+        return false;
+    }
+
+    bool valid = size > sizeof(EngineCacheHeader);
+    if (valid) {
+        const EngineCacheHeader* header = static_cast<const EngineCacheHeader*>(addr);
+        valid = (memcmp(header->magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) == 0)
+            && (header->format_version == CACHE_FORMAT_VERSION)
+            && (header->precision == key.precision)
+            && (header->max_batch == key.max_batch)
+            && (header->onnx_hash == key.onnx_hash)
+            && (header->lib_version == key.lib_version)
+            && (header->payload_size == size - sizeof(EngineCacheHeader));
+    }
+
+    // 缓存与当前模型、精度或推理库不匹配时直接删除，下次重新构建
+    if (!valid) {
+        munmap(addr, size);
+        unlink(cache_file.c_str());
+        rm::message("Engine cache : invalidated " + cache_file, rm::MSG_WARNING);
+        return false;
+    }
+
+    cache.map_addr = addr;
+    cache.map_size = size;
+    cache.data = static_cast<const uint8_t*>(addr) + sizeof(EngineCacheHeader);
+    cache.size = size - sizeof(EngineCacheHeader);
+    return true;
+}
+
+bool rm::mapEngineFile(
+    const std::string& engine_file,
+    EngineCache& cache
+) {
+    cache = EngineCache();
+    void* addr = nullptr;
+    size_t size = 0;
+    if (!mapReadOnly(engine_file, &addr, &size)) return false;
+
+    cache.map_addr = addr;
+    cache.map_size = size;
+    cache.data = addr;
+    cache.size = size;
+    return true;
+}
+
+void rm::unmapEngineCache(EngineCache& cache) {
+    if (cache.map_addr != nullptr) {
+        munmap(cache.map_addr, cache.map_size);
+    }
+    cache = EngineCache();
+}
+
+int rm::clearEngineCache(
+    const std::string& cache_dir,
+    const std::string& onnx_file,
+    const EngineCacheKey& key
+) {
+    std::error_code ec;
+    if (!fs::is_directory(cache_dir, ec)) return 0;
+
+    std::string stem = getStemStr(onnx_file);
+    int removed = 0;
+    for (const auto& entry : fs::directory_iterator(cache_dir, ec)) {
+        if (!entry.is_regular_file(ec)) continue;
+
+        const fs::path& path = entry.path();
+        std::string name = path.filename().string();
+        if (!isCacheNameOf(name, stem)) continue;
+
+        // 其他精度与批大小的缓存仍然有效, 只清理同一模型由其他版本推理库构建的缓存与残留的临时文件
+        bool remove = false;
+        if (path.extension() == ".tmp") {
+            remove = true;
+        } else if (path.extension() == ".engine") {
+            EngineCacheHeader header;
+            remove = !readCacheHeader(path.string(), header)
+                || ((header.onnx_hash == key.onnx_hash) && (header.lib_version != key.lib_version));
+        } else if (path.extension() == ".calib") {
+            uint64_t onnx_hash = 0, lib_version = 0;
+            remove = getCacheNameKey(name, stem, onnx_hash, lib_version)
+                && (onnx_hash == key.onnx_hash) && (lib_version != key.lib_version);
+        }
+        if (remove && fs::remove(path, ec)) removed++;
+    }
+    return removed;
+}
@@ -0,0 +1,152 @@
+#include "infer/calib.h"
+#include "uniterm/uniterm.h"
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+using namespace rm;
+using namespace std;
+
+namespace fs = std::filesystem;
+
+void rm::letterbox(
+    const uint8_t* src,
+    int src_width,
+    int src_height,
+    float* dst,
+    int dst_width,
+    int dst_height
+) {
+    // 与cuda/src/resize中的仿射矩阵及核函数保持一致，保证校准数据与推理输入同分布
+    float scale_in = std::min(static_cast<float>(dst_height) / src_height, static_cast<float>(dst_width) / src_width);
+    float scale_out = 1.f / scale_in;
+    float m_x = static_cast<float>(-scale_out * dst_width * 0.5 + src_width * 0.5);
+    float m_y = static_cast<float>(-scale_out * dst_height * 0.5 + src_height * 0.5);
+
+    const uint8_t const_value[3] = {114, 114, 114};
+    const int src_line_size = src_width * 3;
+    const int area = dst_width * dst_height;
+
+    for (int dy = 0; dy < dst_height; dy++) {
+        float src_y = scale_out * dy + m_y + 0.5f;
+        int y_low = static_cast<int>(floorf(src_y));
+        int y_high = y_low + 1;
+        float ly = src_y - y_low;
+        float hy = 1 - ly;
+        bool y_out = (src_y <= -1 || src_y >= src_height);
+
+        float* pdst_c0 = dst + dy * dst_width;
+        float* pdst_c1 = pdst_c0 + area;
+        float* pdst_c2 = pdst_c1 + area;
+
+        for (int dx = 0; dx < dst_width; dx++) {
+            float src_x = scale_out * dx + m_x + 0.5f;
+            float c0, c1, c2;
+
+            if (y_out || src_x <= -1 || src_x >= src_width) {
+                c0 = c1 = c2 = const_value[0];
+            } else {
+                int x_low = static_cast<int>(floorf(src_x));
+                int x_high = x_low + 1;
+                float lx = src_x - x_low;
+                float hx = 1 - lx;
+                float w1 = hy * hx, w2 = hy * lx, w3 = ly * hx, w4 = ly * lx;
+
+                const uint8_t* v1 = const_value;
+                const uint8_t* v2 = const_value;
+                const uint8_t* v3 = const_value;
+                const uint8_t* v4 = const_value;
+
+                if (y_low >= 0) {
+                    if (x_low >= 0) v1 = src + y_low * src_line_size + x_low * 3;
+                    if (x_high < src_width) v2 = src + y_low * src_line_size + x_high * 3;
+                }
+                if (y_high < src_height) {
+                    if (x_low >= 0) v3 = src + y_high * src_line_size + x_low * 3;
+                    if (x_high < src_width) v4 = src + y_high * src_line_size + x_high * 3;
+                }
+
+                c0 = w1 * v1[0] + w2 * v2[0] + w3 * v3[0] + w4 * v4[0];
+                c1 = w1 * v1[1] + w2 * v2[1] + w3 * v3[1] + w4 * v4[1];
+                c2 = w1 * v1[2] + w2 * v2[2] + w3 * v3[2] + w4 * v4[2];
+            }
+
+            // bgr to rgb, normalization, rgbrgbrgb to rrrgggbbb
+            pdst_c0[dx] = c2 / 255.0f;
+            pdst_c1[dx] = c1 / 255.0f;
+            pdst_c2[dx] = c0 / 255.0f;
+        }
+    }
+}
+
+void rm::letterbox(
+    const cv::Mat& src,
+    float* dst,
+    int dst_width,
+    int dst_height
+) {
+    if (src.isContinuous()) {
+        letterbox(src.data, src.cols, src.rows, dst, dst_width, dst_height);
+    } else {
+        cv::Mat continuous = src.clone();
+        letterbox(continuous.data, continuous.cols, continuous.rows, dst, dst_width, dst_height);
+    }
+}
+
+bool rm::getImageFiles(
+    const std::string& dir,
+    std::vector<std::string>& files,
+    int max_num
+) {
+    files.clear();
+    std::error_code ec;
+    if (!fs::is_directory(dir, ec)) {
+        rm::message("Calib : directory not found " + dir, rm::MSG_ERROR);
+        return false;
+    }
+
+    for (const auto& entry : fs::directory_iterator(dir, ec)) {
+        if (!entry.is_regular_file(ec)) continue;
+        std::string ext = entry.path().extension().string();
+        std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+        if (ext == ".jpg" || ext == ".jpeg" || ext == ".png" || ext == ".bmp") {
+            files.push_back(entry.path().string());
+        }
+    }
+
+    // 录制帧按文件名中的时间排序，均匀抽取保证覆盖整场比赛
+    std::sort(files.begin(), files.end());
+    if (max_num > 0 && static_cast<int>(files.size()) > max_num) {
+        std::vector<std::string> sampled;
+        double step = static_cast<double>(files.size()) / max_num;
+        for (int i = 0; i < max_num; i++) {
+            sampled.push_back(files[static_cast<size_t>(i * step)]);
+        }
+        files.swap(sampled);
+    }
+    return !files.empty();
+}
+
+CalibLoader::CalibLoader(const std::string& dir, int width, int height, int batch_size, int max_num) :
+    width_(width),
+    height_(height),
+    batch_size_(std::max(batch_size, 1)) {
+    if (dir.empty()) return;
+    getImageFiles(dir, files_, max_num);
+    rm::message("Calib frames : " + std::to_string(files_.size()), rm::MSG_NOTE);
+}
+
+bool CalibLoader::next(float* host_buffer) {
+    size_t frame_length = static_cast<size_t>(3) * width_ * height_;
+
+    int loaded = 0;
+    while (loaded < batch_size_ && index_ < files_.size()) {
+        cv::Mat img = cv::imread(files_[index_++], cv::IMREAD_COLOR);
+        if (img.empty()) {
+            rm::message("Calib : failed to read " + files_[index_ - 1], rm::MSG_WARNING);
+            continue;
+        }
+        letterbox(img, host_buffer + loaded * frame_length, width_, height_);
+        loaded++;
+    }
+    return loaded == batch_size_;
+}
@@ -0,0 +1,232 @@
+#include "infer/evaluate.h"
+#include "uniterm/uniterm.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+using namespace rm;
+using namespace std;
+
+struct EvalItem {
+    int    frame;
+    int    index;
+    float  confidence;
+};
+
+double rm::getRectIoU(const cv::Rect& a, const cv::Rect& b) {
+    int x0 = std::max(a.x, b.x);
+    int y0 = std::max(a.y, b.y);
+    int x1 = std::min(a.x + a.width, b.x + b.width);
+    int y1 = std::min(a.y + a.height, b.y + b.height);
+    if (x1 <= x0 || y1 <= y0) return 0.0;
+
+    double inter = static_cast<double>(x1 - x0) * (y1 - y0);
+    double uni = static_cast<double>(a.area()) + b.area() - inter;
+    return uni > 0.0 ? inter / uni : 0.0;
+}
+
+static double getCornerError(const YoloRect& a, const YoloRect& b) {
+    if (a.four_points.size() != 4 || b.four_points.size() != 4) return -1.0;
+    double sum = 0.0;
+    for (int i = 0; i < 4; i++) {
+        double dx = a.four_points[i].x - b.four_points[i].x;
+        double dy = a.four_points[i].y - b.four_points[i].y;
+        sum += std::sqrt(dx * dx + dy * dy);
+    }
+    return sum / 4.0;
+}
+
+// VOC all-point interpolation
+static double getAveragePrecision(const std::vector<double>& recall, const std::vector<double>& precision) {
+    std::vector<double> r(recall.size() + 2), p(precision.size() + 2);
+    r.front() = 0.0; r.back() = 1.0;
+    p.front() = 0.0; p.back() = 0.0;
+    std::copy(recall.begin(), recall.end(), r.begin() + 1);
+    std::copy(precision.begin(), precision.end(), p.begin() + 1);
+
+    for (int i = static_cast<int>(p.size()) - 2; i >= 0; i--) {
+        p[i] = std::max(p[i], p[i + 1]);
+    }
+    double ap = 0.0;
+    for (size_t i = 1; i < r.size(); i++) {
+        ap += (r[i] - r[i - 1]) * p[i];
+    }
+    return ap;
+}
+
+DetectEval rm::evaluateDetection(
+    const DetectList& reference,
+    const DetectList& test,
+    double iou_threshold
+) {
+    DetectEval eval;
+    size_t frame_num = std::min(reference.size(), test.size());
+    if (reference.size() != test.size()) {
+        rm::message("Evaluate : frame number mismatch", rm::MSG_WARNING);
+    }
+
+    int class_num = 0;
+    for (size_t f = 0; f < frame_num; f++) {
+        for (const auto& rect : reference[f]) class_num = std::max(class_num, rect.class_id + 1);
+        for (const auto& rect : test[f]) class_num = std::max(class_num, rect.class_id + 1);
+    }
+    eval.ap.assign(class_num, -1.0);
+
+    int reference_total = 0, test_total = 0;
+    double iou_sum = 0.0, corner_sum = 0.0;
+    int corner_count = 0, ap_count = 0;
+    double ap_sum = 0.0;
+
+    for (int c = 0; c < class_num; c++) {
+        // 以参考结果作为真值，测试结果按置信度降序贪心匹配
+        std::vector<EvalItem> items;
+        std::vector<std::vector<char>> used(frame_num);
+        int gt_num = 0;
+        for (size_t f = 0; f < frame_num; f++) {
+            used[f].assign(reference[f].size(), 0);
+            for (const auto& rect : reference[f]) gt_num += (rect.class_id == c);
+            for (size_t i = 0; i < test[f].size(); i++) {
+                if (test[f][i].class_id == c) items.push_back({static_cast<int>(f), static_cast<int>(i), test[f][i].confidence});
+            }
+        }
+        std::sort(items.begin(), items.end(), [](const EvalItem& a, const EvalItem& b) {
+            return a.confidence > b.confidence;
+        });
+        reference_total += gt_num;
+        test_total += static_cast<int>(items.size());
+
+        std::vector<double> recall, precision;
+        int tp = 0, fp = 0;
+        for (const auto& item : items) {
+            const YoloRect& det = test[item.frame][item.index];
+            const auto& refs = reference[item.frame];
+
+            int best = -1;
+            double best_iou = iou_threshold;
+            for (size_t j = 0; j < refs.size(); j++) {
+                if (refs[j].class_id != c || used[item.frame][j]) continue;
+                double iou = getRectIoU(det.box, refs[j].box);
+                if (iou >= best_iou) {
+                    best_iou = iou;
+                    best = static_cast<int>(j);
+                }
+            }
+
+            if (best >= 0) {
+                used[item.frame][best] = 1;
+                tp++;
+                iou_sum += best_iou;
+                double corner = getCornerError(det, refs[best]);
+                if (corner >= 0.0) {
+                    corner_sum += corner;
+                    corner_count++;
+                }
+            } else {
+                fp++;
+            }
+            if (gt_num > 0) {
+                recall.push_back(static_cast<double>(tp) / gt_num);
+                precision.push_back(static_cast<double>(tp) / (tp + fp));
+            }
+        }
+
+        eval.matched += tp;
+        if (gt_num > 0) {
+            eval.ap[c] = getAveragePrecision(recall, precision);
+            ap_sum += eval.ap[c];
+            ap_count++;
+        }
+    }
+
+    eval.missed = reference_total - eval.matched;
+    eval.extra = test_total - eval.matched;
+    eval.map = ap_count > 0 ? ap_sum / ap_count : 0.0;
+    eval.mean_iou = eval.matched > 0 ? iou_sum / eval.matched : 0.0;
+    eval.corner_error = corner_count > 0 ? corner_sum / corner_count : 0.0;
+    eval.precision = test_total > 0 ? static_cast<double>(eval.matched) / test_total : 0.0;
+    eval.recall = reference_total > 0 ? static_cast<double>(eval.matched) / reference_total : 0.0;
+    return eval;
+}
+
+void rm::reportDetectEval(
+    const std::string& name,
+    const DetectEval& eval,
+    const DetectEval* base
+) {
+    char str[160];
+    snprintf(str, sizeof(str), "%s mAP %.4f IoU %.4f corner %.2fpx P %.4f R %.4f miss %d extra %d",
+        name.c_str(), eval.map, eval.mean_iou, eval.corner_error,
+        eval.precision, eval.recall, eval.missed, eval.extra);
+    rm::message(std::string(str), rm::MSG_NOTE);
+
+    if (base != nullptr) {
+        snprintf(str, sizeof(str), "%s delta mAP %+.4f IoU %+.4f corner %+.2fpx",
+            name.c_str(), eval.map - base->map, eval.mean_iou - base->mean_iou,
+            eval.corner_error - base->corner_error);
+        rm::message(std::string(str), rm::MSG_NOTE);
+    }
+
+    for (size_t c = 0; c < eval.ap.size(); c++) {
+        if (eval.ap[c] < 0.0) continue;
+        snprintf(str, sizeof(str), "%s class %zu AP %.4f", name.c_str(), c, eval.ap[c]);
+        rm::message(std::string(str), rm::MSG_NOTE);
+    }
+}
+
+// 每行一个检测结果: frame class color confidence x y w h [x0 y0 x1 y1 x2 y2 x3 y3]
+bool rm::writeDetections(const std::string& file, const DetectList& detections) {
+    std::ofstream out(file);
+    if (!out.is_open()) {
+        rm::message("Evaluate : failed to open " + file, rm::MSG_ERROR);
+        return false;
+    }
+    out << "# frames " << detections.size() << "\n";
+    for (size_t f = 0; f < detections.size(); f++) {
+        for (const auto& rect : detections[f]) {
+            out << f << " " << rect.class_id << " " << rect.color_id << " " << rect.confidence << " "
+                << rect.box.x << " " << rect.box.y << " " << rect.box.width << " " << rect.box.height;
+            if (rect.four_points.size() == 4) {
+                for (const auto& p : rect.four_points) out << " " << p.x << " " << p.y;
+            }
+            out << "\n";
+        }
+    }
+    return true;
+}
+
+bool rm::readDetections(const std::string& file, DetectList& detections) {
+    std::ifstream in(file);
+    if (!in.is_open()) {
+        rm::message("Evaluate : failed to open " + file, rm::MSG_ERROR);
+        return false;
+    }
+    detections.clear();
+
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty()) continue;
+        std::istringstream iss(line);
+        if (line[0] == '#') {
+            std::string tag;
+            size_t frames = 0;
+            iss >> tag >> tag >> frames;
+            if (detections.size() < frames) detections.resize(frames);
+            continue;
+        }
+
+        size_t frame;
+        YoloRect rect;
+        if (!(iss >> frame >> rect.class_id >> rect.color_id >> rect.confidence
+                  >> rect.box.x >> rect.box.y >> rect.box.width >> rect.box.height)) {
+            continue;
+        }
+        cv::Point2f p;
+        while (iss >> p.x >> p.y) rect.four_points.push_back(p);
+        if (rect.four_points.size() != 4) rect.four_points.clear();
+
+        if (detections.size() <= frame) detections.resize(frame + 1);
+        detections[frame].push_back(rect);
+    }
+    return true;
+}
@@ -37,6 +37,8 @@ AntitopV3::AntitopV3(double r_min, double r_max, int armor_num, bool enable_weig
 }
 
 void AntitopV3::push(const Eigen::Matrix<double, 4, 1>& pose, TimePoint t) {
+    if (record_flag_) record_.push_back({getDoubleOfS(record_t0_, t), pose});
+
     double dt = getDoubleOfS(t_, t);
     if(dt > fire_delay_) {
         update_num_ = 0;
@@ -53,8 +55,8 @@ void AntitopV3::push(const Eigen::Matrix<double, 4, 1>& pose, TimePoint t) {
             return;
         }
     } else {
-        toggle_ = getToggle(pose[3], omega_model_.estimate_X[0]);
-        if (isAngleTrans(pose[3], omega_model_.estimate_X[0] + omega_model_.estimate_X[1] * dt)) {
+        toggle_ = getToggle(pose[3], omega_model_.estimate_X[0], toggle_, armor_num_);
+        if (isAngleTrans(pose[3], omega_model_.estimate_X[0] + omega_model_.estimate_X[1] * dt, armor_num_)) {
             omega_model_.estimate_X[0] = pose[3];
             model_.estimate_X[3] = pose[3];
             return;
@@ -65,7 +67,8 @@ void AntitopV3::push(const Eigen::Matrix<double, 4, 1>& pose, TimePoint t) {
     omega_model_.estimate_X[0] = getAngleTrans(
         pose[3], 
         omega_model_.estimate_X[0], 
-        omega_model_.estimate_X[0] + omega_model_.estimate_X[1] * dt);
+        omega_model_.estimate_X[0] + omega_model_.estimate_X[1] * dt,
+        armor_num_);
     omega_funcA_.dt = dt;
     omega_model_.predict(omega_funcA_);
     omega_model_.update(omega_funcH_, pose_theta);
@@ -74,7 +77,8 @@ void AntitopV3::push(const Eigen::Matrix<double, 4, 1>& pose, TimePoint t) {
     model_.estimate_X[3] = getAngleTrans(
         pose[3], 
         model_.estimate_X[3],
-        model_.estimate_X[3] + model_.estimate_X[7] * dt);
+        model_.estimate_X[3] + model_.estimate_X[7] * dt,
+        armor_num_);
     model_.estimate_X[2] = z_[toggle_];
     model_.estimate_X[8] = r_[toggle_];
 
@@ -99,6 +103,15 @@ void AntitopV3::push(const Eigen::Matrix<double, 4, 1>& pose, TimePoint t) {
     rm::message("antitop toggle", toggle_);
 }
 
+void AntitopV3::setRecord(bool record) {
+    // 开始记录时清空旧记录，停止记录后仍可保存
+    if (record && !record_flag_) {
+        record_.clear();
+        record_t0_ = getTime();
+    }
+    record_flag_ = record;
+}
+
 Eigen::Matrix<double, 4, 1> AntitopV3::getPose(double append_delay) {
     auto now = getTime();
     double sys_delay = getDoubleOfS(t_, now);
@@ -115,13 +128,13 @@ Eigen::Matrix<double, 4, 1> AntitopV3::getPose(double append_delay) {
     double kf_theta = omega_model_.estimate_X[0] + omega_model_.estimate_X[1] * dt;
     
     double theta = getAngleMin(kf_theta, x_center, y_center);
-    double r = r_[getToggle(theta, kf_theta)];
+    double r = r_[getToggle(theta, kf_theta, toggle_, armor_num_)];
     
     double z;
     if (enable_weighted_) {
-        z = weighted_z_[getToggle(theta, kf_theta)].getAvg();
+        z = weighted_z_[getToggle(theta, kf_theta, toggle_, armor_num_)].getAvg();
     } else {
-        z = z_[getToggle(theta, kf_theta)];
+        z = z_[getToggle(theta, kf_theta, toggle_, armor_num_)];
     }
     double x = x_center - r * cos(theta);
     double y = y_center - r * sin(theta);
@@ -130,6 +143,40 @@ Eigen::Matrix<double, 4, 1> AntitopV3::getPose(double append_delay) {
     return pose;
 }
 
+Eigen::Matrix<double, 3, 3> AntitopV3::getPoseCov(double append_delay) {
+    auto now = getTime();
+    double sys_delay = getDoubleOfS(t_, now);
+    // 与 getPose 相同的失效条件, 尚未更新或目标丢失时方差为无穷大
+    if ((update_num_ == 0) || (sys_delay > fire_delay_)) {
+        Eigen::Matrix<double, 3, 3> invalid = Eigen::Vector3d::Constant(INFINITY).asDiagonal();
+        return invalid;
+    }
+    double dt = sys_delay + append_delay;
+
+    double x_center = model_.estimate_X[0] + model_.estimate_X[4] * dt;
+    double y_center = model_.estimate_X[1] + model_.estimate_X[5] * dt;
+    double kf_theta = omega_model_.estimate_X[0] + omega_model_.estimate_X[1] * dt;
+    double theta = getAngleMin(kf_theta, x_center, y_center);
+    double r = r_[getToggle(theta, kf_theta, toggle_, armor_num_)];
+    double c = cos(theta), s = sin(theta);
+
+    // 与 getPose 一致: 中心 [ x, y, z, vx, vy ] 取自运动模型, 角度 theta + omega * dt 取自角速度模型, 半径视为常量
+    // z 取自观测均值, 不随 dt 外推, 以运动模型的 z 方差近似; 两个模型的互协方差忽略
+    Eigen::Matrix<double, 3, 9> J = Eigen::Matrix<double, 3, 9>::Zero();
+    J(0, 0) = 1;
+    J(0, 4) = dt;
+    J(1, 1) = 1;
+    J(1, 5) = dt;
+    J(2, 2) = 1;
+    Eigen::Matrix<double, 3, 3> cov = J * model_.P * J.transpose();
+
+    Eigen::Matrix<double, 1, 3> J_theta(1, dt, 0);
+    double theta_var = J_theta * omega_model_.P * J_theta.transpose();
+    Eigen::Matrix<double, 3, 1> J_armor(r * s, -r * c, 0);
+    cov += J_armor * theta_var * J_armor.transpose();
+    return cov;
+}
+
 Eigen::Matrix<double, 4, 1> AntitopV3::getCenter(double append_delay) {
     auto now = getTime();
     double sys_delay = getDoubleOfS(t_, now);
@@ -149,11 +196,11 @@ Eigen::Matrix<double, 4, 1> AntitopV3::getCenter(double append_delay) {
     
     double z;
     if (enable_weighted_) {
-        z = weighted_z_[getToggle(theta, kf_theta)].getAvg();
+        z = weighted_z_[getToggle(theta, kf_theta, toggle_, armor_num_)].getAvg();
     } else {
-        z = z_[getToggle(theta, kf_theta)];
+        z = z_[getToggle(theta, kf_theta, toggle_, armor_num_)];
     }
-    double r = r_[getToggle(theta, kf_theta)];
+    double r = r_[getToggle(theta, kf_theta, toggle_, armor_num_)];
 
     double target_yaw = atan2(y_center, x_center);
     double x = x_center - r * cos(target_yaw);
@@ -170,11 +217,11 @@ double AntitopV3::getSafeSub(const double angle1, const double angle2) {
     return angle;
 }
 
-double AntitopV3::getAngleTrans(const double target_angle, const double src_angle) {
+double AntitopV3::getAngleTrans(const double target_angle, const double src_angle, int armor_num) {
     double dst_angle = src_angle;
 
-    while(getSafeSub(dst_angle, target_angle) > (M_PI / armor_num_)) dst_angle -= (2 * M_PI) / armor_num_;
-    while(getSafeSub(target_angle, dst_angle) > (M_PI / armor_num_)) dst_angle += (2 * M_PI) / armor_num_;
+    while(getSafeSub(dst_angle, target_angle) > (M_PI / armor_num)) dst_angle -= (2 * M_PI) / armor_num;
+    while(getSafeSub(target_angle, dst_angle) > (M_PI / armor_num)) dst_angle += (2 * M_PI) / armor_num;
 
     while(dst_angle > M_PI)  dst_angle -= 2 * M_PI;
     while(dst_angle < -M_PI) dst_angle += 2 * M_PI;
@@ -185,16 +232,16 @@ double AntitopV3::getAngleTrans(const double target_angle, const double src_angl
     return dst_angle;
 }
 
-double AntitopV3::getAngleTrans(const double target_angle, const double src_angle, double refer_angle) {
+double AntitopV3::getAngleTrans(const double target_angle, const double src_angle, double refer_angle, int armor_num) {
     double dst_angle = src_angle;
 
-    while (getSafeSub(refer_angle, target_angle) > (M_PI / armor_num_)) {
-        refer_angle -= (2 * M_PI) / armor_num_;
-        dst_angle -= (2 * M_PI) / armor_num_;
+    while (getSafeSub(refer_angle, target_angle) > (M_PI / armor_num)) {
+        refer_angle -= (2 * M_PI) / armor_num;
+        dst_angle -= (2 * M_PI) / armor_num;
     }
-    while (getSafeSub(target_angle, refer_angle) > (M_PI / armor_num_)) {
-        refer_angle += (2 * M_PI) / armor_num_;
-        dst_angle += (2 * M_PI) / armor_num_;
+    while (getSafeSub(target_angle, refer_angle) > (M_PI / armor_num)) {
+        refer_angle += (2 * M_PI) / armor_num;
+        dst_angle += (2 * M_PI) / armor_num;
     }
 
     while(dst_angle > M_PI)  dst_angle -= 2 * M_PI;
@@ -206,23 +253,23 @@ double AntitopV3::getAngleTrans(const double target_angle, const double src_angl
     return dst_angle;
 }
 
-bool AntitopV3::isAngleTrans(const double target_angle, const double src_angle) {
+bool AntitopV3::isAngleTrans(const double target_angle, const double src_angle, int armor_num) {
     double differ_angle = fabs(getSafeSub(target_angle, src_angle));
-    if (differ_angle > (M_PI / armor_num_)) return true;
+    if (differ_angle > (M_PI / armor_num)) return true;
     else return false;
 }
 
 
 double AntitopV3::getAngleMin(double armor_angle, const double x, const double y) {
     double center_angle = atan2(y, x);
-    return getAngleTrans(center_angle, armor_angle);
+    return getAngleTrans(center_angle, armor_angle, armor_num_);
 }
 
-int AntitopV3::getToggle(const double target_angle, const double src_angle) {
-    if (armor_num_ < 4) return 0;
+int AntitopV3::getToggle(const double target_angle, const double src_angle, int toggle, int armor_num) {
+    if (armor_num < 4) return 0;
     double differ_angle = fabs(getSafeSub(target_angle, src_angle));
     int differ_toggle = static_cast<int>(round(2 * differ_angle / M_PI)) % 2;
-    return (differ_toggle^toggle_);
+    return (differ_toggle^toggle);
 }
 
 double AntitopV3::getWeightByTheta(const double theta) {
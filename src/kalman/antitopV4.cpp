@@ -0,0 +1,250 @@
+#include "kalman/interface/antitopV4.h"
+#include "utils/print.h"
+#include "uniterm/uniterm.h"
+#include <algorithm>
+#include <cmath>
+using namespace std;
+using namespace rm;
+
+// [ x, y, z, theta, vx, vy, vz, omega, r ]  [ x, y, z, theta ]
+// [ 0, 1, 2,   3,   4,  5,  6,    7,   8 ]  [ 0, 1, 2,   3   ]
+
+static const int armor_num_hypo[ANTITOP_ARMOR_HYPO_V4] = {2, 3, 4};
+
+AntitopV4::AntitopV4() {
+    t_ = getTime();
+    setMatrixQ(1e-4, 1e-4, 1e-4, 1e-4, 0.01, 0.01, 1e-4, 0.04, 1e-5);
+    setMatrixR(1e-4, 1e-4, 1e-4, 1e-3);
+    restart(Eigen::Matrix<double, 4, 1>::Zero());
+    update_num_ = 0;
+}
+
+AntitopV4::AntitopV4(double r_min, double r_max) : AntitopV4() {
+    r_min_ = r_min;
+    r_max_ = r_max;
+}
+
+void AntitopV4::push(const Eigen::Matrix<double, 4, 1>& pose, TimePoint t) {
+    double dt = getDoubleOfS(t_, t);
+    t_ = t;
+
+    if ((update_num_ == 0) || (dt > fire_delay_)) {
+        restart(pose);
+        update_num_ = 1;
+        return;
+    }
+    update_num_++;
+
+    funcA_.dt = dt;
+    Eigen::Array<double, ANTITOP_HYPO_NUM_V4, 1> log_likelihood;
+    for (int i = 0; i < ANTITOP_HYPO_NUM_V4; i++) {
+        log_likelihood[i] = step(i, pose);
+    }
+
+    // 对数似然带遗忘累加, 目标切换运动状态后旧观测的影响逐渐衰减
+    score_ = forget_ * score_ + log_likelihood;
+    score_ -= score_.maxCoeff();
+    mu_ = score_.exp();
+    mu_ /= mu_.sum();
+
+    // 超过阈值才切换假设, 避免两个假设接近时输出来回跳变
+    int index;
+    score_.maxCoeff(&index);
+    if (score_[index] - score_[best_] > switch_margin_) best_ = index;
+
+    rm::message("antitop count", (int)update_num_);
+    rm::message("antitop armor", armor_num_[best_]);
+    rm::message("antitop toggle", toggle_[best_]);
+}
+
+double AntitopV4::step(int index, const Eigen::Matrix<double, 4, 1>& pose) {
+    AntitopV4_Model& model = model_[index];
+    model.predict(funcA_);
+
+    // 预测角度按整块装甲板平移到观测附近, 观测到的可能是另一块装甲板
+    int shift;
+    model.predict_X[3] = getAngleAlign(model.predict_X[3], pose[3], armor_num_[index], shift);
+
+    // 四装甲板两组装甲板的半径和高度不同, 切换到另一组时交换
+    if ((armor_num_[index] == 4) && (shift & 1)) {
+        r_(index, toggle_[index]) = model.predict_X[8];
+        z_(index, toggle_[index]) = model.predict_X[2];
+        toggle_[index] ^= 1;
+        model.predict_X[8] = r_(index, toggle_[index]);
+        model.predict_X[2] = z_(index, toggle_[index]);
+
+        // 换入的半径和高度与当前中心、角度的估计无关, 去掉协方差中的相关项
+        Eigen::Matrix<double, 9, 9> P = model.P;
+        for (int k : {2, 8}) {
+            double var = P(k, k);
+            P.row(k).setZero();
+            P.col(k).setZero();
+            P(k, k) = var;
+        }
+#ifdef OPENRM_SQRT_KALMAN
+        model.setP(P);
+#else
+        model.P = P;
+#endif
+    }
+
+    Eigen::Matrix<double, 4, 1> predict_Y;
+    Eigen::Matrix<double, 4, 9> H;
+    funcH_(model.predict_X.data(), predict_Y.data());
+    funcH_.jacobian(model.predict_X.data(), H);
+
+    Eigen::Matrix<double, 4, 4> S = H * model.P * H.transpose() + model.R;
+    Eigen::LDLT<Eigen::Matrix<double, 4, 4>> ldlt(S);
+    Eigen::Matrix<double, 4, 1> e = pose - predict_Y;
+    double log_det = ldlt.vectorD().array().log().sum();
+    double log_likelihood = -0.5 * (e.dot(ldlt.solve(e)) + log_det + 4 * log(2 * M_PI));
+
+    model.update(funcH_, pose);
+    model.estimate_X[8] = std::clamp(model.estimate_X[8], r_min_, r_max_);
+    r_(index, toggle_[index]) = model.estimate_X[8];
+    z_(index, toggle_[index]) = model.estimate_X[2];
+
+    return std::isfinite(log_likelihood) ? log_likelihood : -1e6;
+}
+
+void AntitopV4::restart(const Eigen::Matrix<double, 4, 1>& pose) {
+    for (int i = 0; i < ANTITOP_HYPO_NUM_V4; i++) {
+        double r = r_init_[i % ANTITOP_RADIUS_HYPO_V4];
+
+        Eigen::Matrix<double, 9, 1> X = Eigen::Matrix<double, 9, 1>::Zero();
+        X[0] = pose[0] + r * cos(pose[3]);
+        X[1] = pose[1] + r * sin(pose[3]);
+        X[2] = pose[2];
+        X[3] = pose[3];
+        X[8] = r;
+
+        model_[i].restart();
+        model_[i].estimate_X = X;
+        armor_num_[i] = armor_num_hypo[i / ANTITOP_RADIUS_HYPO_V4];
+        r_.row(i).setConstant(r);
+        z_.row(i).setConstant(pose[2]);
+    }
+    toggle_.setZero();
+    score_.setZero();
+    mu_.setConstant(1.0 / ANTITOP_HYPO_NUM_V4);
+    best_ = 0;
+}
+
+Eigen::Matrix<double, 4, 1> AntitopV4::getPose(double append_delay) {
+    auto now = getTime();
+    double sys_delay = getDoubleOfS(t_, now);
+
+    if ((update_num_ == 0) || (sys_delay > fire_delay_)) {
+        return Eigen::Matrix<double, 4, 1>::Zero();
+    }
+    double dt = sys_delay + append_delay;
+    const auto& X = model_[best_].estimate_X;
+
+    double x_center = X[0] + X[4] * dt;
+    double y_center = X[1] + X[5] * dt;
+    double theta = X[3] + X[7] * dt;
+
+    // 选择正对中心连线的装甲板
+    int shift;
+    theta = getAngleAlign(theta, atan2(y_center, x_center), armor_num_[best_], shift);
+    int toggle = (armor_num_[best_] == 4) ? (toggle_[best_] ^ (shift & 1)) : 0;
+
+    double r = r_(best_, toggle);
+    double z = z_(best_, toggle);
+    double x = x_center - r * cos(theta);
+    double y = y_center - r * sin(theta);
+
+    return Eigen::Matrix<double, 4, 1>(x, y, z, theta);
+}
+
+Eigen::Matrix<double, 4, 1> AntitopV4::getCenter(double append_delay) {
+    auto now = getTime();
+    double sys_delay = getDoubleOfS(t_, now);
+
+    if ((update_num_ == 0) || (sys_delay > fire_delay_)) {
+        return Eigen::Matrix<double, 4, 1>::Zero();
+    }
+    double dt = sys_delay + append_delay;
+    const auto& X = model_[best_].estimate_X;
+
+    double x_center = X[0] + X[4] * dt;
+    double y_center = X[1] + X[5] * dt;
+    double theta = X[3] + X[7] * dt;
+
+    int shift;
+    theta = getAngleAlign(theta, atan2(y_center, x_center), armor_num_[best_], shift);
+    int toggle = (armor_num_[best_] == 4) ? (toggle_[best_] ^ (shift & 1)) : 0;
+
+    double r = r_(best_, toggle);
+    double z = z_(best_, toggle);
+    double target_yaw = atan2(y_center, x_center);
+    double x = x_center - r * cos(target_yaw);
+    double y = y_center - r * sin(target_yaw);
+
+    return Eigen::Matrix<double, 4, 1>(x, y, z, theta);
+}
+
+double AntitopV4::getProbability(int armor_num) {
+    return (armor_num_ == armor_num).select(mu_, 0.0).sum();
+}
+
+double AntitopV4::getSafeSub(const double angle1, const double angle2) {
+    double angle = angle1 - angle2;
+    while(angle > M_PI) angle -= 2 * M_PI;
+    while(angle < -M_PI) angle += 2 * M_PI;
+    return angle;
+}
+
+double AntitopV4::getAngleAlign(double angle, double target, int armor_num, int& shift) {
+    double step = 2 * M_PI / armor_num;
+    shift = (int)round((target - angle) / step);
+    return angle + step * shift;
+}
+
+void AntitopV4::getStateStr(std::vector<std::string>& str) {
+    str.push_back("AntitopV4");
+    str.push_back("  update num: " + to_string(update_num_));
+    str.push_back("  armor num: " + to_string(armor_num_[best_]));
+    str.push_back("  toggle: " + to_string(toggle_[best_]));
+    str.push_back("  radius: " + to_string(r_(best_, 0)) + " " + to_string(r_(best_, 1)));
+    str.push_back("  omega: " + to_string(model_[best_].estimate_X[7]));
+    for (int i = 0; i < ANTITOP_ARMOR_HYPO_V4; i++) {
+        str.push_back("  p" + to_string(armor_num_hypo[i]) + ": " + to_string(getProbability(armor_num_hypo[i])));
+    }
+    str.push_back(" ");
+}
+
+bool AntitopV4::getFireArmor(const Eigen::Matrix<double, 4, 1>& pose) {
+    double angle = getSafeSub(atan2(pose[1], pose[0]), pose[3]);
+    if ((fabs(angle) < fire_armor_angle_) && (update_num_ > fire_update_)) return true;
+    return false;
+}
+
+bool AntitopV4::getFireCenter(const Eigen::Matrix<double, 4, 1>& pose) {
+    double angle = getSafeSub(atan2(pose[1], pose[0]), pose[3]);
+    if ((fabs(angle) < fire_center_angle_) && (update_num_ > fire_update_)) return true;
+    return false;
+}
+
+void AntitopV4::setMatrixQ(double q0, double q1, double q2, double q3, double q4, double q5, double q6, double q7, double q8) {
+    for (int i = 0; i < ANTITOP_HYPO_NUM_V4; i++) {
+        model_[i].Q << q0, 0, 0, 0, 0, 0, 0, 0, 0,
+                       0, q1, 0, 0, 0, 0, 0, 0, 0,
+                       0, 0, q2, 0, 0, 0, 0, 0, 0,
+                       0, 0, 0, q3, 0, 0, 0, 0, 0,
+                       0, 0, 0, 0, q4, 0, 0, 0, 0,
+                       0, 0, 0, 0, 0, q5, 0, 0, 0,
+                       0, 0, 0, 0, 0, 0, q6, 0, 0,
+                       0, 0, 0, 0, 0, 0, 0, q7, 0,
+                       0, 0, 0, 0, 0, 0, 0, 0, q8;
+    }
+}
+
+void AntitopV4::setMatrixR(double r0, double r1, double r2, double r3) {
+    for (int i = 0; i < ANTITOP_HYPO_NUM_V4; i++) {
+        model_[i].R << r0, 0, 0, 0,
+                       0, r1, 0, 0,
+                       0, 0, r2, 0,
+                       0, 0, 0, r3;
+    }
+}
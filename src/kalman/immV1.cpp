@@ -0,0 +1,240 @@
+#include "kalman/interface/immV1.h"
+#include "utils/print.h"
+#include "uniterm/uniterm.h"
+#include <cmath>
+using namespace std;
+using namespace rm;
+
+// [ x, y, z, theta, vx, vy, vz, omega, r ]  [ x, y, z, theta ]
+// [ 0, 1, 2,   3,   4,  5,  6,    7,   8 ]  [ 0, 1, 2,   3   ]
+
+IMMV1::IMMV1() {
+    t_ = getTime();
+    setMatrixQ(IMM_TRANSLATE_V1, 1e-4, 1e-4, 1e-4, 1e-4, 0.01, 0.01, 1e-4, 1e-4, 1e-6);
+    setMatrixQ(IMM_SPIN_V1, 1e-4, 1e-4, 1e-4, 1e-4, 0.01, 0.01, 1e-4, 0.04, 1e-5);
+    setMatrixQ(IMM_OUTPOST_V1, 1e-5, 1e-5, 1e-5, 1e-4, 1e-6, 1e-6, 1e-6, 1e-6, 1e-6);
+    setMatrixR(1e-4, 1e-4, 1e-4, 1e-3);
+    setTransition(0.95);
+    restart(Eigen::Matrix<double, 4, 1>::Zero());
+    update_num_ = 0;
+}
+
+IMMV1::IMMV1(int armor_num, double r_init) : IMMV1() {
+    armor_num_ = armor_num;
+    r_init_ = r_init;
+}
+
+void IMMV1::push(const Eigen::Matrix<double, 4, 1>& pose, TimePoint t) {
+    double dt = getDoubleOfS(t_, t);
+    t_ = t;
+
+    if ((update_num_ == 0) || (dt > delay_)) {
+        restart(pose);
+        update_num_ = 1;
+        return;
+    }
+    update_num_++;
+
+    mix();
+
+    translate_funcA_.dt = dt;
+    spin_funcA_.dt = dt;
+    outpost_funcA_.dt = dt;
+
+    // 各模型似然取对数，避免新息较大时指数下溢
+    Eigen::Matrix<double, 3, 1> log_mu;
+    Eigen::Matrix<double, 3, 1> c = transition_.transpose() * mu_;
+    log_mu[IMM_TRANSLATE_V1] = step(IMM_TRANSLATE_V1, translate_funcA_, pose);
+    log_mu[IMM_SPIN_V1] = step(IMM_SPIN_V1, spin_funcA_, pose);
+    log_mu[IMM_OUTPOST_V1] = step(IMM_OUTPOST_V1, outpost_funcA_, pose);
+    for (int i = 0; i < IMM_MODEL_NUM_V1; i++) {
+        log_mu[i] += log(std::max(c[i], 1e-300));
+    }
+    double log_max = log_mu.maxCoeff();
+    for (int i = 0; i < IMM_MODEL_NUM_V1; i++) {
+        mu_[i] = exp(log_mu[i] - log_max);
+    }
+    mu_ /= mu_.sum();
+
+    // 按模型概率合并输出
+    estimate_X_.setZero();
+    for (int i = 0; i < IMM_MODEL_NUM_V1; i++) {
+        estimate_X_ += mu_[i] * model_[i].estimate_X;
+    }
+    P_.setZero();
+    for (int i = 0; i < IMM_MODEL_NUM_V1; i++) {
+        Eigen::Matrix<double, 9, 1> dx = model_[i].estimate_X - estimate_X_;
+        P_ += mu_[i] * (model_[i].P + dx * dx.transpose());
+    }
+
+    rm::message("imm translate", mu_[IMM_TRANSLATE_V1]);
+    rm::message("imm spin", mu_[IMM_SPIN_V1]);
+    rm::message("imm outpost", mu_[IMM_OUTPOST_V1]);
+}
+
+template<class Func>
+double IMMV1::step(int index, Func& funcA, const Eigen::Matrix<double, 4, 1>& pose) {
+    IMMV1_Model& model = model_[index];
+    model.predict(funcA);
+
+    // 预测角度按整块装甲板平移到观测附近，观测到的可能是另一块装甲板
+    model.predict_X[3] = getAngleAlign(model.predict_X[3], pose[3], getArmorNum(index));
+
+    Eigen::Matrix<double, 4, 1> predict_Y;
+    Eigen::Matrix<double, 4, 9> H;
+    funcH_(model.predict_X.data(), predict_Y.data());
+    funcH_.jacobian(model.predict_X.data(), H);
+
+    Eigen::Matrix<double, 4, 4> S = H * model.P * H.transpose() + model.R;
+    Eigen::LDLT<Eigen::Matrix<double, 4, 4>> ldlt(S);
+    Eigen::Matrix<double, 4, 1> e = pose - predict_Y;
+    double log_det = ldlt.vectorD().array().log().sum();
+    double log_likelihood = -0.5 * (e.dot(ldlt.solve(e)) + log_det + 4 * log(2 * M_PI));
+
+    model.update(funcH_, pose);
+    return log_likelihood;
+}
+
+void IMMV1::mix() {
+    // c_j = sum_i p(j | i) * mu_i，mu_{i|j} = p(j | i) * mu_i / c_j
+    Eigen::Matrix<double, 3, 1> c = transition_.transpose() * mu_;
+
+    Eigen::Matrix<double, 9, 1> X[IMM_MODEL_NUM_V1];
+    Eigen::Matrix<double, 9, 9> P[IMM_MODEL_NUM_V1];
+    for (int j = 0; j < IMM_MODEL_NUM_V1; j++) {
+        X[j].setZero();
+        P[j].setZero();
+        if (c[j] < 1e-300) {
+            X[j] = model_[j].estimate_X;
+            P[j] = model_[j].P;
+            continue;
+        }
+        for (int i = 0; i < IMM_MODEL_NUM_V1; i++) {
+            X[j] += (transition_(i, j) * mu_[i] / c[j]) * model_[i].estimate_X;
+        }
+        for (int i = 0; i < IMM_MODEL_NUM_V1; i++) {
+            Eigen::Matrix<double, 9, 1> dx = model_[i].estimate_X - X[j];
+            P[j] += (transition_(i, j) * mu_[i] / c[j]) * (model_[i].P + dx * dx.transpose());
+        }
+    }
+    for (int j = 0; j < IMM_MODEL_NUM_V1; j++) {
+        model_[j].estimate_X = X[j];
+        model_[j].P = P[j];
+    }
+}
+
+void IMMV1::restart(const Eigen::Matrix<double, 4, 1>& pose) {
+    Eigen::Matrix<double, 9, 1> X = Eigen::Matrix<double, 9, 1>::Zero();
+    X[0] = pose[0] + r_init_ * cos(pose[3]);
+    X[1] = pose[1] + r_init_ * sin(pose[3]);
+    X[2] = pose[2];
+    X[3] = pose[3];
+    X[8] = r_init_;
+
+    for (int i = 0; i < IMM_MODEL_NUM_V1; i++) {
+        model_[i].restart();
+        model_[i].estimate_X = X;
+    }
+    mu_.setConstant(1.0 / IMM_MODEL_NUM_V1);
+    estimate_X_ = X;
+    P_ = model_[0].P;
+}
+
+Eigen::Matrix<double, 4, 1> IMMV1::getPose(double append_delay) {
+    auto now = getTime();
+    double sys_delay = getDoubleOfS(t_, now);
+
+    if ((update_num_ == 0) || (sys_delay > delay_)) {
+        return Eigen::Matrix<double, 4, 1>::Zero();
+    }
+    double dt = sys_delay + append_delay;
+
+    double x_center = estimate_X_[0] + estimate_X_[4] * dt;
+    double y_center = estimate_X_[1] + estimate_X_[5] * dt;
+    double z = estimate_X_[2] + estimate_X_[6] * dt;
+    double theta = estimate_X_[3] + estimate_X_[7] * dt;
+
+    // 选择正对中心连线的装甲板
+    theta = getAngleAlign(theta, atan2(y_center, x_center), getArmorNum(getModelIndex()));
+    double r = estimate_X_[8];
+    double x = x_center - r * cos(theta);
+    double y = y_center - r * sin(theta);
+
+    return Eigen::Matrix<double, 4, 1>(x, y, z, theta);
+}
+
+Eigen::Matrix<double, 4, 1> IMMV1::getCenter(double append_delay) {
+    auto now = getTime();
+    double sys_delay = getDoubleOfS(t_, now);
+
+    if ((update_num_ == 0) || (sys_delay > delay_)) {
+        return Eigen::Matrix<double, 4, 1>::Zero();
+    }
+    double dt = sys_delay + append_delay;
+
+    double x_center = estimate_X_[0] + estimate_X_[4] * dt;
+    double y_center = estimate_X_[1] + estimate_X_[5] * dt;
+    double z = estimate_X_[2] + estimate_X_[6] * dt;
+    double theta = estimate_X_[3] + estimate_X_[7] * dt;
+    theta = getAngleAlign(theta, atan2(y_center, x_center), getArmorNum(getModelIndex()));
+
+    double r = estimate_X_[8];
+    double target_yaw = atan2(y_center, x_center);
+    double x = x_center - r * cos(target_yaw);
+    double y = y_center - r * sin(target_yaw);
+
+    return Eigen::Matrix<double, 4, 1>(x, y, z, theta);
+}
+
+void IMMV1::setMatrixQ(int index, double q0, double q1, double q2, double q3, double q4, double q5, double q6, double q7, double q8) {
+    model_[index].Q << q0, 0, 0, 0, 0, 0, 0, 0, 0,
+                       0, q1, 0, 0, 0, 0, 0, 0, 0,
+                       0, 0, q2, 0, 0, 0, 0, 0, 0,
+                       0, 0, 0, q3, 0, 0, 0, 0, 0,
+                       0, 0, 0, 0, q4, 0, 0, 0, 0,
+                       0, 0, 0, 0, 0, q5, 0, 0, 0,
+                       0, 0, 0, 0, 0, 0, q6, 0, 0,
+                       0, 0, 0, 0, 0, 0, 0, q7, 0,
+                       0, 0, 0, 0, 0, 0, 0, 0, q8;
+}
+
+void IMMV1::setMatrixR(double r0, double r1, double r2, double r3) {
+    for (int i = 0; i < IMM_MODEL_NUM_V1; i++) {
+        model_[i].R << r0, 0, 0, 0,
+                       0, r1, 0, 0,
+                       0, 0, r2, 0,
+                       0, 0, 0, r3;
+    }
+}
+
+void IMMV1::setTransition(double p_stay) {
+    double p_switch = (1.0 - p_stay) / (IMM_MODEL_NUM_V1 - 1);
+    transition_.setConstant(p_switch);
+    transition_.diagonal().setConstant(p_stay);
+}
+
+int IMMV1::getModelIndex() {
+    int index;
+    mu_.maxCoeff(&index);
+    return index;
+}
+
+int IMMV1::getArmorNum(int index) {
+    if (index == IMM_OUTPOST_V1) return 3;
+    return armor_num_;
+}
+
+double IMMV1::getAngleAlign(double angle, double target, int armor_num) {
+    double step = 2 * M_PI / armor_num;
+    return angle + step * round((target - angle) / step);
+}
+
+void IMMV1::getStateStr(std::vector<std::string>& str) {
+    str.push_back("IMMV1");
+    str.push_back("  update num: " + to_string(update_num_));
+    str.push_back("  translate: " + to_string(mu_[IMM_TRANSLATE_V1]));
+    str.push_back("  spin: " + to_string(mu_[IMM_SPIN_V1]));
+    str.push_back("  outpost: " + to_string(mu_[IMM_OUTPOST_V1]));
+    str.push_back("  omega: " + to_string(estimate_X_[7]));
+    str.push_back(" ");
+}
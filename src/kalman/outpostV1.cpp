@@ -148,7 +148,9 @@ double OutpostV1::getAngleTrans(const double target_angle, const double src_angl
 
 double OutpostV1::getAngleMin(double armor_angle, const double x, const double y) {
     double center_angle = atan2(y, x);
-    return getAngleTrans(center_angle, armor_angle);
+    // getAngleTrans 不归一化, 预测角超过半圈后会差 2pi 的整数倍, 这里取紧邻中心连线的一支, 与 getTrajectory 一致
+    double angle = getAngleTrans(center_angle, armor_angle);
+    return center_angle + getSafeSub(angle, center_angle);
 }
 
 int OutpostV1::getToggle(const double target_angle, const double src_angle) {
@@ -15,37 +15,42 @@ OutpostV2::OutpostV2() {
     t_ = getTime();
     setMatrixQ(0.01, 0.01, 0.01, 0.02, 0.05, 0.05, 0.05, 0.04);
     setMatrixR(0.1, 0.1, 0.1, 0.2);
+    setMatrixOmegaQ(0.0001, 0.00001);
+    setMatrixOmegaR(0.0025);
     setFireValue(0, 0.1, 0.1, 0.1);
     omega_ = SlideAvg<double>(500);
 }
 
 void OutpostV2::push(const Eigen::Matrix<double, 4, 1>& pose, TimePoint t) {
+    if (record_flag_) record_.push_back({getDoubleOfS(record_t0_, t), pose});
+
     double dt = getDoubleOfS(t_, t);
     if(dt > fire_delay_) {
         update_num_ = 0;
         model_.restart();
+        omega_model_.restart();
         omega_.clear();
     }
     update_num_++;
     t_ = t;
-    
-    toggle_ = getToggle(pose[3], model_.estimate_X[3]);
-    if (isAngleTrans(pose[3], omega_model_.estimate_X[3])) {
-        model_.estimate_X[3] = pose[3];
-        omega_model_.estimate_X[0] = pose[3];
-        return;
-    }
-
-    model_.estimate_X[3] = getAngleTrans(pose[3], model_.estimate_X[3]);
-    omega_model_.estimate_X[0] = getAngleTrans(pose[3], omega_model_.estimate_X[0]);
 
+    // 三块装甲板相差 2pi/3, 角速度模型只跟踪相位, 预测后平移整数个 2pi/3 贴近观测, 切换装甲板时不丢失相位
     Eigen::Matrix<double, 1, 1> pose_theta(pose[3]);
     omega_funcA_.dt = dt;
     omega_model_.predict(omega_funcA_);
+    omega_model_.predict_X[0] = getAngleTrans(pose[3], omega_model_.predict_X[0]);
     omega_model_.update(omega_funcH_, pose_theta);
 
     omega_.push(omega_model_.estimate_X[1]);
 
+    toggle_ = getToggle(pose[3], model_.estimate_X[3], toggle_);
+    if (isAngleTrans(pose[3], model_.estimate_X[3])) {
+        model_.estimate_X[3] = pose[3];
+        return;
+    }
+
+    model_.estimate_X[3] = getAngleTrans(pose[3], model_.estimate_X[3]);
+
     funcA_.dt = dt;
     model_.predict(funcA_);
     model_.update(funcH_, pose);
@@ -55,6 +60,15 @@ void OutpostV2::push(const Eigen::Matrix<double, 4, 1>& pose, TimePoint t) {
     rm::message("antitop toggle", toggle_);
 }
 
+void OutpostV2::setRecord(bool record) {
+    // 开始记录时清空旧记录，停止记录后仍可保存
+    if (record && !record_flag_) {
+        record_.clear();
+        record_t0_ = getTime();
+    }
+    record_flag_ = record;
+}
+
 Eigen::Matrix<double, 4, 1> OutpostV2::getPose(double append_delay) {
     auto now = getTime();
     double sys_delay = getDoubleOfS(t_, now);
@@ -125,15 +139,15 @@ double OutpostV2::getAngleTrans(const double target_angle, const double src_angl
 
 double OutpostV2::getAngleMin(double armor_angle, const double x, const double y) {
     double center_angle = atan2(y, x);
-    return getAngleTrans(center_angle, armor_angle);
+    // getAngleTrans 不归一化, 预测角超过半圈后会差 2pi 的整数倍, 这里取紧邻中心连线的一支, 与 getTrajectory 一致
+    double angle = getAngleTrans(center_angle, armor_angle);
+    return center_angle + getSafeSub(angle, center_angle);
 }
 
-int OutpostV2::getToggle(const double target_angle, const double src_angle) {
+int OutpostV2::getToggle(const double target_angle, const double src_angle, int toggle) {
     double differ_angle = fabs(target_angle - src_angle);
     int differ_toggle = static_cast<int>(round(differ_angle / (2 * M_PI / 3)));
-    toggle_ = (toggle_ + differ_toggle) % 3;
-
-    return toggle_;
+    return (toggle + differ_toggle) % 3;
 }
 
 void OutpostV2::getStateStr(std::vector<std::string>& str) {
@@ -141,6 +155,7 @@ void OutpostV2::getStateStr(std::vector<std::string>& str) {
     str.push_back("  toggle: " + to_string(toggle_));
     str.push_back("  update num: " + to_string(update_num_));
     str.push_back("  omega: " + to_string(model_.estimate_X[7]));
+    str.push_back("  phase omega: " + to_string(getPhaseOmega()));
     str.push_back(" ");
 }
 
@@ -162,6 +177,71 @@ bool OutpostV2::getFireCenter(const Eigen::Matrix<double, 4, 1>& pose) {
     return false;
 }
 
+bool OutpostV2::isPhaseLocked() {
+    double sys_delay = getDoubleOfS(t_, getTime());
+    double omega = fabs(omega_model_.estimate_X[1]);
+
+    if (sys_delay > fire_delay_) return false;
+    if (update_num_ <= fire_update_) return false;
+    if ((omega < OUTPOST_OMEGA_V2 * 0.5) || (omega > OUTPOST_OMEGA_V2 * 1.5)) return false;
+    return true;
+}
+
+double OutpostV2::getPhaseOmega() {
+    // 转速由规则固定, 滤波得到的角速度只允许在标称值附近小幅修正相位漂移
+    double omega = omega_model_.estimate_X[1];
+    double nominal = (omega > 0) ? OUTPOST_OMEGA_V2 : -OUTPOST_OMEGA_V2;
+    double bound = OUTPOST_OMEGA_V2 * OUTPOST_OMEGA_LOCK_V2;
+    return std::clamp(omega, nominal - bound, nominal + bound);
+}
+
+static TimePoint getTimeAfter(const TimePoint& t, double s) {
+    return t + std::chrono::duration_cast<TimePoint::duration>(Duration_s(s));
+}
+
+bool OutpostV2::getFireWindows(std::vector<OutpostFireWindow>& windows, double fly_delay, int num, bool aim_center) {
+    windows.clear();
+    if (!isPhaseLocked()) return false;
+
+    auto now = getTime();
+    double sys_delay = getDoubleOfS(t_, now);
+    double omega = getPhaseOmega();
+    double fire_angle = aim_center ? fire_angle_center_ : fire_angle_armor_;
+
+    // 命中时刻装甲板相位与中心连线方向相差 2pi/3 的整数倍即正对
+    double dt = sys_delay + fly_delay;
+    double x_center = model_.estimate_X[0] + model_.estimate_X[4] * dt;
+    double y_center = model_.estimate_X[1] + model_.estimate_X[5] * dt;
+    double center_angle = atan2(y_center, x_center);
+    double theta = omega_model_.estimate_X[0] + omega * dt;
+
+    // 从现在起开火的相对时间, 取第一个尚未结束的窗口, 之后每隔一个周期一个窗口
+    double period = (2 * M_PI / 3) / fabs(omega);
+    double half = fire_angle / fabs(omega);
+    double best = getSafeSub(center_angle, theta) / omega;
+    best -= period * floor((best + half) / period);
+
+    for (int i = 0; i < num; i++) {
+        double s = best + i * period;
+        OutpostFireWindow window;
+        window.start = getTimeAfter(now, std::max(s - half, 0.0));
+        window.end = getTimeAfter(now, s + half);
+        window.best = getTimeAfter(now, s);
+        windows.push_back(window);
+    }
+    return true;
+}
+
+bool OutpostV2::getFireTime(TimePoint& t, double fly_delay, bool aim_center) {
+    std::vector<OutpostFireWindow> windows;
+    if (!getFireWindows(windows, fly_delay, 1, aim_center)) return false;
+
+    // 当前窗口的最佳时刻已过时仍在窗口内, 立即开火
+    auto now = getTime();
+    t = (windows[0].best < now) ? now : windows[0].best;
+    return true;
+}
+
 bool OutpostV2::isAngleTrans(const double target_angle, const double src_angle) {
     double differ_angle = fabs(getSafeSub(target_angle, src_angle));
     if (differ_angle > (M_PI / 3)) return true;
@@ -18,6 +18,7 @@ using namespace rm;
 RuneV2::RuneV2() {
     t_ = getTime();
     t_trans_ = getTime();
+    t_start_ = getTime();
     setSmallMatrixQ(0.01, 0.01, 0.01, 0.01, 1e-3, 1e-3);
     setSmallMatrixR(1, 1, 1, 1, 1);
     setBigMatrixQ(0.01, 0.01, 0.01, 0.01, 0.01, 0.1, 0.1, 0.1);
@@ -29,6 +30,7 @@ RuneV2::RuneV2() {
     center_z_ = SlideAvg<double>(500);
     theta_ = SlideAvg<double>(1000);
     spd_ = SlideAvg<double>(500);
+    fit_.setBound(A_MIN, A_MAX, W_MIN, W_MAX, B_BASE);
 }
 
 void RuneV2::push(const Eigen::Matrix<double, 5, 1>& pose, TimePoint t) {
@@ -43,9 +45,13 @@ void RuneV2::push(const Eigen::Matrix<double, 5, 1>& pose, TimePoint t) {
         big_model_.restart();
         small_model_.restart();
         spd_model_.restart();
+        fit_.clear();
+        fit_frames_ = -1;
+        t_start_ = t;
     }
     update_num_++;
     t_ = t;
+    fit_.push(getDoubleOfS(t_start_, t), pose[4]);
     
 
     // 符的不同符叶转换
@@ -90,6 +96,7 @@ void RuneV2::push(const Eigen::Matrix<double, 5, 1>& pose, TimePoint t) {
 
     big_model_.predict(big_funcA_);
     big_model_.update(big_funcH_, pose);
+    if (is_big_rune_) fitBigRune();
 
 
     // 滑动窗口更新
@@ -175,6 +182,30 @@ Eigen::Matrix<double, 4, 1> RuneV2::getPose(double append_delay) {
     return pose;
 }
 
+void RuneV2::fitBigRune() {
+    if ((fit_interval_ <= 0) || (update_num_ % fit_interval_ != 0)) return;
+
+    // 滑动窗口拟合 a / w / p，结果直接写入大符模型，跳过 EKF 在 sin(p) 上的缓慢收敛
+    RuneFitResult result;
+    TimePoint t_begin = getTime();
+    bool valid = fit_.fit(big_funcA_.sign, result);
+    rm::message("rune fit us", (double)getNumOfUs(t_begin, getTime()));
+    rm::message("rune fit rms", result.rms);
+    if (!valid) return;
+
+    big_model_.estimate_X[5] = result.p;
+    big_model_.estimate_X[6] = result.a;
+    big_model_.estimate_X[7] = result.w;
+    for (int i = 5; i < 8; i++) {
+        big_model_.P.row(i).setZero();
+        big_model_.P.col(i).setZero();
+        big_model_.P(i, i) = 1e-3;
+    }
+
+    if (fit_frames_ < 0) fit_frames_ = update_num_;
+    rm::message("rune fit frames", fit_frames_);
+}
+
 void RuneV2::getStateStr(std::vector<std::string>& str) {
     str.push_back("RuneV2");
     str.push_back(" ");
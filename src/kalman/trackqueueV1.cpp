@@ -13,10 +13,6 @@ using namespace std;
 // [ 0, 1, 2,   3,   4,  5 ]  [ 0, 1, 2,   3  ]
 
 TrackQueueV1::TrackQueueV1() {
-    list_.resize(4);
-    for(int i = 0; i < list_.size(); i++) {
-        list_[i] = TQstateV1();
-    }
     setMatrixQ(0.2, 0.2, 0.1, 0.01, 1.0, 1.0);
     setMatrixR(0.001, 0.001, 0.1, 0.1);
 }
@@ -28,114 +24,71 @@ TrackQueueV1::TrackQueueV1(int min_count, double max_distance, double max_delay,
     toggle_angle_offset_(toggle_angle),
     max_std_(max_std) {
 
-    list_.resize(4);
-    for(int i = 0; i < list_.size(); i++) {
-        list_[i] = TQstateV1();
-    }
-
     setMatrixQ(0.2, 0.2, 0.1, 0.01, 1.0, 1.0);
     setMatrixR(0.001, 0.001, 0.1, 0.1);
 }
 
 void TrackQueueV1::push(Eigen::Matrix<double, 4, 1>& pose, TimePoint t) {
+    list_.eraseIf([&](const TQstateV1& state) {
+        return !isDelayValid(state.last_t, t) || !isCountKeepValid(state.count);
+    });
+
     double min_distance = 10000.0;
-    int min_index = -1;
-    int first_empty = -1;
+    TQstateV1* best_state = nullptr;
 
     // 先更新所有目标，查找最佳预测目标
-    for(int i = 0; i < list_.size(); i++) {
-        if (!list_[i].exist) {
-            if(first_empty == -1) {
-                first_empty = i;
-            }
-            continue;
-        }
-        if (!isDelayValid(list_[i].last_t, t) || list_[i].count < 0) {
-            list_[i].clear();
-            if(last_index_ == i) {
-                last_index_ = -1;
-            }
-            continue;
-        }
+    for(auto it = list_.begin(); it != list_.end(); ++it) {
 
         // 把所有的目标lose都减一
-        list_[i].count--;
+        it->count--;
 
-        double d = getDistance(pose, list_[i].last_pose);
+        double d = getDistance(pose, it->last_pose);
         if (d < min_distance) {
             min_distance = d;
-            min_index = i;
+            best_state = &(*it);
         }
     }
 
     // 找到了最佳预测目标
-    if(min_index != -1 && isDistanceValid(min_distance)) {
-        double dt = getDoubleOfS(list_[min_index].last_t, t);
-        list_[min_index].update(pose, t);
-
-        funcA_.dt = dt;
-        list_[min_index].model->predict(funcA_);
-        list_[min_index].model->update(funcH_, pose);
-        
-        double v = sqrt(list_[min_index].model->estimate_X[4] * list_[min_index].model->estimate_X[4] + 
-                        list_[min_index].model->estimate_X[5] * list_[min_index].model->estimate_X[5]);
-        list_[min_index].v_std->push(v);
+    if(best_state != nullptr && isDistanceValid(min_distance)) {
+        funcA_.dt = getDoubleOfS(best_state->last_t, t);
 
-        return;
-
-    // 没有找到最佳预测目标
+    // 没有找到最佳预测目标，从目标池中新建一个目标，池满时丢弃
     } else {
-        // 有空目标，使用空目标
-        if(first_empty != -1) {
-            list_[first_empty].update(pose, t);
-            
-            list_[first_empty].model->restart();
-            funcA_.dt = 0.0;
-            list_[first_empty].model->predict(funcA_);
-            list_[first_empty].model->update(funcH_, pose);
-
-            double v = sqrt(list_[first_empty].model->estimate_X[4] * list_[first_empty].model->estimate_X[4] + 
-                            list_[first_empty].model->estimate_X[5] * list_[first_empty].model->estimate_X[5]);
-            list_[first_empty].v_std->push(v);
-
-            return;
-
-        // 没有空目标，新建一个目标
-        } else {
-            list_.push_back(TQstateV1());
-            list_[list_.size() - 1].model->Q = matrixQ_;
-            list_[list_.size() - 1].model->R = matrixR_;
-            list_[list_.size() - 1].update(pose, t);
-
-            list_[list_.size() - 1].model->restart();
-            funcA_.dt = 0.0;
-            list_[list_.size() - 1].model->predict(funcA_);
-            list_[list_.size() - 1].model->update(funcH_, pose);
-
-            double v = sqrt(list_[list_.size() - 1].model->estimate_X[4] * list_[list_.size() - 1].model->estimate_X[4] + 
-                            list_[list_.size() - 1].model->estimate_X[5] * list_[list_.size() - 1].model->estimate_X[5]);
-            list_[list_.size() - 1].v_std->push(v);
-
-            return;
-        }
+        best_state = list_.get(list_.emplace());
+        if(best_state == nullptr) return;
+        best_state->model.Q = matrixQ_;
+        best_state->model.R = matrixR_;
+        funcA_.dt = 0.0;
     }
+
+    best_state->update(pose, t);
+    best_state->model.predict(funcA_);
+    best_state->model.update(funcH_, pose);
+
+    double v = sqrt(best_state->model.estimate_X[4] * best_state->model.estimate_X[4] + 
+                    best_state->model.estimate_X[5] * best_state->model.estimate_X[5]);
+    best_state->v_std.push(v);
 }
 
 void TrackQueueV1::update() {
-    int min_angle_index = getMinAngleOffset();
+    SlotHandle min_angle_handle = getMinAngleOffset();
+    TQstateV1* last_state = list_.get(last_handle_);
+    TQstateV1* min_angle_state = list_.get(min_angle_handle);
 
-    if ((last_index_ == -1) || !list_[last_index_].exist) {
+    if (last_state == nullptr) {
         last_toggle_ = !last_toggle_;
-        last_index_ = min_angle_index;
+        last_handle_ = min_angle_handle;
         return;
     } else if (
-        last_index_ != min_angle_index && 
-        isCountUseValid(list_[min_angle_index].count) &&
+        min_angle_state != nullptr &&
+        last_handle_ != min_angle_handle && 
+        isCountUseValid(min_angle_state->count) &&
         isAngleOffsetValid(
-            getAngleOffset(list_[last_index_].last_pose), 
-            getAngleOffset(list_[min_angle_index].last_pose))
+            getAngleOffset(last_state->last_pose), 
+            getAngleOffset(min_angle_state->last_pose))
     ) {
-        last_index_ = min_angle_index;
+        last_handle_ = min_angle_handle;
         last_toggle_ = !last_toggle_;
         return;
     }
@@ -148,8 +101,8 @@ void TrackQueueV1::setMatrixQ(double q1, double q2, double q3, double q4, double
                 0, 0, 0, q4, 0, 0,
                 0, 0, 0, 0, q5, 0,
                 0, 0, 0, 0, 0, q6;
-    for(int i = 0; i < list_.size(); i++) {
-        list_[i].model->Q = matrixQ_;
+    for(auto it = list_.begin(); it != list_.end(); ++it) {
+        it->model.Q = matrixQ_;
     }
 }
 
@@ -158,73 +111,79 @@ void TrackQueueV1::setMatrixR(double r1, double r2, double r3, double r4) {
                 0, r2, 0, 0,
                 0, 0, r3, 0,
                 0, 0, 0, r4;
-    for(int i = 0; i < list_.size(); i++) {
-        list_[i].model->R = matrixR_;
+    for(auto it = list_.begin(); it != list_.end(); ++it) {
+        it->model.R = matrixR_;
     }
 }
 
 KF<6, 4>* TrackQueueV1::getModel() {
-    if (last_index_ == -1) {
+    TQstateV1* state = list_.get(last_handle_);
+    if (state == nullptr) {
         return nullptr;
     }
-    return list_[last_index_].model;
+    return &state->model;
 }
 
 TimePoint TrackQueueV1::getLastTime() {
-    if ((last_index_ == -1) || !list_[last_index_].exist || !list_[last_index_].available) {
+    TQstateV1* state = list_.get(last_handle_);
+    if ((state == nullptr) || !state->available) {
         return getTime();
     }
-    return list_[last_index_].last_t;
+    return state->last_t;
 }
 
 double TrackQueueV1::getStd() {
-    if ((last_index_ == -1) || !list_[last_index_].exist) {
+    TQstateV1* state = list_.get(last_handle_);
+    if (state == nullptr) {
         return -1;
     }
-    return list_[last_index_].v_std->getStd();
+    return state->v_std.getStd();
 }
 
 bool TrackQueueV1::isStdValid() {
-    if ((last_index_ == -1) || !list_[last_index_].exist) {
+    TQstateV1* state = list_.get(last_handle_);
+    if (state == nullptr) {
         return false;
     }
-    if (list_[last_index_].v_std->getStd() > this->max_std_) {
+    if (state->v_std.getStd() > this->max_std_) {
         return false;
     }
     return true;
 }
 
 Eigen::Matrix<double, 4, 1> TrackQueueV1::getPose() {
-    if ((last_index_ == -1) || !list_[last_index_].exist || !list_[last_index_].available) {
+    TQstateV1* state = list_.get(last_handle_);
+    if ((state == nullptr) || !state->available) {
         return Eigen::Matrix<double, 4, 1>::Zero();
     }
     // rm::print8d(
     //     (double)last_toggle_,
-    //     (double)last_index_,
-    //     list_[last_index_].v_std->getStd(),
+    //     (double)last_handle_.index,
+    //     state->v_std.getStd(),
     //     (double)isStdValid(),
-    //     list_[last_index_].model->estimate_X[0],
-    //     list_[last_index_].model->estimate_X[1],
-    //     list_[last_index_].model->estimate_X[4],
-    //     list_[last_index_].model->estimate_X[5],
+    //     state->model.estimate_X[0],
+    //     state->model.estimate_X[1],
+    //     state->model.estimate_X[4],
+    //     state->model.estimate_X[5],
     //     "toggle", "index", "std", "valid", "x", "y", "vx", "vy"
     // );
 
-    list_[last_index_].available = false;
-    return list_[last_index_].last_pose;
+    state->available = false;
+    return state->last_pose;
 }
 
 Eigen::Matrix<double, 4, 1> TrackQueueV1::getPose(double delay) {
-    if ((last_index_ == -1) || !list_[last_index_].exist) {
+    TQstateV1* state = list_.get(last_handle_);
+    if (state == nullptr) {
         return Eigen::Matrix<double, 4, 1>::Zero();
     }
     TimePoint now = getTime();
-    double dt = getDoubleOfS(list_[last_index_].last_t, now) + delay;
+    double dt = getDoubleOfS(state->last_t, now) + delay;
 
-    double x = list_[last_index_].model->estimate_X[0] + dt * list_[last_index_].model->estimate_X[4];
-    double y = list_[last_index_].model->estimate_X[1] + dt * list_[last_index_].model->estimate_X[5];
-    double z = list_[last_index_].model->estimate_X[2];
-    double theta = list_[last_index_].model->estimate_X[3];
+    double x = state->model.estimate_X[0] + dt * state->model.estimate_X[4];
+    double y = state->model.estimate_X[1] + dt * state->model.estimate_X[5];
+    double z = state->model.estimate_X[2];
+    double theta = state->model.estimate_X[3];
     Eigen::Matrix<double, 4, 1> pose;
     pose << x, y, z, theta;
     return pose;
@@ -241,20 +200,17 @@ double TrackQueueV1::getAngleOffset(const Eigen::Matrix<double, 4, 1>& pose) {
     return abs(angle_offset);
 }
 
-int TrackQueueV1::getMinAngleOffset() {
-    int min_index = -1;
+SlotHandle TrackQueueV1::getMinAngleOffset() {
+    SlotHandle min_handle;
     double min_angle_offset = 10000.0;
-    for(int i = 0; i < list_.size(); i++) {
-        if (!list_[i].exist) {
-            continue;
-        }
+    for(size_t i = 0; i < list_.size(); i++) {
         double angle_offset = getAngleOffset(list_[i].last_pose);
         if (angle_offset < min_angle_offset) {
             min_angle_offset = angle_offset;
-            min_index = i;
+            min_handle = list_.getHandle(i);
         }
     }
-    return min_index;
+    return min_handle;
 }
 
 double TrackQueueV1::getDistance(const Eigen::Matrix<double, 4, 1>& this_pose, const Eigen::Matrix<double, 4, 1>& last_pose) {
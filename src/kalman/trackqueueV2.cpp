@@ -18,45 +18,29 @@ TrackQueueV2::TrackQueueV2(int count, double distance, double delay, double angl
     delay_(delay),
     angle_diff_(angle_diff),
     toggle_angle_(toggle_angle) {
-
-    list_.resize(4);
-    for(int i = 0; i < list_.size(); i++) {
-        list_[i] = TQstateV2();
-    }
-
     setMatrixQ(0.1, 0.1, 0.1, 0.1, 0.1, 0.1, 0.1, 0.1, 0.1, 0.1, 0.1);
     setMatrixR(0.1, 0.1, 0.1, 0.1);
 }
 
 void TrackQueueV2::push(Eigen::Matrix<double, 4, 1>& pose, TimePoint t) {
+    list_.eraseIf([&](const TQstateV2& state) {
+        return (getDoubleOfS(state.last_t, t) > delay_) || (state.keep <= 0);
+    });
+
     double min_distance = 1e4;
-    int min_index = -1;
-    int first_empty = -1;
+    TQstateV2* best_state = nullptr;
 
     // 先更新所有目标，查找最佳预测目标
-    for(int i = 0; i < list_.size(); i++) {
-        if (!list_[i].exist) {
-            if(first_empty == -1) {
-                first_empty = i;
-            }
-            continue;
-        }
-        if ((getDoubleOfS(list_[i].last_t, t) > delay_) || (list_[i].keep <= 0)) {
-            list_[i].clear();
-            if(last_index_ == i) {
-                last_index_ = -1;
-            }
-            continue;
-        }
+    for(auto it = list_.begin(); it != list_.end(); ++it) {
 
         // 把所有的目标keep都减一
-        list_[i].keep--;
+        it->keep--;
 
-        double dt = getDoubleOfS(list_[i].last_t, t);
-        double predict_x = list_[i].model->estimate_X[0] + dt * list_[i].model->estimate_X[4];
-        double predict_y = list_[i].model->estimate_X[1] + dt * list_[i].model->estimate_X[5];
-        double predict_z = list_[i].model->estimate_X[2];
-        double predict_theta = list_[i].model->estimate_X[3] + dt * list_[i].model->estimate_X[7];
+        double dt = getDoubleOfS(it->last_t, t);
+        double predict_x = it->model.estimate_X[0] + dt * it->model.estimate_X[4];
+        double predict_y = it->model.estimate_X[1] + dt * it->model.estimate_X[5];
+        double predict_z = it->model.estimate_X[2];
+        double predict_theta = it->model.estimate_X[3] + dt * it->model.estimate_X[7];
         Eigen::Matrix<double, 4, 1> predict_pose;
         predict_pose << predict_x, predict_y, predict_z, predict_theta;
         
@@ -65,98 +49,57 @@ void TrackQueueV2::push(Eigen::Matrix<double, 4, 1>& pose, TimePoint t) {
         
         if ((d < distance_) && (angle_diff < angle_diff_) && (d < min_distance)) {
             min_distance = d;
-            min_index = i;
+            best_state = &(*it);
         }
     }
 
     // 找到了最佳预测目标
-    if((min_index != -1) && (min_distance < distance_)) {
-        
-        double dt = getDoubleOfS(list_[min_index].last_t, t);
-        list_[min_index].update(pose, t);
+    if(best_state != nullptr) {
+        funcA_.dt = getDoubleOfS(best_state->last_t, t);
 
-        funcA_.dt = dt;
-        list_[min_index].model->predict(funcA_);
-        list_[min_index].model->update(funcH_, pose);
-        
-        double v = sqrt(list_[min_index].model->estimate_X[4] * list_[min_index].model->estimate_X[4] + 
-                        list_[min_index].model->estimate_X[5] * list_[min_index].model->estimate_X[5]);
-        double a = sqrt(list_[min_index].model->estimate_X[8] * list_[min_index].model->estimate_X[8] + 
-                        list_[min_index].model->estimate_X[9] * list_[min_index].model->estimate_X[9]);
-        double w = list_[min_index].model->estimate_X[7];
+    // 没有找到最佳预测目标，从目标池中新建一个目标，池满时丢弃
+    } else {
+        best_state = list_.get(list_.emplace());
+        if(best_state == nullptr) return;
+        best_state->model.Q = matrixQ_;
+        best_state->model.R = matrixR_;
+        funcA_.dt = 0.0;
+    }
 
-        list_[min_index].v_std->push(v);
-        list_[min_index].a_std->push(a);
-        list_[min_index].w_std->push(w);
+    best_state->update(pose, t);
+    best_state->model.predict(funcA_);
+    best_state->model.update(funcH_, pose);
 
-        return;
+    double v = sqrt(best_state->model.estimate_X[4] * best_state->model.estimate_X[4] + 
+                    best_state->model.estimate_X[5] * best_state->model.estimate_X[5]);
+    double a = sqrt(best_state->model.estimate_X[8] * best_state->model.estimate_X[8] + 
+                    best_state->model.estimate_X[9] * best_state->model.estimate_X[9]);
+    double w = best_state->model.estimate_X[7];
 
-    // 没有找到最佳预测目标
-    } else {
-        // 有空目标，使用空目标
-        if(first_empty != -1) {
-            list_[first_empty].update(pose, t);
-            
-            list_[first_empty].model->restart();
-            funcA_.dt = 0.0;
-            list_[first_empty].model->predict(funcA_);
-            list_[first_empty].model->update(funcH_, pose);
-
-            double v = sqrt(list_[first_empty].model->estimate_X[4] * list_[first_empty].model->estimate_X[4] + 
-                            list_[first_empty].model->estimate_X[5] * list_[first_empty].model->estimate_X[5]);
-            double a = sqrt(list_[first_empty].model->estimate_X[8] * list_[first_empty].model->estimate_X[8] + 
-                            list_[first_empty].model->estimate_X[9] * list_[first_empty].model->estimate_X[9]);
-            double w = list_[first_empty].model->estimate_X[7];
-
-            list_[first_empty].v_std->push(v);
-            list_[first_empty].a_std->push(a);
-            list_[first_empty].w_std->push(w);
-
-            return;
-
-        // 没有空目标，新建一个目标
-        } else {
-            list_.push_back(TQstateV2());
-            list_[list_.size() - 1].model->Q = matrixQ_;
-            list_[list_.size() - 1].model->R = matrixR_;
-            list_[list_.size() - 1].update(pose, t);
-
-            list_[list_.size() - 1].model->restart();
-            funcA_.dt = 0.0;
-            list_[list_.size() - 1].model->predict(funcA_);
-            list_[list_.size() - 1].model->update(funcH_, pose);
-
-            double v = sqrt(list_[list_.size() - 1].model->estimate_X[4] * list_[list_.size() - 1].model->estimate_X[4] + 
-                            list_[list_.size() - 1].model->estimate_X[5] * list_[list_.size() - 1].model->estimate_X[5]);
-            double a = sqrt(list_[list_.size() - 1].model->estimate_X[8] * list_[list_.size() - 1].model->estimate_X[8] +
-                            list_[list_.size() - 1].model->estimate_X[9] * list_[list_.size() - 1].model->estimate_X[9]);
-            double w = list_[list_.size() - 1].model->estimate_X[7];
-            
-            list_[list_.size() - 1].v_std->push(v);
-            list_[list_.size() - 1].a_std->push(a);
-            list_[list_.size() - 1].w_std->push(w);
-
-            return;
-        }
-    }
+    best_state->v_std.push(v);
+    best_state->a_std.push(a);
+    best_state->w_std.push(w);
 }
 
 void TrackQueueV2::update() {
-    int min_angle_index = getMinAngleOffset();
+    SlotHandle min_angle_handle = getMinAngleOffset();
+    TQstateV2* last_state = list_.get(last_handle_);
+    TQstateV2* min_angle_state = list_.get(min_angle_handle);
 
-    if ((last_index_ == -1) || !list_[last_index_].exist) {
+    if (last_state == nullptr) {
         last_toggle_ = !last_toggle_;
-        last_index_ = min_angle_index;
+        last_handle_ = min_angle_handle;
         return;
     } else if (
-        last_index_ != min_angle_index && 
-        list_[min_angle_index].count > count_ &&
+        min_angle_state != nullptr &&
+        last_handle_ != min_angle_handle && 
+        min_angle_state->count > count_ &&
         getAngleDiff(
-            getAngleOffset(list_[last_index_].last_pose),
-            getAngleOffset(list_[min_angle_index].last_pose)
+            getAngleOffset(last_state->last_pose),
+            getAngleOffset(min_angle_state->last_pose)
         ) > toggle_angle_
     ) {
-        last_index_ = min_angle_index;
+        last_handle_ = min_angle_handle;
         last_toggle_ = !last_toggle_;
         return;
     }
@@ -178,8 +121,8 @@ void TrackQueueV2::setMatrixQ(
                 0, 0, 0, 0, 0, 0, 0, 0, 0, q10, 0,
                 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, q11;
 
-    for(int i = 0; i < list_.size(); i++) {
-        list_[i].model->Q = matrixQ_;
+    for(auto it = list_.begin(); it != list_.end(); ++it) {
+        it->model.Q = matrixQ_;
     }
 }
 
@@ -188,34 +131,35 @@ void TrackQueueV2::setMatrixR(double r1, double r2, double r3, double r4) {
                 0, r2, 0, 0,
                 0, 0, r3, 0,
                 0, 0, 0, r4;
-    for(int i = 0; i < list_.size(); i++) {
-        list_[i].model->R = matrixR_;
+    for(auto it = list_.begin(); it != list_.end(); ++it) {
+        it->model.R = matrixR_;
     }
 }
 
 EKF<11, 4>* TrackQueueV2::getModel() {
-    if (last_index_ == -1) {
+    TQstateV2* state = list_.get(last_handle_);
+    if (state == nullptr) {
         return nullptr;
     }
-    return list_[last_index_].model;
+    return &state->model;
 }
 
 TimePoint TrackQueueV2::getLastTime() {
-    if ((last_index_ == -1) || !list_[last_index_].exist || !list_[last_index_].available) {
+    TQstateV2* state = list_.get(last_handle_);
+    if ((state == nullptr) || !state->available) {
         return getTime();
     }
-    return list_[last_index_].last_t;
+    return state->last_t;
 }
 
 void TrackQueueV2::getStateStr(std::vector<std::string>& str) {
     str.clear();
     str.push_back("TrackQueueV2:");
-    str.push_back("last_index: " + to_string(last_index_));
+    str.push_back("last_index: " + to_string(last_handle_.index));
     str.push_back("last_toggle: " + to_string(last_toggle_));
     str.push_back(" ");
-    for(int i = 0; i < list_.size(); i++) {
-        if (!list_[i].exist) continue;
-        str.push_back("Track " + to_string(i) + ":");
+    for(size_t i = 0; i < list_.size(); i++) {
+        str.push_back("Track " + to_string(list_.getHandle(i).index) + ":");
         str.push_back(" count: " + to_string(list_[i].count));
         str.push_back(" keep: " + to_string(list_[i].keep));
         str.push_back(" avail: " + to_string(list_[i].available));
@@ -224,30 +168,32 @@ void TrackQueueV2::getStateStr(std::vector<std::string>& str) {
 }
 
 Eigen::Matrix<double, 4, 1> TrackQueueV2::getPose() {
-    if ((last_index_ == -1) || !list_[last_index_].exist || !list_[last_index_].available) {
+    TQstateV2* state = list_.get(last_handle_);
+    if ((state == nullptr) || !state->available) {
         return Eigen::Matrix<double, 4, 1>::Zero();
     }
 
-    list_[last_index_].available = false;
-    return list_[last_index_].last_pose;
+    state->available = false;
+    return state->last_pose;
 }
 
 Eigen::Matrix<double, 4, 1> TrackQueueV2::getPose(double delay) {
-    if ((last_index_ == -1) || !list_[last_index_].exist) {
+    TQstateV2* state = list_.get(last_handle_);
+    if (state == nullptr) {
         return Eigen::Matrix<double, 4, 1>::Zero();
     }
     TimePoint now = getTime();
-    double sys_delay = getDoubleOfS(list_[last_index_].last_t, now);
+    double sys_delay = getDoubleOfS(state->last_t, now);
     if (sys_delay > 0.5) {
         return Eigen::Matrix<double, 4, 1>::Zero();
     }
 
     double dt = sys_delay + delay;
 
-    double x = list_[last_index_].model->estimate_X[0] + dt * list_[last_index_].model->estimate_X[4];
-    double y = list_[last_index_].model->estimate_X[1] + dt * list_[last_index_].model->estimate_X[5];
-    double z = list_[last_index_].model->estimate_X[2];
-    double theta = list_[last_index_].model->estimate_X[3] + dt * list_[last_index_].model->estimate_X[7];
+    double x = state->model.estimate_X[0] + dt * state->model.estimate_X[4];
+    double y = state->model.estimate_X[1] + dt * state->model.estimate_X[5];
+    double z = state->model.estimate_X[2];
+    double theta = state->model.estimate_X[3] + dt * state->model.estimate_X[7];
 
     Eigen::Matrix<double, 4, 1> pose;
     pose << x, y, z, theta;
@@ -275,29 +221,27 @@ double TrackQueueV2::getAngleOffset(const Eigen::Matrix<double, 4, 1>& pose) {
     return angle_offset;
 }
 
-int TrackQueueV2::getMinAngleOffset() {
-    int min_index = -1;
+SlotHandle TrackQueueV2::getMinAngleOffset() {
+    SlotHandle min_handle;
     double min_angle_offset = 1e5;
-    for(int i = 0; i < list_.size(); i++) {
-        if (!list_[i].exist) {
-            continue;
-        }
+    for(size_t i = 0; i < list_.size(); i++) {
         double angle_offset = getAngleOffset(list_[i].last_pose);
         if (angle_offset < min_angle_offset) {
             min_angle_offset = angle_offset;
-            min_index = i;
+            min_handle = list_.getHandle(i);
         }
     }
-    return min_index;
+    return min_handle;
 }
 
 bool TrackQueueV2::isStdStable() {
-    if ((last_index_ == -1) || !list_[last_index_].exist) {
+    TQstateV2* state = list_.get(last_handle_);
+    if (state == nullptr) {
         return false;
     }
-    double sv = list_[last_index_].v_std->getStd();
-    double sw = list_[last_index_].w_std->getStd();
-    double sa = list_[last_index_].a_std->getStd();
+    double sv = state->v_std.getStd();
+    double sw = state->w_std.getStd();
+    double sa = state->a_std.getStd();
     if (((sv < fire_std_v_) || (sa < fire_std_a_)) && (sw < fire_std_w_)) {
         return true;
     }
@@ -13,8 +13,6 @@ using namespace std;
 // [ x, y, z, theta, vx, vy, vz, omega, ax, ay, b ]  [ x, y, z, theta ]
 // [ 0, 1, 2,   3,   4,  5,  6,    7,   8,  9, 10 ]  [ 0, 1, 2,   3   ]
 
-static std::mutex mtx_;
-
 TrackQueueV3::TrackQueueV3(int count, double distance, double delay):
     count_(count),
     distance_(distance),
@@ -23,64 +21,88 @@ TrackQueueV3::TrackQueueV3(int count, double distance, double delay):
     setMatrixR(0.1, 0.1, 0.1, 0.1);
 }
 
+TrackQueueV3::TrackQueueV3(const TrackQueueV3& other) {
+    *this = other;
+}
+
+TrackQueueV3& TrackQueueV3::operator=(const TrackQueueV3& other) {
+    if (this == &other) return *this;
+
+    // 互斥锁不随拷贝共享，拷贝期间同时锁住双方的目标池
+    std::scoped_lock lock(mtx_, other.mtx_);
+    count_ = other.count_;
+    distance_ = other.distance_;
+    delay_ = other.delay_;
+    last_handle_ = other.last_handle_;
+    funcA_ = other.funcA_;
+    funcH_ = other.funcH_;
+    matrixQ_ = other.matrixQ_;
+    matrixR_ = other.matrixR_;
+    snapshot_ = other.snapshot_;
+    list_ = other.list_;
+    return *this;
+}
+
 void TrackQueueV3::push(Eigen::Matrix<double, 4, 1>& pose, TimePoint t) {
     std::unique_lock<std::mutex> lock(mtx_);
 
+    list_.eraseIf([&](const TQstateV3& state) {
+        return (getDoubleOfS(state.last_t, t) > delay_) || (state.keep <= 0);
+    });
+
     double min_distance = 1e4;
     TQstateV3* best_state = nullptr;
     
-    for(auto it = list_.begin(); it != list_.end();) {
+    for(auto it = list_.begin(); it != list_.end(); ++it) {
 
-        TQstateV3* state = *it;
+        TQstateV3* state = &(*it);
         double dt = getDoubleOfS(state->last_t, t);
 
-        if((dt > delay_) || (state->keep <= 0)) {
-            
-            if(last_state_ == state) last_state_ = nullptr;
-            delete *it;
-            it = list_.erase(it);
-        } else {
-            ++it; 
-            double predict_x = state->model->estimate_X[0] + dt * state->model->estimate_X[4];
-            double predict_y = state->model->estimate_X[1] + dt * state->model->estimate_X[5];
-            double predict_z = state->model->estimate_X[2];
-
-            Eigen::Matrix<double, 4, 1> predict_pose;
-            predict_pose << predict_x, predict_y, predict_z, 1;
-
-            // TODO // 是否使用更新后的位置 
-            double distance = getDistance(pose, state->last_pose);
-            if(distance < min_distance) {
-                min_distance = distance;
-                best_state = state;
-            }
+        double predict_x = state->model.estimate_X[0] + dt * state->model.estimate_X[4];
+        double predict_y = state->model.estimate_X[1] + dt * state->model.estimate_X[5];
+        double predict_z = state->model.estimate_X[2];
+
+        Eigen::Matrix<double, 4, 1> predict_pose;
+        predict_pose << predict_x, predict_y, predict_z, 1;
+
+        // TODO // 是否使用更新后的位置 
+        double distance = getDistance(pose, state->last_pose);
+        if(distance < min_distance) {
+            min_distance = distance;
+            best_state = state;
         }
     }
 
     if (best_state == nullptr || min_distance > distance_) {
-        best_state = new TQstateV3();
-        best_state->model->Q = matrixQ_;
-        best_state->model->R = matrixR_;
+        // 目标池已满时丢弃新目标
+        best_state = list_.get(list_.emplace());
+        if (best_state == nullptr) {
+            publish();
+            return;
+        }
+        best_state->model.Q = matrixQ_;
+        best_state->model.R = matrixR_;
         best_state->refresh(pose, t);
 
         funcA_.dt = 0;
-        best_state->model->predict(funcA_);
-        best_state->model->update(funcH_, pose);
-
-        list_.push_back(best_state);
+        best_state->model.predict(funcA_);
+        best_state->model.update(funcH_, pose);
     } else {
         funcA_.dt = getDoubleOfS(best_state->last_t, t);
         best_state->refresh(pose, t);
-        best_state->model->predict(funcA_);
-        best_state->model->update(funcH_, pose);
+        best_state->model.predict(funcA_);
+        best_state->model.update(funcH_, pose);
     }
+
+    publish();
 }
 
 void TrackQueueV3::update() {
     std::unique_lock<std::mutex> lock(mtx_);
     for(auto it = list_.begin(); it != list_.end(); ++it) {
-        (*it)->keep -= 1;
+        it->keep -= 1;
     }
+    publish();
 }
 
 void TrackQueueV3::setMatrixQ(
@@ -108,57 +130,68 @@ void TrackQueueV3::setMatrixR(double r1, double r2, double r3, double r4) {
 }
 
 void TrackQueueV3::getStateStr(std::vector<std::string>& str) {
+    std::unique_lock<std::mutex> lock(mtx_);
     str.push_back("TrackQueueV3:");
     str.push_back(" ");
     for(size_t i = 0; i < list_.size(); i++) {
         str.push_back("Track " + to_string(i) + ":");
-        str.push_back(" count: " + to_string(list_[i]->count));
-        str.push_back(" keep: " + to_string(list_[i]->keep));
+        str.push_back(" count: " + to_string(list_[i].count));
+        str.push_back(" keep: " + to_string(list_[i].keep));
         str.push_back(" ");
     }
 }
 
-Eigen::Matrix<double, 4, 1> TrackQueueV3::getPose(double append_delay) {
-    std::unique_lock<std::mutex> lock(mtx_);
-
-    TQstateV3* state = nullptr;
-    if(last_state_ != nullptr) {
-        double dt = getDoubleOfS(last_state_->last_t, getTime());
-        if((dt < delay_) && (last_state_->keep >= 0)) {
-            state = last_state_;
-        } else {
-            last_state_ = nullptr;
+void TrackQueueV3::publish() {
+    TQstateV3* state = list_.get(last_handle_);
+    if(state != nullptr) {
+        double dt = getDoubleOfS(state->last_t, getTime());
+        if((dt >= delay_) || (state->keep < 0)) {
+            state = nullptr;
         }
-    } 
+    }
 
-    if (last_state_ == nullptr) {
+    if (state == nullptr) {
         int max_count = -1;
-        for(auto it = list_.begin(); it != list_.end(); ++it) {
+        for(size_t i = 0; i < list_.size(); i++) {
 
-            double dt = getDoubleOfS((*it)->last_t, getTime());
-            if((dt > delay_) || ((*it)->keep <= 0)) continue;
+            double dt = getDoubleOfS(list_[i].last_t, getTime());
+            if((dt > delay_) || (list_[i].keep <= 0)) continue;
 
-            if((*it)->count > max_count) {
-                max_count = (*it)->count;
-                state = *it;
+            if(list_[i].count > max_count) {
+                max_count = list_[i].count;
+                state = &list_[i];
+                last_handle_ = list_.getHandle(i);
             }
         }
     }
 
+    TQsnapshotV3 snapshot{};
     if(state != nullptr) {
-        last_state_ = state;
-
-        double sys_delay = getDoubleOfS(state->last_t, getTime());
-        double dt = sys_delay + append_delay;
-        double x = state->model->estimate_X[0] + dt * state->model->estimate_X[4];
-        double y = state->model->estimate_X[1] + dt * state->model->estimate_X[5];
-        double z = state->model->estimate_X[2];
-        double theta = state->model->estimate_X[3] + dt * state->model->estimate_X[7];
-
-        return Eigen::Matrix<double, 4, 1>(x, y, z, theta);
+        snapshot.last_t = state->last_t;
+        for(int i = 0; i < 11; i++) snapshot.state[i] = state->model.estimate_X[i];
+        snapshot.count = state->count;
+        snapshot.valid = true;
     } else {
-        return Eigen::Matrix<double, 4, 1>::Zero();
+        last_handle_ = SlotHandle();
     }
+    snapshot_.store(snapshot);
+}
+
+Eigen::Matrix<double, 4, 1> TrackQueueV3::getPose(double append_delay) {
+    // 只读取push/update发布的快照，不与检测线程争锁
+    TQsnapshotV3 snapshot = snapshot_.load();
+    if(!snapshot.valid) return Eigen::Matrix<double, 4, 1>::Zero();
+
+    double sys_delay = getDoubleOfS(snapshot.last_t, getTime());
+    if(sys_delay >= delay_) return Eigen::Matrix<double, 4, 1>::Zero();
+
+    double dt = sys_delay + append_delay;
+    double x = snapshot.state[0] + dt * snapshot.state[4];
+    double y = snapshot.state[1] + dt * snapshot.state[5];
+    double z = snapshot.state[2];
+    double theta = snapshot.state[3] + dt * snapshot.state[7];
+
+    return Eigen::Matrix<double, 4, 1>(x, y, z, theta);
 }
 
 bool TrackQueueV3::getPose(Eigen::Matrix<double, 4, 1>& pose, TimePoint& t) {
@@ -168,12 +201,12 @@ bool TrackQueueV3::getPose(Eigen::Matrix<double, 4, 1>& pose, TimePoint& t) {
 
     for(auto it = list_.begin(); it != list_.end(); ++it) {
 
-        double dt = getDoubleOfS((*it)->last_t, getTime());
-        if((dt > delay_) || ((*it)->keep <= 0)) continue;
+        double dt = getDoubleOfS(it->last_t, getTime());
+        if((dt > delay_) || (it->keep <= 0)) continue;
 
-        if((*it)->available) {
-            (*it)->available = false;
-            if((*it)->count > 2) available_state.push_back(*it);
+        if(it->available) {
+            it->available = false;
+            if(it->count > 2) available_state.push_back(&(*it));
         }
     }
 
@@ -209,8 +242,9 @@ double TrackQueueV3::getDistance(const Eigen::Matrix<double, 4, 1>& this_pose, c
 }
 
 bool TrackQueueV3::getFireFlag() {
-    if(last_state_ == nullptr) return false;
-    double dt = getDoubleOfS(last_state_->last_t, getTime());
-    if((last_state_->count > count_) && (dt < delay_)) return true;
+    TQsnapshotV3 snapshot = snapshot_.load();
+    if(!snapshot.valid) return false;
+    double dt = getDoubleOfS(snapshot.last_t, getTime());
+    if((snapshot.count > count_) && (dt < delay_)) return true;
     else return false;
 }
\ No newline at end of file
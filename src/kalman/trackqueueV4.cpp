@@ -13,8 +13,6 @@ using namespace std;
 // [ x, y, z, v, vz, angle, w, a ]  [ x, y, z ]
 // [ 0, 1, 2, 3, 4,    5,   6, 7 ]  [ 0, 1, 2 ]
 
-static std::mutex mtx_;
-
 TrackQueueV4::TrackQueueV4(int count, double distance, double delay):
     count_(count),
     distance_(distance),
@@ -23,65 +21,135 @@ TrackQueueV4::TrackQueueV4(int count, double distance, double delay):
     setMatrixR(0.1, 0.1, 0.1);
 }
 
+TrackQueueV4::TrackQueueV4(const TrackQueueV4& other) {
+    *this = other;
+}
+
+TrackQueueV4& TrackQueueV4::operator=(const TrackQueueV4& other) {
+    if (this == &other) return *this;
+
+    // 互斥锁不随拷贝共享，拷贝期间同时锁住双方的目标池
+    std::scoped_lock lock(mtx_, other.mtx_);
+    count_ = other.count_;
+    distance_ = other.distance_;
+    delay_ = other.delay_;
+    gate_ = other.gate_;
+    last_handle_ = other.last_handle_;
+    next_id_ = other.next_id_;
+    cost_ = other.cost_;
+    assign_ = other.assign_;
+    funcA_ = other.funcA_;
+    funcH_ = other.funcH_;
+    matrixQ_ = other.matrixQ_;
+    matrixR_ = other.matrixR_;
+    snapshot_ = other.snapshot_;
+    record_flag_ = other.record_flag_;
+    record_t0_ = other.record_t0_;
+    record_ = other.record_;
+    list_ = other.list_;
+    return *this;
+}
+
 void TrackQueueV4::push(Eigen::Matrix<double, 4, 1>& input_pose, TimePoint t) {
+    std::vector<Eigen::Matrix<double, 4, 1>> poses{input_pose};
+    push(poses, t);
+}
+
+void TrackQueueV4::push(std::vector<Eigen::Matrix<double, 4, 1>>& poses, TimePoint t) {
     std::unique_lock<std::mutex> lock(mtx_);
-    Eigen::Matrix<double, 3, 1> pose;
-    pose << input_pose[0], input_pose[1], input_pose[2];
 
-    double min_distance = 1e4;
-    TQstateV4* best_state = nullptr;
-    
-    for(auto it = list_.begin(); it != list_.end();) {
-
-        TQstateV4* state = *it;
-        double dt = getDoubleOfS(state->last_t, t);
-
-        if((dt > delay_) || (state->keep <= 0)) {
-            
-            if(last_state_ == state) last_state_ = nullptr;
-            delete *it;
-            it = list_.erase(it);
-        } else {
-            ++it; 
-            double predict_x = state->model->estimate_X[0] + dt * state->model->estimate_X[3] * cos(state->model->estimate_X[5]);
-            double predict_y = state->model->estimate_X[1] + dt * state->model->estimate_X[3] * sin(state->model->estimate_X[5]);
-            double predict_z = state->model->estimate_X[2];
-
-            Eigen::Matrix<double, 3, 1> predict_pose;
-            predict_pose << predict_x, predict_y, predict_z, 1;
-
-            double distance = getDistance(pose, predict_pose);
-            if(distance < min_distance) {
-                min_distance = distance;
-                best_state = state;
-            }
+    list_.eraseIf([&](const TQstateV4& state) {
+        return (getDoubleOfS(state.last_t, t) > delay_) || (state.keep <= 0);
+    });
+
+    int rows = list_.size();
+    int cols = poses.size();
+    cost_.resize(rows * cols);
+
+    // 代价为预测观测的马氏距离平方，超出马氏门限或最大移动距离的配对截断为门限值
+    bool late = false;
+    for (int i = 0; i < rows; i++) {
+        auto& model = list_[i].model;
+        // 乱序帧早于目标最新时刻, 不向回预测, 直接用当前后验做门限
+        double dt = getDoubleOfS(list_[i].last_t, t);
+        late |= (dt < 0);
+        funcA_.dt = std::max(dt, 0.0);
+
+        Eigen::Matrix<double, 8, 1> predict_X;
+        Eigen::Matrix<double, 8, 8> F;
+        funcA_(model.estimate_X.data(), predict_X.data());
+        funcA_.jacobian(model.estimate_X.data(), F);
+
+        Eigen::Matrix<double, 3, 8> FH = F.topRows<3>();
+        Eigen::Matrix<double, 3, 3> S = FH * model.P * FH.transpose() + model.Q.topLeftCorner<3, 3>() + model.R;
+        Eigen::LDLT<Eigen::Matrix<double, 3, 3>> ldlt(S);
+
+        for (int j = 0; j < cols; j++) {
+            Eigen::Matrix<double, 3, 1> e = poses[j].head<3>() - predict_X.head<3>();
+            double mahalanobis = e.dot(ldlt.solve(e));
+            bool gated = (mahalanobis > gate_) || (e.norm() > distance_);
+            cost_[i * cols + j] = gated ? gate_ : mahalanobis;
         }
     }
 
-    if (best_state == nullptr || min_distance > distance_) {
-        best_state = new TQstateV4();
-        best_state->model->Q = matrixQ_;
-        best_state->model->R = matrixR_;
-        best_state->refresh(input_pose, t);
+    hungarianSolve(cost_, rows, cols, assign_, gate_);
 
-        funcA_.dt = 0;
-        best_state->model->predict(funcA_);
-        best_state->model->update(funcH_, pose);
+    std::vector<char> matched(cols, 0);
+    for (int i = 0; i < rows; i++) {
+        int j = assign_[i];
+        if (j < 0) continue;
+        matched[j] = 1;
 
-        list_.push_back(best_state);
-    } else {
-        funcA_.dt = getDoubleOfS(best_state->last_t, t);
-        best_state->refresh(input_pose, t);
-        best_state->model->predict(funcA_);
-        best_state->model->update(funcH_, pose);
+        Eigen::Matrix<double, 3, 1> pose = poses[j].head<3>();
+        // 早于回放窗口的测量被丢弃, 不更新目标也不记录
+        if (!list_[i].model.push(funcA_, funcH_, pose, t)) continue;
+        list_[i].refresh(poses[j], t);
+        if (record_flag_) record_[list_[i].id].push_back({getDoubleOfS(record_t0_, t), poses[j]});
+    }
+
+    // 目标池已满时丢弃新目标，乱序帧中未匹配的检测已过时，不新建目标
+    for (int j = 0; j < cols; j++) {
+        if (matched[j] || late) continue;
+
+        TQstateV4* state = list_.get(list_.emplace(next_id_++));
+        if (state == nullptr) break;
+        state->model.Q = matrixQ_;
+        state->model.R = matrixR_;
+        state->refresh(poses[j], t);
+
+        Eigen::Matrix<double, 3, 1> pose = poses[j].head<3>();
+        state->model.push(funcA_, funcH_, pose, t);
+        if (record_flag_) record_[state->id].push_back({getDoubleOfS(record_t0_, t), poses[j]});
+    }
+
+    publish();
+}
+
+void TrackQueueV4::setRecord(bool record) {
+    std::unique_lock<std::mutex> lock(mtx_);
+    // 开始记录时清空旧记录，停止记录后仍可保存
+    if (record && !record_flag_) {
+        record_.clear();
+        record_t0_ = getTime();
+    }
+    record_flag_ = record;
+}
+
+bool TrackQueueV4::saveRecord(const std::string& prefix) {
+    std::unique_lock<std::mutex> lock(mtx_);
+    bool flag = true;
+    for (const auto& [id, log] : record_) {
+        flag &= writeTunerLog(prefix + "_" + to_string(id) + ".txt", log);
     }
+    return flag;
 }
 
 void TrackQueueV4::update() {
     std::unique_lock<std::mutex> lock(mtx_);
     for(auto it = list_.begin(); it != list_.end(); ++it) {
-        (*it)->keep -= 1;
+        it->keep -= 1;
     }
+    publish();
 }
 
 void TrackQueueV4::setMatrixQ(
@@ -105,56 +173,99 @@ void TrackQueueV4::setMatrixR(double r1, double r2, double r3) {
 }
 
 void TrackQueueV4::getStateStr(std::vector<std::string>& str) {
+    std::unique_lock<std::mutex> lock(mtx_);
     str.push_back("TrackQueueV4:");
     str.push_back(" ");
     for(size_t i = 0; i < list_.size(); i++) {
         str.push_back("Track " + to_string(i) + ":");
-        str.push_back(" count: " + to_string(list_[i]->count));
-        str.push_back(" keep: " + to_string(list_[i]->keep));
+        str.push_back(" id: " + to_string(list_[i].id));
+        str.push_back(" count: " + to_string(list_[i].count));
+        str.push_back(" keep: " + to_string(list_[i].keep));
         str.push_back(" ");
     }
 }
 
-Eigen::Matrix<double, 4, 1> TrackQueueV4::getPose(double append_delay) {
-    std::unique_lock<std::mutex> lock(mtx_);
-
-    TQstateV4* state = nullptr;
-    if(last_state_ != nullptr) {
-        double dt = getDoubleOfS(last_state_->last_t, getTime());
-        if((dt < delay_) && (last_state_->keep >= 0)) {
-            state = last_state_;
-        } else {
-            last_state_ = nullptr;
+void TrackQueueV4::publish() {
+    TQstateV4* state = list_.get(last_handle_);
+    if(state != nullptr) {
+        double dt = getDoubleOfS(state->last_t, getTime());
+        if((dt >= delay_) || (state->keep < 0)) {
+            state = nullptr;
         }
-    } 
+    }
 
-    if (last_state_ == nullptr) {
+    if (state == nullptr) {
         int max_count = -1;
-        for(auto it = list_.begin(); it != list_.end(); ++it) {
+        for(size_t i = 0; i < list_.size(); i++) {
 
-            double dt = getDoubleOfS((*it)->last_t, getTime());
-            if((dt > delay_) || ((*it)->keep <= 0)) continue;
+            double dt = getDoubleOfS(list_[i].last_t, getTime());
+            if((dt > delay_) || (list_[i].keep <= 0)) continue;
 
-            if((*it)->count > max_count) {
-                max_count = (*it)->count;
-                state = *it;
+            if(list_[i].count > max_count) {
+                max_count = list_[i].count;
+                state = &list_[i];
+                last_handle_ = list_.getHandle(i);
             }
         }
     }
 
+    TQsnapshotV4 snapshot{};
     if(state != nullptr) {
-        last_state_ = state;
-
-        double sys_delay = getDoubleOfS(state->last_t, getTime());
-        double dt = sys_delay + append_delay;
-        double x = state->model->estimate_X[0] + dt * state->model->estimate_X[3] * cos(state->model->estimate_X[5]);
-        double y = state->model->estimate_X[1] + dt * state->model->estimate_X[3] * sin(state->model->estimate_X[5]);
-        double z = state->model->estimate_X[2] + dt * state->model->estimate_X[4];
-    
-        return Eigen::Matrix<double, 4, 1>(x, y, z, 0);
+        snapshot.last_t = state->last_t;
+        for(int i = 0; i < 8; i++) snapshot.state[i] = state->model.estimate_X[i];
+        for(int i = 0; i < 6; i++) {
+            for(int j = 0; j < 6; j++) snapshot.cov[i * 6 + j] = state->model.P(i, j);
+        }
+        snapshot.count = state->count;
+        snapshot.valid = true;
     } else {
-        return Eigen::Matrix<double, 4, 1>::Zero();
+        last_handle_ = SlotHandle();
     }
+    snapshot_.store(snapshot);
+}
+
+Eigen::Matrix<double, 4, 1> TrackQueueV4::getPose(double append_delay) {
+    // 只读取push/update发布的快照，不与检测线程争锁
+    TQsnapshotV4 snapshot = snapshot_.load();
+    if(!snapshot.valid) return Eigen::Matrix<double, 4, 1>::Zero();
+
+    double sys_delay = getDoubleOfS(snapshot.last_t, getTime());
+    if(sys_delay >= delay_) return Eigen::Matrix<double, 4, 1>::Zero();
+
+    double dt = sys_delay + append_delay;
+    double x = snapshot.state[0] + dt * snapshot.state[3] * cos(snapshot.state[5]);
+    double y = snapshot.state[1] + dt * snapshot.state[3] * sin(snapshot.state[5]);
+    double z = snapshot.state[2] + dt * snapshot.state[4];
+
+    return Eigen::Matrix<double, 4, 1>(x, y, z, 0);
+}
+
+Eigen::Matrix<double, 3, 3> TrackQueueV4::getPoseCov(double append_delay) {
+    TQsnapshotV4 snapshot = snapshot_.load();
+    Eigen::Matrix<double, 3, 3> invalid = Eigen::Vector3d::Constant(INFINITY).asDiagonal();
+    if(!snapshot.valid) return invalid;
+
+    // 与 getPose 相同的失效条件, 无目标时方差为无穷大
+    double sys_delay = getDoubleOfS(snapshot.last_t, getTime());
+    if(sys_delay >= delay_) return invalid;
+
+    double dt = sys_delay + append_delay;
+    double v = snapshot.state[3];
+    double c = cos(snapshot.state[5]), s = sin(snapshot.state[5]);
+
+    // getPose 对 [ x, y, z, v, vz, angle ] 的雅可比
+    Eigen::Matrix<double, 3, 6> J = Eigen::Matrix<double, 3, 6>::Zero();
+    J(0, 0) = 1;
+    J(0, 3) = dt * c;
+    J(0, 5) = -dt * v * s;
+    J(1, 1) = 1;
+    J(1, 3) = dt * s;
+    J(1, 5) = dt * v * c;
+    J(2, 2) = 1;
+    J(2, 4) = dt;
+
+    Eigen::Map<const Eigen::Matrix<double, 6, 6, Eigen::RowMajor>> P(snapshot.cov);
+    return J * P * J.transpose();
 }
 
 bool TrackQueueV4::getPose(Eigen::Matrix<double, 4, 1>& pose, TimePoint& t) {
@@ -164,12 +275,12 @@ bool TrackQueueV4::getPose(Eigen::Matrix<double, 4, 1>& pose, TimePoint& t) {
 
     for(auto it = list_.begin(); it != list_.end(); ++it) {
 
-        double dt = getDoubleOfS((*it)->last_t, getTime());
-        if((dt > delay_) || ((*it)->keep <= 0)) continue;
+        double dt = getDoubleOfS(it->last_t, getTime());
+        if((dt > delay_) || (it->keep <= 0)) continue;
 
-        if((*it)->available) {
-            (*it)->available = false;
-            if((*it)->count > 2) available_state.push_back(*it);
+        if(it->available) {
+            it->available = false;
+            if(it->count > 2) available_state.push_back(&(*it));
         }
     }
 
@@ -213,8 +324,9 @@ double TrackQueueV4::getDistance(const Eigen::Matrix<double, 3, 1>& this_pose, c
 }
 
 bool TrackQueueV4::getFireFlag() {
-    if(last_state_ == nullptr) return false;
-    double dt = getDoubleOfS(last_state_->last_t, getTime());
-    if((last_state_->count > count_) && (dt < delay_)) return true;
+    TQsnapshotV4 snapshot = snapshot_.load();
+    if(!snapshot.valid) return false;
+    double dt = getDoubleOfS(snapshot.last_t, getTime());
+    if((snapshot.count > count_) && (dt < delay_)) return true;
     else return false;
 }
\ No newline at end of file
@@ -0,0 +1,206 @@
+#include "kalman/tuner.h"
+#include "uniterm/uniterm.h"
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <thread>
+using namespace rm;
+using namespace std;
+
+bool rm::writeTunerLog(const std::string& file, const TunerLog& log) {
+    std::ofstream out(file);
+    if (!out.is_open()) {
+        rm::message("Tuner : failed to open " + file, rm::MSG_ERROR);
+        return false;
+    }
+    out.precision(9);
+    out << "# t x y z theta\n";
+    for (const auto& sample : log) {
+        out << sample.t << " " << sample.pose[0] << " " << sample.pose[1] << " "
+            << sample.pose[2] << " " << sample.pose[3] << "\n";
+    }
+    return true;
+}
+
+bool rm::readTunerLog(const std::string& file, TunerLog& log) {
+    std::ifstream in(file);
+    if (!in.is_open()) {
+        rm::message("Tuner : failed to open " + file, rm::MSG_ERROR);
+        return false;
+    }
+    log.clear();
+
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream iss(line);
+        TunerSample sample;
+        if (!(iss >> sample.t >> sample.pose[0] >> sample.pose[1] >> sample.pose[2] >> sample.pose[3])) {
+            continue;
+        }
+        log.push_back(sample);
+    }
+    std::stable_sort(log.begin(), log.end(), [](const TunerSample& a, const TunerSample& b) {
+        return a.t < b.t;
+    });
+
+    if (log.empty()) {
+        rm::message("Tuner : no sample in " + file, rm::MSG_ERROR);
+        return false;
+    }
+    return true;
+}
+
+// 在所有记录上评估一组参数，结果写入 cost[i]
+static void evaluatePopulation(
+    const TunerObjective& objective,
+    const std::vector<TunerLog>& logs,
+    const std::vector<std::vector<double>>& params,
+    std::vector<double>& cost,
+    int threads
+) {
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        for (size_t i = next++; i < params.size(); i = next++) {
+            double sum = 0.0;
+            for (const auto& log : logs) sum += objective(params[i], log);
+            cost[i] = std::isfinite(sum) ? sum : std::numeric_limits<double>::max();
+        }
+    };
+
+    int num = std::max(1, std::min(threads, (int)params.size()));
+    std::vector<std::thread> pool;
+    for (int i = 1; i < num; i++) pool.emplace_back(worker);
+    worker();
+    for (auto& t : pool) t.join();
+}
+
+TunerResult rm::tuneCMAES(
+    const TunerObjective& objective,
+    const std::vector<TunerLog>& logs,
+    const std::vector<double>& init,
+    const TunerConfig& config
+) {
+    const int n = (int)init.size();
+    TunerResult result;
+    result.params = init;
+    if (n == 0 || logs.empty()) {
+        rm::message("Tuner : empty parameters or logs", rm::MSG_ERROR);
+        return result;
+    }
+
+    int threads = config.threads > 0 ? config.threads : (int)std::thread::hardware_concurrency();
+    threads = std::max(threads, 1);
+
+    // 标准 CMA-ES 参数 (Hansen, The CMA Evolution Strategy: A Tutorial)
+    const int lambda = config.population > 0 ? config.population : 4 + (int)(3 * std::log(n));
+    const int mu = lambda / 2;
+    Eigen::VectorXd weights(mu);
+    for (int i = 0; i < mu; i++) weights[i] = std::log(mu + 0.5) - std::log(i + 1.0);
+    weights /= weights.sum();
+    const double mueff = 1.0 / weights.squaredNorm();
+
+    const double cc = (4.0 + mueff / n) / (n + 4.0 + 2.0 * mueff / n);
+    const double cs = (mueff + 2.0) / (n + mueff + 5.0);
+    const double c1 = 2.0 / ((n + 1.3) * (n + 1.3) + mueff);
+    const double cmu = std::min(1.0 - c1, 2.0 * (mueff - 2.0 + 1.0 / mueff) / ((n + 2.0) * (n + 2.0) + mueff));
+    const double damps = 1.0 + 2.0 * std::max(0.0, std::sqrt((mueff - 1.0) / (n + 1.0)) - 1.0) + cs;
+    const double chin = std::sqrt((double)n) * (1.0 - 1.0 / (4.0 * n) + 1.0 / (21.0 * n * n));
+
+    Eigen::VectorXd mean = Eigen::Map<const Eigen::VectorXd>(init.data(), n);
+    Eigen::VectorXd pc = Eigen::VectorXd::Zero(n);
+    Eigen::VectorXd ps = Eigen::VectorXd::Zero(n);
+    Eigen::MatrixXd C = Eigen::MatrixXd::Identity(n, n);
+    Eigen::MatrixXd B = Eigen::MatrixXd::Identity(n, n);
+    Eigen::VectorXd D = Eigen::VectorXd::Ones(n);
+    double sigma = config.sigma;
+
+    // 初值也参与比较，搜索结果不会比默认参数更差
+    std::vector<double> init_cost(1);
+    evaluatePopulation(objective, logs, {init}, init_cost, 1);
+    result.cost = init_cost[0];
+    result.evaluations = 1;
+
+    std::mt19937 rng(config.seed);
+    std::normal_distribution<double> normal(0.0, 1.0);
+
+    std::vector<std::vector<double>> params(lambda, std::vector<double>(n));
+    std::vector<Eigen::VectorXd> z(lambda, Eigen::VectorXd(n));
+    std::vector<Eigen::VectorXd> y(lambda, Eigen::VectorXd(n));
+    std::vector<double> cost(lambda);
+    std::vector<int> order(lambda);
+
+    for (int iter = 0; iter < config.max_iter; iter++) {
+        for (int k = 0; k < lambda; k++) {
+            for (int i = 0; i < n; i++) z[k][i] = normal(rng);
+            y[k] = B * D.asDiagonal() * z[k];
+            Eigen::VectorXd x = mean + sigma * y[k];
+            for (int i = 0; i < n; i++) {
+                // 越界时截断到边界，并修正 y 使更新与实际评估的点一致
+                x[i] = std::clamp(x[i], config.lower, config.upper);
+                params[k][i] = x[i];
+            }
+            y[k] = (x - mean) / sigma;
+        }
+        evaluatePopulation(objective, logs, params, cost, threads);
+        result.evaluations += lambda;
+
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](int a, int b) { return cost[a] < cost[b]; });
+        if (cost[order[0]] < result.cost) {
+            result.cost = cost[order[0]];
+            result.params = params[order[0]];
+        }
+
+        Eigen::VectorXd y_w = Eigen::VectorXd::Zero(n);
+        for (int i = 0; i < mu; i++) y_w += weights[i] * y[order[i]];
+        mean += sigma * y_w;
+
+        // C^(-1/2) = B D^(-1) B^T
+        Eigen::VectorXd Cy = B * D.cwiseInverse().asDiagonal() * B.transpose() * y_w;
+        ps = (1.0 - cs) * ps + std::sqrt(cs * (2.0 - cs) * mueff) * Cy;
+        double ps_norm = ps.norm() / std::sqrt(1.0 - std::pow(1.0 - cs, 2.0 * (iter + 1)));
+        bool hsig = ps_norm / chin < 1.4 + 2.0 / (n + 1.0);
+        pc = (1.0 - cc) * pc;
+        if (hsig) pc += std::sqrt(cc * (2.0 - cc) * mueff) * y_w;
+
+        Eigen::MatrixXd rank_mu = Eigen::MatrixXd::Zero(n, n);
+        for (int i = 0; i < mu; i++) rank_mu += weights[i] * y[order[i]] * y[order[i]].transpose();
+        double c1a = c1 * (1.0 - (hsig ? 0.0 : cc * (2.0 - cc)));
+        C = (1.0 - c1a - cmu) * C + c1 * pc * pc.transpose() + cmu * rank_mu;
+
+        sigma *= std::exp((cs / damps) * (ps.norm() / chin - 1.0));
+        sigma = std::min(sigma, config.upper - config.lower);
+
+        C = 0.5 * (C + C.transpose());
+        Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> eigen(C);
+        B = eigen.eigenvectors();
+        D = eigen.eigenvalues().cwiseMax(1e-20).cwiseSqrt();
+
+        rm::message("tuner iter", iter);
+        rm::message("tuner cost", result.cost);
+
+        // 步长过小时收敛
+        if (sigma * D.maxCoeff() < 1e-6) break;
+    }
+    return result;
+}
+
+std::string rm::getTunerParamStr(const std::vector<double>& params, int dimX) {
+    auto join = [&](int begin, int end) {
+        std::string str;
+        char buf[32];
+        for (int i = begin; i < end; i++) {
+            std::snprintf(buf, sizeof(buf), "%.3g", std::pow(10.0, params[i]));
+            str += (i == begin ? "" : ", ") + std::string(buf);
+        }
+        return str;
+    };
+    dimX = std::min(dimX, (int)params.size());
+    return "setMatrixQ(" + join(0, dimX) + ");\n" +
+           "setMatrixR(" + join(dimX, (int)params.size()) + ");\n";
+}
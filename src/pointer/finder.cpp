@@ -110,3 +110,143 @@ void rm::findCircleCenterFromContours(
         circles.push_back(center);
     }
 }
+
+struct RuneCircle {
+    cv::Point2f center;
+    double      radius;
+    int         index;
+};
+
+// 沿R标到靶心的线段采样二值图，返回点亮比例；已激活扇叶灯臂常亮，待激活扇叶为流水箭头
+static double getRuneArmFill(const cv::Mat& binary, const cv::Point2f& center, const cv::Point2f& target) {
+    constexpr int SAMPLE_NUM = 24;
+    int lit = 0, count = 0;
+    for (int i = 0; i < SAMPLE_NUM; i++) {
+        double k = 0.25 + 0.5 * i / (SAMPLE_NUM - 1);
+        cv::Point p = center + (target - center) * k;
+        if (p.x < 0 || p.y < 0 || p.x >= binary.cols || p.y >= binary.rows) continue;
+        if (binary.at<uchar>(p) > 0) lit++;
+        count++;
+    }
+    return count > 0 ? (double)lit / count : 1.0;
+}
+
+bool rm::findRune(
+    const cv::Mat& src, Rune& rune, ArmorColor color,
+    double threshold,
+    double min_target_area,
+    double min_circularity,
+    double max_ratio_error,
+    double ratio_radius
+) {
+    // 上一帧有效时只在R标附近搜索
+    cv::Rect full(0, 0, src.cols, src.rows);
+    bool tracking = rune.valid && (rune.roi.area() > 0) && (rune.radius > 0);
+    cv::Rect roi = tracking ? (rune.roi & full) : full;
+    rune.valid = false;
+    if (roi.area() == 0) return false;
+
+    cv::Mat gray, binary;
+    getGrayScale(src(roi), gray, color, GRAY_SCALE_METHOD_SUB);
+    getBinary(gray, binary, threshold, BINARY_METHOD_MAX_MIN_RATIO);
+
+    std::vector<std::vector<cv::Point>> contours;
+    std::vector<cv::Vec4i> hierarchy;
+    cv::findContours(binary, contours, hierarchy, cv::RETR_CCOMP, cv::CHAIN_APPROX_NONE);
+
+    // 靶心为扇叶轮廓内的圆形孔洞
+    std::vector<RuneCircle> circles;
+    for (size_t i = 0; i < contours.size(); i++) {
+        if (hierarchy[i][3] < 0) continue;
+        double area = cv::contourArea(contours[i]);
+        if (area < min_target_area) continue;
+
+        float radius;
+        cv::Point2f center;
+        cv::minEnclosingCircle(contours[i], center, radius);
+        double circularity = area / (M_PI * pow((double)radius, 2));
+        if (circularity < min_circularity) continue;
+        circles.push_back({center, (double)radius, (int)i});
+    }
+    if (circles.empty()) return false;
+
+    // R标为近方形外轮廓，面积与靶心相当，到各靶心的距离与靶心半径之比应接近 ratio_radius
+    int best_r = -1, best_match = 0;
+    double best_error = 1e9;
+    cv::Point2f best_center;
+    for (size_t i = 0; i < contours.size(); i++) {
+        if (hierarchy[i][3] >= 0) continue;
+        cv::Rect rect = cv::boundingRect(contours[i]);
+        if (std::max(rect.width, rect.height) > 1.6 * std::min(rect.width, rect.height)) continue;
+        double area = cv::contourArea(contours[i]);
+        if (area < 0.3 * rect.area()) continue;
+
+        cv::Point2f center(rect.x + rect.width / 2.0f, rect.y + rect.height / 2.0f);
+        int match = 0;
+        double error = 0.0;
+        for (const auto& c : circles) {
+            double r_area = area / (M_PI * c.radius * c.radius);
+            if (r_area < 0.1 || r_area > 4.0) continue;
+            double e = fabs(cv::norm(c.center - center) / c.radius / ratio_radius - 1.0);
+            if (e > max_ratio_error) continue;
+            match++;
+            error += e;
+        }
+        if (match == 0) continue;
+        error /= match;
+
+        // 跟踪时优先上一帧R标附近的候选
+        if (tracking) error += 0.1 * cv::norm(center + cv::Point2f(roi.tl()) - rune.center) / rune.radius;
+        if (match > best_match || (match == best_match && error < best_error)) {
+            best_r = (int)i;
+            best_match = match;
+            best_error = error;
+            best_center = center;
+        }
+    }
+    if (best_r < 0) return false;
+
+    // 与R标匹配的靶心中，灯臂点亮比例最低的为待激活扇叶
+    int best_c = -1;
+    double best_fill = 2.0;
+    for (size_t i = 0; i < circles.size(); i++) {
+        double e = fabs(cv::norm(circles[i].center - best_center) / circles[i].radius / ratio_radius - 1.0);
+        if (e > max_ratio_error) continue;
+        double fill = getRuneArmFill(binary, best_center, circles[i].center);
+        if (fill < best_fill) {
+            best_fill = fill;
+            best_c = (int)i;
+        }
+    }
+    if (best_c < 0) return false;
+    const RuneCircle& circle = circles[best_c];
+
+    // 靶心轮廓在扇叶方向及其垂直方向上的极值点
+    cv::Point2f u = circle.center - best_center;
+    u /= (float)cv::norm(u);
+    cv::Point2f v(-u.y, u.x);
+    const auto& contour = contours[circle.index];
+    cv::Point2f far_p, near_p, right_p, left_p;
+    float u_max = -1e9f, u_min = 1e9f, v_max = -1e9f, v_min = 1e9f;
+    for (const auto& p : contour) {
+        cv::Point2f d = cv::Point2f(p) - circle.center;
+        float pu = d.dot(u), pv = d.dot(v);
+        if (pu > u_max) { u_max = pu; far_p = p; }
+        if (pu < u_min) { u_min = pu; near_p = p; }
+        if (pv > v_max) { v_max = pv; right_p = p; }
+        if (pv < v_min) { v_min = pv; left_p = p; }
+    }
+
+    cv::Point2f offset(roi.tl());
+    rune.center = best_center + offset;
+    rune.target = circle.center + offset;
+    rune.four_points = {far_p + offset, right_p + offset, near_p + offset, left_p + offset};
+    rune.radius = cv::norm(rune.target - rune.center);
+    rune.angle = atan2(-(rune.target.y - rune.center.y), rune.target.x - rune.center.x);
+
+    // 下一帧搜索区域覆盖整个符面
+    int half = (int)(rune.radius * 1.5) + (int)circle.radius;
+    rune.roi = cv::Rect((int)rune.center.x - half, (int)rune.center.y - half, 2 * half, 2 * half) & full;
+    rune.valid = true;
+    return true;
+}
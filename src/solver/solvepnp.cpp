@@ -1,35 +1,55 @@
 #include "solver/solvepnp.h"
 #include "solver/ternary.hpp"
+#include "solver/brent.hpp"
 #include "utils/timer.h"
 #include "uniterm/uniterm.h"
 #include "structure/slidestd.hpp"
+#include <algorithm>
 #include <cmath>
 using namespace rm;
 using namespace std;
 
 static double ANGLE_COST_RATIO = 4.0;
+static double SEED_SEARCH_SPAN = 0.4;
+static double SEED_SEARCH_EPS  = 0.005;
+
+// 先在初值附近的小区间内搜索，落在小区间边界时再扩展到完整区间
+template<typename T>
+static double searchFromSeed(double left, double right, double seed, const T& func, double epsilon) {
+    double l = std::max(left, seed - SEED_SEARCH_SPAN);
+    double r = std::min(right, seed + SEED_SEARCH_SPAN);
+    double x = brentSearch(l, r, seed, func, epsilon);
+
+    bool hit_left = (l > left) && (x - l < epsilon);
+    bool hit_right = (r < right) && (r - x < epsilon);
+    if (hit_left || hit_right) {
+        x = brentSearch(left, right, x, func, epsilon);
+    }
+    return x;
+}
 
-double rm::solveYawPnP(
+static double solveYawPnPImpl(
     const double yaw,
     Camera* camera,
+    const YawPnPShared& shared,
     Eigen::Vector4d& ret_pose,
     const std::vector<cv::Point3f>& object_points,
     const std::vector<cv::Point2f>& image_points,
-    const Eigen::Matrix3d& rotate_head2world,
-    const Eigen::Matrix4d& trans_head2world,
     rm::ArmorID armor_id,
-    bool display_flag
+    ArmorElevation* ret_elevation,
+    YawPnP* ret_yaw_pnp
 ) {
     ret_pose = Eigen::Vector4d(0, 0, 0, 1);
     if (camera == nullptr) return 0.0;
-    YawPnP* yaw_pnp = new YawPnP();
+    YawPnP yaw_pnp;
 
     // 设置yaw
-    yaw_pnp->sys_yaw = yaw;
+    yaw_pnp.sys_yaw = yaw;
 
     // 设置装甲板四点坐标
-    yaw_pnp->setWorldPoints(object_points);
-    yaw_pnp->setImagePoints(image_points);
+    yaw_pnp.setWorldPoints(object_points);
+    yaw_pnp.setImagePoints(image_points);
+    if (!yaw_pnp.world_valid || !yaw_pnp.pixel_valid) return yaw;
 
     cv::Mat rvec, tvec, rotate_cv;
     Eigen::Vector4d pose_pnp;
@@ -41,45 +61,227 @@ double rm::solveYawPnP(
                  rvec, tvec, false, cv::SOLVEPNP_IPPE);
 
     // 计算装甲板位姿，确定返回值
-    Eigen::Matrix4d trans_pnp2head = camera->Trans_pnp2head;
-    yaw_pnp->T = trans_head2world * trans_pnp2head;
-    yaw_pnp->T_inv = yaw_pnp->T.inverse();
+    yaw_pnp.T = shared.T;
+    yaw_pnp.T_inv = shared.T_inv;
 
     rm::tf_Vec4d(tvec, pose_pnp);
-    ret_pose = yaw_pnp->T * pose_pnp;
-    yaw_pnp->pose = ret_pose;
+    ret_pose = yaw_pnp.T * pose_pnp;
+    yaw_pnp.pose = ret_pose;
 
     // 计算装甲板仰角
-    Eigen::Matrix3d rotate_pnp2head = camera->Rotate_pnp2head;
     cv::Rodrigues(rvec, rotate_cv);
     rm::tf_Mat3d(rotate_cv, rotate_pnp);
-    rotate_world = rotate_head2world * rotate_pnp2head * rotate_pnp;
+    rotate_world = shared.rotate_pnp2world * rotate_pnp;
     double armor_pitch_pnp = rm::tf_rotation2armorpitch(rotate_world);
     double armor_yaw_pnp = rm::tf_rotation2armoryaw(rotate_world);
 
     // 设置装甲板仰角
     if (armor_id == rm::ARMOR_ID_UNKNOWN) {
-        yaw_pnp->setElevation(armor_pitch_pnp);
+        yaw_pnp.setElevation(armor_pitch_pnp);
     } else {
-        yaw_pnp->setElevation(armor_id);
+        yaw_pnp.setElevation(armor_id);
+    }
+    if (ret_elevation != nullptr) {
+        *ret_elevation = yaw_pnp.elevation;
     }
 
     // 设置相机内参
-    tf_Mat3f(camera->intrinsic_matrix, yaw_pnp->Kc);
+    yaw_pnp.Kc = shared.Kc;
 
-    if (display_flag) {
-        displayYawPnP(yaw_pnp);
+    // 以IPPE解算的装甲板朝向作为初值求解yaw
+    double seed_yaw = getYawPnPSeed(yaw, armor_yaw_pnp);
+    double angle_yaw = yaw_pnp.getYawByAngleCost(-(M_PI / 2), (M_PI / 2), seed_yaw, SEED_SEARCH_EPS);
+    double pixel_yaw = yaw_pnp.getYawByPixelCost(-(M_PI / 2), (M_PI / 2), seed_yaw, SEED_SEARCH_EPS);
+    double append_yaw = yaw_pnp.getYawByMix(pixel_yaw, angle_yaw);
+
+    if (ret_yaw_pnp != nullptr) {
+        *ret_yaw_pnp = yaw_pnp;
     }
+    return append_yaw + yaw;
+}
 
-    // 求解yaw
-    double angle_yaw = yaw_pnp->getYawByAngleCost(-(M_PI / 2), (M_PI / 2), 0.03);
-    double pixel_yaw = yaw_pnp->getYawByPixelCost(-(M_PI / 2), (M_PI / 2), 0.03);
-    double append_yaw = yaw_pnp->getYawByMix(pixel_yaw, angle_yaw);
+void rm::getYawPnPShared(
+    Camera* camera,
+    const Eigen::Matrix3d& rotate_head2world,
+    const Eigen::Matrix4d& trans_head2world,
+    YawPnPShared& shared
+) {
+    // 每帧只需计算一次的相机变换
+    Eigen::Matrix4d trans_pnp2head = camera->Trans_pnp2head;
+    Eigen::Matrix3d rotate_pnp2head = camera->Rotate_pnp2head;
+    shared.T = trans_head2world * trans_pnp2head;
+    shared.T_inv = shared.T.inverse();
+    shared.rotate_pnp2world = rotate_head2world * rotate_pnp2head;
+    tf_Mat3f(camera->intrinsic_matrix, shared.Kc);
+}
+
+double rm::solveYawPnP(
+    const double yaw,
+    Camera* camera,
+    Eigen::Vector4d& ret_pose,
+    const std::vector<cv::Point3f>& object_points,
+    const std::vector<cv::Point2f>& image_points,
+    const Eigen::Matrix3d& rotate_head2world,
+    const Eigen::Matrix4d& trans_head2world,
+    rm::ArmorID armor_id,
+    bool display_flag
+) {
+    ret_pose = Eigen::Vector4d(0, 0, 0, 1);
+    if (camera == nullptr) return 0.0;
+
+    YawPnPShared shared;
+    getYawPnPShared(camera, rotate_head2world, trans_head2world, shared);
+
+    if (!display_flag) {
+        return solveYawPnP(yaw, camera, shared, ret_pose, object_points, image_points, armor_id);
+    }
 
-    delete yaw_pnp;
+    YawPnP yaw_pnp;
+    double append_yaw = solveYawPnPImpl(yaw, camera, shared, ret_pose, object_points, image_points, armor_id, nullptr, &yaw_pnp) - yaw;
+    displayYawPnP(&yaw_pnp);
     return append_yaw + yaw;
 }
 
+double rm::solveYawPnP(
+    const double yaw,
+    Camera* camera,
+    const YawPnPShared& shared,
+    Eigen::Vector4d& ret_pose,
+    const std::vector<cv::Point3f>& object_points,
+    const std::vector<cv::Point2f>& image_points,
+    rm::ArmorID armor_id,
+    ArmorElevation* ret_elevation
+) {
+    return solveYawPnPImpl(yaw, camera, shared, ret_pose, object_points, image_points, armor_id, ret_elevation, nullptr);
+}
+
+int rm::solveYawPnPBatch(
+    Frame& frame,
+    const std::vector<Armor>& armors,
+    const double yaw,
+    Camera* camera,
+    const std::vector<cv::Point3f>& small_object_points,
+    const std::vector<cv::Point3f>& big_object_points,
+    const Eigen::Matrix3d& rotate_head2world,
+    const Eigen::Matrix4d& trans_head2world,
+    bool elevation_by_id
+) {
+    if (camera == nullptr || armors.empty()) return 0;
+
+    YawPnPShared shared;
+    getYawPnPShared(camera, rotate_head2world, trans_head2world, shared);
+
+    // 每个装甲板写入自己的槽位，无需加锁
+    size_t offset = frame.target_list.size();
+    frame.target_list.resize(offset + armors.size());
+    std::vector<char> valid(armors.size(), 0);
+
+    auto solve = [&](const cv::Range& range) {
+        for (int i = range.start; i < range.end; i++) {
+            const Armor& armor = armors[i];
+            const std::vector<cv::Point3f>& object_points =
+                (armor.size == ARMOR_SIZE_BIG_ARMOR) ? big_object_points : small_object_points;
+            if (armor.four_points.size() != 4 || object_points.size() != 4) continue;
+
+            Target& target = frame.target_list[offset + i];
+            ArmorElevation elevation = ARMOR_ELEVATION_UP_15;
+            ArmorID armor_id = elevation_by_id ? armor.id : ARMOR_ID_UNKNOWN;
+
+            target.armor_yaw_world = solveYawPnP(
+                yaw, camera, shared, target.pose_world,
+                object_points, armor.four_points, armor_id, &elevation);
+            target.rune_angle = 0.0;
+            target.armor_id = armor.id;
+            target.color = armor.color;
+            target.armor_size = armor.size;
+            target.armor_elevation = elevation;
+            valid[i] = 1;
+        }
+    };
+
+    // 装甲板较少时线程调度开销大于收益
+    if (armors.size() <= 2) {
+        solve(cv::Range(0, static_cast<int>(armors.size())));
+    } else {
+        cv::parallel_for_(cv::Range(0, static_cast<int>(armors.size())), solve);
+    }
+
+    // 按原顺序压缩掉无效的装甲板
+    size_t count = offset;
+    for (size_t i = 0; i < armors.size(); i++) {
+        if (!valid[i]) continue;
+        if (count != offset + i) frame.target_list[count] = frame.target_list[offset + i];
+        count++;
+    }
+    frame.target_list.resize(count);
+    return static_cast<int>(count - offset);
+}
+
+bool rm::solveRunePose(
+    Camera* camera,
+    const YawPnPShared& shared,
+    const Rune& rune,
+    Eigen::Matrix<double, 5, 1>& pose,
+    double radius,
+    double target_radius
+) {
+    pose.setZero();
+    if (camera == nullptr || !rune.valid || rune.four_points.size() != 4) return false;
+
+    // 扇叶坐标系: 原点为R标, x 轴指向靶心, y 轴与像素 y 同向 (朝下), z = x × y 垂直符面指向场景内
+    // 与装甲板 PnP 的 z 轴约定一致, tf_rotation2armoryaw 得到的 theta 即 RuneV2_FuncH 中的 theta
+    std::vector<cv::Point3f> object_points = {
+        cv::Point3f(0, 0, 0),
+        cv::Point3f(radius + target_radius, 0, 0),
+        cv::Point3f(radius, target_radius, 0),
+        cv::Point3f(radius - target_radius, 0, 0),
+        cv::Point3f(radius, -target_radius, 0)
+    };
+    std::vector<cv::Point2f> image_points = {rune.center};
+    image_points.insert(image_points.end(), rune.four_points.begin(), rune.four_points.end());
+
+    cv::Mat rvec, tvec, rotate_cv;
+    if (!cv::solvePnP(object_points, image_points,
+                      camera->intrinsic_matrix, camera->distortion_coeffs,
+                      rvec, tvec, false, cv::SOLVEPNP_IPPE)) {
+        return false;
+    }
+
+    Eigen::Vector4d center_pnp;
+    Eigen::Matrix3d rotate_pnp;
+    rm::tf_Vec4d(tvec, center_pnp);
+    cv::Rodrigues(rvec, rotate_cv);
+    rm::tf_Mat3d(rotate_cv, rotate_pnp);
+
+    Eigen::Vector4d target_pnp = center_pnp;
+    target_pnp.head<3>() += rotate_pnp.col(0) * radius;
+
+    Eigen::Vector4d center_world = shared.T * center_pnp;
+    Eigen::Vector4d target_world = shared.T * target_pnp;
+    Eigen::Matrix3d rotate_world = shared.rotate_pnp2world * rotate_pnp;
+
+    // 符面水平方向为 (sin(theta), -cos(theta), 0)，与 RuneV2 观测方程一致
+    double theta = rm::tf_rotation2armoryaw(rotate_world);
+    Eigen::Vector3d d = (target_world - center_world).head<3>();
+    double horizontal = d[0] * sin(theta) - d[1] * cos(theta);
+    double angle = atan2(d[2], horizontal);
+
+    pose << target_world[0], target_world[1], target_world[2], theta, angle;
+    return pose.allFinite();
+}
+
+double rm::getYawPnPSeed(
+    const double yaw,
+    const double armor_yaw
+) {
+    // 装甲板法向与陀螺仪yaw的差值，归一化到[-pi/2, pi/2]
+    double append_yaw = armor_yaw - yaw;
+    append_yaw = atan2(sin(append_yaw), cos(append_yaw));
+    if (append_yaw > M_PI / 2) append_yaw -= M_PI;
+    if (append_yaw < -M_PI / 2) append_yaw += M_PI;
+    return std::clamp(append_yaw, -(M_PI / 2) + SEED_SEARCH_EPS, (M_PI / 2) - SEED_SEARCH_EPS);
+}
+
 void rm::displayYawPnP(YawPnP* yaw_pnp) {
     cv::Mat img_cost(500, 500, CV_8UC3, cv::Scalar(0, 0, 0));
 
@@ -89,17 +291,21 @@ void rm::displayYawPnP(YawPnP* yaw_pnp) {
     vector<double> angle_cost_list(250);
     vector<double> cost_list(250);
 
-    for (int i = 0; i < 250; i++) {
-        double app_yaw = i * step - M_PI / 2;
-
-        pixel_cost_list[i] = yaw_pnp->getPixelCost(app_yaw);
-        angle_cost_list[i] = yaw_pnp->getAngleCost(app_yaw);
+    for (int i = 0; i < 250; i += 10) {
+        Eigen::Matrix<double, 1, 10> app_yaw;
+        for (int j = 0; j < 10; j++) {
+            app_yaw(j) = (i + j) * step - M_PI / 2;
+        }
+        Eigen::Matrix<double, 1, 10> pixel_cost = yaw_pnp->getPixelCost<10>(app_yaw);
+        Eigen::Matrix<double, 1, 10> angle_cost = yaw_pnp->getAngleCost<10>(app_yaw);
 
-        max = std::max(max, pixel_cost_list[i]);
-        min = std::min(min, pixel_cost_list[i]);
+        for (int j = 0; j < 10; j++) {
+            pixel_cost_list[i + j] = pixel_cost(j);
+            angle_cost_list[i + j] = angle_cost(j);
+        }
 
-        max = std::max(max, angle_cost_list[i]);
-        min = std::min(min, angle_cost_list[i]);
+        max = std::max(max, std::max(pixel_cost.maxCoeff(), angle_cost.maxCoeff()));
+        min = std::min(min, std::min(pixel_cost.minCoeff(), angle_cost.minCoeff()));
     }
 
     for (int i = 0; i < 250; i++) {
@@ -146,24 +352,23 @@ void rm::displayYawPnP(YawPnP* yaw_pnp) {
 }
 
 void YawPnP::setWorldPoints(const std::vector<cv::Point3f>& object_points) { 
-    P_world.clear();
-    for (const auto& p : object_points) {
-        P_world.push_back(Eigen::Vector4d(0, -(p.x * 1e-3), -(p.y * 1e-3), 1));
+    world_valid = (object_points.size() == 4);
+    if (!world_valid) return;
+    for (int i = 0; i < 4; i++) {
+        P_world.col(i) << 0, -(object_points[i].x * 1e-3), -(object_points[i].y * 1e-3), 1;
     }
 }
 
 void YawPnP::setImagePoints(const std::vector<cv::Point2f>& image_points) { 
-    P_pixel.clear();
-    for (const auto& p : image_points) {
-        P_pixel.push_back(Eigen::Vector2d(p.x, p.y));
+    pixel_valid = (image_points.size() == 4);
+    if (!pixel_valid) return;
+    for (int i = 0; i < 4; i++) {
+        P_pixel.col(i) << image_points[i].x, image_points[i].y;
     }
 }
 
 double YawPnP::operator()(double append_yaw) const {
-    std::vector<Eigen::Vector4d> P_mapping = getMapping(append_yaw);
-    std::vector<Eigen::Vector2d> P_project = getProject(P_mapping);
-    double cost = getCost(P_project, append_yaw);
-    return cost;
+    return getCost(append_yaw);
 };
 
 ArmorElevation YawPnP::setElevation(rm::ArmorID armor_id) {
@@ -184,8 +389,7 @@ ArmorElevation YawPnP::setElevation(rm::ArmorID armor_id) {
             elevation = ARMOR_ELEVATION_UP_15;
             break;
     }
-    this->elevation = elevation;
-    return elevation;
+    return setElevation(elevation);
 }
 
 ArmorElevation YawPnP::setElevation(double pitch) {
@@ -197,15 +401,10 @@ ArmorElevation YawPnP::setElevation(double pitch) {
     } else {
         elevation = ARMOR_ELEVATION_UP_15;
     }
-    this->elevation = elevation;
-    return elevation;
+    return setElevation(elevation);
 }
 
-std::vector<Eigen::Vector4d> YawPnP::getMapping(double append_yaw) const {
-    Eigen::Matrix4d M;
-    std::vector<Eigen::Vector4d> P_mapping;
-
-    double yaw = sys_yaw + append_yaw;
+ArmorElevation YawPnP::setElevation(ArmorElevation elevation) {
     double pitch;
     switch(elevation) {
         case ARMOR_ELEVATION_UP_15:
@@ -222,51 +421,59 @@ std::vector<Eigen::Vector4d> YawPnP::getMapping(double append_yaw) const {
             break;
     }
 
-    pitch = -pitch;
-    M << cos(yaw) * cos(pitch), -sin(yaw), -sin(pitch) * cos(yaw), pose(0),
-         sin(yaw) * cos(pitch),  cos(yaw), -sin(pitch) * sin(yaw), pose(1),
-                    sin(pitch),         0,             cos(pitch), pose(2),
-                             0,         0,                      0,       1;
-    
-    for (const auto& p : P_world) {
-        P_mapping.push_back(M * p);
-    }
+    // 仰角只在这里计算一次三角函数，映射时直接使用
+    this->elevation = elevation;
+    this->elevation_sin = sin(-pitch);
+    this->elevation_cos = cos(-pitch);
+    return elevation;
+}
+
+YawPnP::Points4d YawPnP::getMapping(double append_yaw) const {
+    double yaw = sys_yaw + append_yaw;
+    double s = sin(yaw), c = cos(yaw);
+
+    // P_world第一行恒为0，映射只需要M的第二、三列
+    Eigen::Matrix<double, 4, 3> M;
+    M << -s, -elevation_sin * c, pose(0),
+          c, -elevation_sin * s, pose(1),
+          0,      elevation_cos, pose(2),
+          0,                  0,       1;
+
+    Points4d P_mapping;
+    P_mapping.noalias() = M * P_world.bottomRows<3>();
     return P_mapping;
 }
 
-std::vector<Eigen::Vector2d> YawPnP::getProject(const std::vector<Eigen::Vector4d>& P_world) const {
-    std::vector<Eigen::Vector2d> P_project;
-    for (const auto& p : P_world) {
-        Eigen::Vector3d p_camera = (T_inv * p).head(3);
-        Eigen::Vector3d p_project = Kc * p_camera;
-        P_project.push_back(p_project.head(2) / p_camera(2));
-    }
+YawPnP::Points2d YawPnP::getProject(const Points4d& P_world) const {
+    Eigen::Matrix<double, 3, 4> P_camera = Kc * (T_inv * P_world).topRows<3>();
+    Points2d P_project = P_camera.topRows<2>().array().rowwise() / P_camera.row(2).array();
     return P_project;
 }
 
-double YawPnP::getCost(const std::vector<Eigen::Vector2d>& P_project, double append_yaw) const {
-    if (P_pixel.size() != P_project.size() || P_project.size() < 4) return 0.0;
+double YawPnP::getCost(const Points2d& P_project, double append_yaw) const {
+    if (!world_valid || !pixel_valid) return 0.0;
     
-    int map[4] = {0, 1, 3, 2};
+    constexpr int map[4] = {0, 1, 3, 2};
 
+    double ratio = fabs((1 - exp(-append_yaw)) / (1 + exp(-append_yaw)));
     double cost = 0.0;
     for (int i = 0; i < 4; i++) {
         int index_this = map[i];
         int index_next = map[(i + 1) % 4];
-        Eigen::Vector2d pixel_line = P_pixel[index_next] - P_pixel[index_this];
-        Eigen::Vector2d project_line = P_project[index_next] - P_project[index_this];
-
-        double this_dist = (P_pixel[index_this] - P_project[index_this]).norm();
-        double next_dist = (P_pixel[index_next] - P_project[index_next]).norm();
-        double line_dist = fabs(pixel_line.norm() - project_line.norm());
+        Eigen::Vector2d pixel_line = P_pixel.col(index_next) - P_pixel.col(index_this);
+        Eigen::Vector2d project_line = P_project.col(index_next) - P_project.col(index_this);
 
-        double pixel_dist = (0.5 * (this_dist + next_dist) + line_dist) / pixel_line.norm();
+        double pixel_norm = pixel_line.norm();
+        double project_norm = project_line.norm();
+        double this_dist = (P_pixel.col(index_this) - P_project.col(index_this)).norm();
+        double next_dist = (P_pixel.col(index_next) - P_project.col(index_next)).norm();
+        double line_dist = fabs(pixel_norm - project_norm);
 
+        double pixel_dist = (0.5 * (this_dist + next_dist) + line_dist) / pixel_norm;
 
-        double cos_angle = pixel_line.dot(project_line) / (pixel_line.norm() * project_line.norm());
+        double cos_angle = pixel_line.dot(project_line) / (pixel_norm * project_norm);
         double angle_dist = fabs(acos(cos_angle)) * ANGLE_COST_RATIO;
 
-        double ratio = fabs((1 - exp(-append_yaw)) / (1 + exp(-append_yaw)));
         double cost_i = pow(pixel_dist * ratio, 2) + pow(angle_dist * (1 - ratio), 2);
         cost += sqrt(cost_i);
     }
@@ -274,39 +481,40 @@ double YawPnP::getCost(const std::vector<Eigen::Vector2d>& P_project, double app
     return cost; 
 }
 
-double YawPnP::getPixelCost(const std::vector<Eigen::Vector2d>& P_project, double append_yaw) const {
-    if (P_pixel.size() != P_project.size() || P_project.size() < 4) return 0.0;
+double YawPnP::getPixelCost(const Points2d& P_project) const {
+    if (!world_valid || !pixel_valid) return 0.0;
 
-    int map[4] = {0, 1, 3, 2};
+    constexpr int map[4] = {0, 1, 3, 2};
 
     double cost = 0.0;
     for (int i = 0; i < 4; i++) {
         int index_this = map[i];
         int index_next = map[(i + 1) % 4];
-        Eigen::Vector2d pixel_line = P_pixel[index_next] - P_pixel[index_this];
-        Eigen::Vector2d project_line = P_project[index_next] - P_project[index_this];
+        Eigen::Vector2d pixel_line = P_pixel.col(index_next) - P_pixel.col(index_this);
+        Eigen::Vector2d project_line = P_project.col(index_next) - P_project.col(index_this);
 
-        double this_dist = (P_pixel[index_this] - P_project[index_this]).norm();
-        double next_dist = (P_pixel[index_next] - P_project[index_next]).norm();
-        double line_dist = fabs(pixel_line.norm() - project_line.norm());
+        double pixel_norm = pixel_line.norm();
+        double this_dist = (P_pixel.col(index_this) - P_project.col(index_this)).norm();
+        double next_dist = (P_pixel.col(index_next) - P_project.col(index_next)).norm();
+        double line_dist = fabs(pixel_norm - project_line.norm());
 
-        double pixel_dist = (0.5 * (this_dist + next_dist) + line_dist) / pixel_line.norm();
+        double pixel_dist = (0.5 * (this_dist + next_dist) + line_dist) / pixel_norm;
         cost += pixel_dist;
     }
     return cost;
 }
 
-double YawPnP::getAngleCost(const std::vector<Eigen::Vector2d>& P_project, double append_yaw) const {
-    if (P_pixel.size() != P_project.size() || P_project.size() < 4) return 0.0;
+double YawPnP::getAngleCost(const Points2d& P_project) const {
+    if (!world_valid || !pixel_valid) return 0.0;
 
-    int map[4] = {0, 1, 3, 2};
+    constexpr int map[4] = {0, 1, 3, 2};
 
     double cost = 0.0;
     for (int i = 0; i < 4; i++) {
         int index_this = map[i];
         int index_next = map[(i + 1) % 4];
-        Eigen::Vector2d pixel_line = P_pixel[index_next] - P_pixel[index_this];
-        Eigen::Vector2d project_line = P_project[index_next] - P_project[index_this];
+        Eigen::Vector2d pixel_line = P_pixel.col(index_next) - P_pixel.col(index_this);
+        Eigen::Vector2d project_line = P_project.col(index_next) - P_project.col(index_this);
 
         double cos_angle = pixel_line.dot(project_line) / (pixel_line.norm() * project_line.norm());
         double angle_dist = fabs(acos(cos_angle));
@@ -317,24 +525,15 @@ double YawPnP::getAngleCost(const std::vector<Eigen::Vector2d>& P_project, doubl
 }
 
 double YawPnP::getCost(double append_yaw) const {
-    std::vector<Eigen::Vector4d> P_mapping = getMapping(append_yaw);
-    std::vector<Eigen::Vector2d> P_project = getProject(P_mapping);
-    double cost = getCost(P_project, append_yaw);
-    return cost;
+    return getCost(getProject(getMapping(append_yaw)), append_yaw);
 }
 
 double YawPnP::getPixelCost(double append_yaw) const {
-    std::vector<Eigen::Vector4d> P_mapping = getMapping(append_yaw);
-    std::vector<Eigen::Vector2d> P_project = getProject(P_mapping);
-    double cost = getPixelCost(P_project, append_yaw);
-    return cost;
+    return getPixelCost(getProject(getMapping(append_yaw)));
 }
 
 double YawPnP::getAngleCost(double append_yaw) const {
-    std::vector<Eigen::Vector4d> P_mapping = getMapping(append_yaw);
-    std::vector<Eigen::Vector2d> P_project = getProject(P_mapping);
-    double cost = getAngleCost(P_project, append_yaw);
-    return cost;
+    return getAngleCost(getProject(getMapping(append_yaw)));
 }
 
 double YawPnP::getYawByPixelCost(double left, double right, double epsilon) const {
@@ -371,6 +570,16 @@ double YawPnP::getYawByAngleCost(double left, double right, double epsilon) cons
     return (left + right) / 2;
 }
 
+double YawPnP::getYawByPixelCost(double left, double right, double seed, double epsilon) const {
+    auto func = [this](double append_yaw) { return getPixelCost(append_yaw); };
+    return searchFromSeed(left, right, seed, func, epsilon);
+}
+
+double YawPnP::getYawByAngleCost(double left, double right, double seed, double epsilon) const {
+    auto func = [this](double append_yaw) { return getAngleCost(append_yaw); };
+    return searchFromSeed(left, right, seed, func, epsilon);
+}
+
 double YawPnP::getYawByMix(double pixel_yaw, double angle_yaw) const {
     double mid = 0.3;
     double len = 0.1;
@@ -0,0 +1,241 @@
+#include "solver/solvevehicle.h"
+#include "utils/timer.h"
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cmath>
+using namespace rm;
+using namespace std;
+
+// [ cx, cy, yaw, r0, r1, z0, z1 ]
+// [ 0,  1,  2,   3,  4,  5,  6  ]
+
+static constexpr int VEHICLE_PARAM = 7;
+static constexpr int VEHICLE_RESIDUAL_MAX = 8 * VEHICLE_ARMOR_MAX + 3;
+
+typedef Eigen::Matrix<double, VEHICLE_PARAM, 1> VehicleParam;
+typedef Eigen::Matrix<double, Eigen::Dynamic, 1, 0, VEHICLE_RESIDUAL_MAX, 1> VehicleResidual;
+typedef Eigen::Matrix<double, Eigen::Dynamic, VEHICLE_PARAM, 0, VEHICLE_RESIDUAL_MAX, VEHICLE_PARAM> VehicleJacobian;
+
+static double VEHICLE_RADIUS_INIT  = 0.25;      // 半径初值 m
+static double VEHICLE_RADIUS_MIN   = 0.15;      // 半径下限 m
+static double VEHICLE_RADIUS_MAX   = 0.40;      // 半径上限 m
+static double VEHICLE_RADIUS_PRIOR = 20.0;      // 半径先验权重 pixel/m
+static double VEHICLE_HEIGHT_PRIOR = 20.0;      // 不可观测时两组高度相等的先验权重 pixel/m
+static double VEHICLE_TIE_WEIGHT   = 2000.0;    // 两组装甲板参数相同时的约束权重 pixel/m
+static double VEHICLE_STEP_EPS     = 1e-6;      // 收敛步长
+static double VEHICLE_COST_EPS     = 1e-8;      // 收敛的代价相对下降量
+
+struct VehicleProblem {
+    YawPnP pnp[VEHICLE_ARMOR_MAX];              // 各装甲板的投影模型
+    int    index[VEHICLE_ARMOR_MAX];            // 各装甲板相对参考装甲板的序号
+    int    toggle[VEHICLE_ARMOR_MAX];           // 各装甲板所属的半径组
+    int    size;                                // 装甲板数量
+    int    armor_num;                           // 车体装甲板数量
+    bool   tie;                                 // 两组装甲板是否共用半径与高度
+    bool   observe[2];                          // 两组装甲板是否被观测到
+
+    int getResidualSize() const { return 8 * size + 3; }
+
+    void getResidual(const VehicleParam& x, VehicleResidual& res) {
+        double step = 2 * M_PI / armor_num;
+        for (int i = 0; i < size; i++) {
+            int t = toggle[i];
+            double yaw = x(2) + index[i] * step;
+            YawPnP& armor = pnp[i];
+            armor.sys_yaw = yaw;
+            armor.pose << x(0) - x(3 + t) * cos(yaw), x(1) - x(3 + t) * sin(yaw), x(5 + t), 1;
+            YawPnP::Points2d P_error = armor.getProject(armor.getMapping(0)) - armor.P_pixel;
+            res.segment<8>(8 * i) = Eigen::Map<const Eigen::Matrix<double, 8, 1>>(P_error.data());
+        }
+
+        // 半径弱先验保证单组观测时问题非奇异，两组未同时观测时高度也向同一值收敛
+        int k = 8 * size;
+        double tie_r = tie ? VEHICLE_TIE_WEIGHT : 0.0;
+        double tie_z = tie ? VEHICLE_TIE_WEIGHT : ((observe[0] && observe[1]) ? 0.0 : VEHICLE_HEIGHT_PRIOR);
+        res(k + 0) = (x(3) + x(4) - 2 * VEHICLE_RADIUS_INIT) * VEHICLE_RADIUS_PRIOR;
+        res(k + 1) = (x(4) - x(3)) * std::max(tie_r, VEHICLE_RADIUS_PRIOR);
+        res(k + 2) = (x(6) - x(5)) * tie_z;
+    }
+};
+
+static double getSafeAngle(double angle) {
+    return atan2(sin(angle), cos(angle));
+}
+
+bool rm::getVehicleArmor(
+    const Armor& armor,
+    const Target& target,
+    const std::vector<cv::Point3f>& small_object_points,
+    const std::vector<cv::Point3f>& big_object_points,
+    VehicleArmor& vehicle_armor
+) {
+    const std::vector<cv::Point3f>& object_points =
+        (armor.size == ARMOR_SIZE_BIG_ARMOR) ? big_object_points : small_object_points;
+
+    YawPnP yaw_pnp;
+    yaw_pnp.setWorldPoints(object_points);
+    yaw_pnp.setImagePoints(armor.four_points);
+    if (!yaw_pnp.world_valid || !yaw_pnp.pixel_valid) return false;
+
+    vehicle_armor.P_world = yaw_pnp.P_world;
+    vehicle_armor.P_pixel = yaw_pnp.P_pixel;
+    vehicle_armor.elevation = target.armor_elevation;
+    vehicle_armor.pose = target.pose_world;
+    vehicle_armor.yaw = target.armor_yaw_world;
+    return true;
+}
+
+bool rm::solveVehiclePnP(
+    const YawPnPShared& shared,
+    const std::vector<VehicleArmor>& armors,
+    VehiclePose& vehicle,
+    int armor_num,
+    double time_budget,
+    int max_iter
+) {
+    vehicle.converged = false;
+    vehicle.iterations = 0;
+    if (armors.empty() || armors.size() > VEHICLE_ARMOR_MAX) return false;
+    if (armor_num < 2 || armor_num > VEHICLE_ARMOR_MAX) return false;
+
+    TimePoint begin = getTime();
+    double step = 2 * M_PI / armor_num;
+
+    VehicleProblem problem;
+    problem.size = static_cast<int>(armors.size());
+    problem.armor_num = armor_num;
+    problem.tie = (armor_num != 4);
+    problem.observe[0] = problem.observe[1] = false;
+
+    // 根据单装甲板朝向确定各装甲板在车体上的序号，同一序号出现两次说明输入有误
+    double yaw_sin = 0.0, yaw_cos = 0.0;
+    for (int i = 0; i < problem.size; i++) {
+        int index = static_cast<int>(lround(getSafeAngle(armors[i].yaw - armors[0].yaw) / step));
+        for (int j = 0; j < i; j++) {
+            if (problem.index[j] == index) return false;
+        }
+        problem.index[i] = index;
+        problem.toggle[i] = problem.tie ? 0 : (std::abs(index) % 2);
+        problem.observe[problem.toggle[i]] = true;
+
+        double ref_yaw = armors[i].yaw - index * step;
+        yaw_sin += sin(ref_yaw);
+        yaw_cos += cos(ref_yaw);
+
+        YawPnP& pnp = problem.pnp[i];
+        pnp.P_world = armors[i].P_world;
+        pnp.P_pixel = armors[i].P_pixel;
+        pnp.setElevation(armors[i].elevation);
+        pnp.Kc = shared.Kc;
+        pnp.T = shared.T;
+        pnp.T_inv = shared.T_inv;
+    }
+
+    // 初值：参考朝向取圆周平均，中心取各装甲板沿法向后推半径的平均
+    VehicleParam x;
+    x(2) = atan2(yaw_sin, yaw_cos);
+    x(3) = x(4) = VEHICLE_RADIUS_INIT;
+    double cx = 0.0, cy = 0.0, z_sum[2] = {0.0, 0.0};
+    int z_num[2] = {0, 0};
+    for (int i = 0; i < problem.size; i++) {
+        double yaw = x(2) + problem.index[i] * step;
+        cx += armors[i].pose(0) + VEHICLE_RADIUS_INIT * cos(yaw);
+        cy += armors[i].pose(1) + VEHICLE_RADIUS_INIT * sin(yaw);
+        z_sum[problem.toggle[i]] += armors[i].pose(2);
+        z_num[problem.toggle[i]]++;
+    }
+    x(0) = cx / problem.size;
+    x(1) = cy / problem.size;
+    double z_mean = (z_sum[0] + z_sum[1]) / problem.size;
+    x(5) = z_num[0] > 0 ? z_sum[0] / z_num[0] : z_mean;
+    x(6) = z_num[1] > 0 ? z_sum[1] / z_num[1] : z_mean;
+
+    // Levenberg-Marquardt，数值雅可比
+    int m = problem.getResidualSize();
+    VehicleResidual res(m), res_new(m), res_step(m);
+    VehicleJacobian J(m, VEHICLE_PARAM);
+    problem.getResidual(x, res);
+    double cost = res.squaredNorm();
+    double lambda = 1e-3;
+
+    int iter = 0;
+    for (; iter < max_iter; iter++) {
+        if (getDoubleOfS(begin, getTime()) > time_budget) break;
+
+        for (int k = 0; k < VEHICLE_PARAM; k++) {
+            double h = 1e-6 * std::max(1.0, std::fabs(x(k)));
+            VehicleParam x_step = x;
+            x_step(k) += h;
+            problem.getResidual(x_step, res_step);
+            J.col(k) = (res_step - res) / h;
+        }
+
+        Eigen::Matrix<double, VEHICLE_PARAM, VEHICLE_PARAM> JtJ = J.transpose() * J;
+        VehicleParam Jtr = J.transpose() * res;
+
+        bool accepted = false;
+        double cost_old = cost;
+        VehicleParam delta = VehicleParam::Zero();
+        while (lambda < 1e8) {
+            Eigen::Matrix<double, VEHICLE_PARAM, VEHICLE_PARAM> A = JtJ;
+            A.diagonal() += lambda * (JtJ.diagonal().array() + 1e-9).matrix();
+            delta = A.ldlt().solve(-Jtr);
+
+            VehicleParam x_new = x + delta;
+            x_new(3) = std::clamp(x_new(3), VEHICLE_RADIUS_MIN, VEHICLE_RADIUS_MAX);
+            x_new(4) = std::clamp(x_new(4), VEHICLE_RADIUS_MIN, VEHICLE_RADIUS_MAX);
+            problem.getResidual(x_new, res_new);
+            double cost_new = res_new.squaredNorm();
+
+            if (cost_new < cost) {
+                delta = x_new - x;
+                x = x_new;
+                res = res_new;
+                cost = cost_new;
+                lambda = std::max(lambda / 3.0, 1e-7);
+                accepted = true;
+                break;
+            }
+            lambda *= 4.0;
+        }
+
+        // 无法下降说明求解停滞，不视为收敛；只有步长或代价下降足够小才算收敛
+        if (!accepted) {
+            iter++;
+            break;
+        }
+        if ((delta.norm() < VEHICLE_STEP_EPS) || (cost_old - cost < VEHICLE_COST_EPS * cost_old)) {
+            vehicle.converged = true;
+            iter++;
+            break;
+        }
+    }
+
+    vehicle.yaw = getSafeAngle(x(2));
+    vehicle.r[0] = x(3);
+    vehicle.r[1] = x(4);
+    vehicle.z[0] = x(5);
+    vehicle.z[1] = x(6);
+    vehicle.center << x(0), x(1), (problem.observe[0] && problem.observe[1]) ? (x(5) + x(6)) / 2 : x(5 + problem.toggle[0]);
+    for (int i = 0; i < VEHICLE_ARMOR_MAX; i++) {
+        vehicle.index[i] = (i < problem.size) ? problem.index[i] : 0;
+    }
+    vehicle.armor_num = armor_num;
+    vehicle.iterations = iter;
+    vehicle.cost = std::sqrt(res.head(8 * problem.size).squaredNorm() / (4 * problem.size));
+    return true;
+}
+
+Eigen::Vector4d rm::getVehicleArmorPose(
+    const VehiclePose& vehicle,
+    int index
+) {
+    int toggle = (vehicle.armor_num == 4) ? (std::abs(index) % 2) : 0;
+    double yaw = getSafeAngle(vehicle.yaw + index * 2 * M_PI / vehicle.armor_num);
+    double r = vehicle.r[toggle];
+    return Eigen::Vector4d(
+        vehicle.center(0) - r * cos(yaw),
+        vehicle.center(1) - r * sin(yaw),
+        vehicle.z[toggle],
+        yaw);
+}
@@ -0,0 +1,71 @@
+#include "tensorrt/calibrator.h"
+#include "uniterm/uniterm.h"
+#include <cuda_runtime_api.h>
+#include <fstream>
+#include <iterator>
+using namespace rm;
+
+Int8Calibrator::Int8Calibrator(
+    const std::string& calib_dir,
+    const std::string& cache_file,
+    const std::string& input_name,
+    int input_width,
+    int input_height,
+    int batch_size,
+    int max_num
+) :
+    loader_(calib_dir, input_width, input_height, batch_size, max_num),
+    cache_file_(cache_file),
+    input_name_(input_name) {
+    host_buffer_.resize(loader_.getBatchLength());
+    cudaMalloc(&device_buffer_, host_buffer_.size() * sizeof(float));
+}
+
+Int8Calibrator::~Int8Calibrator() {
+    if (device_buffer_ != nullptr) {
+        cudaFree(device_buffer_);
+    }
+}
+
+int32_t Int8Calibrator::getBatchSize() const noexcept {
+    return loader_.getBatchSize();
+}
+
+bool Int8Calibrator::getBatch(void* bindings[], char const* names[], int32_t nb_bindings) noexcept {
+    if (!loader_.next(host_buffer_.data())) {
+        return false;
+    }
+    cudaMemcpy(device_buffer_, host_buffer_.data(), host_buffer_.size() * sizeof(float), cudaMemcpyHostToDevice);
+
+    for (int32_t i = 0; i < nb_bindings; i++) {
+        if (input_name_ == names[i]) {
+            bindings[i] = device_buffer_;
+            return true;
+        }
+    }
+    bindings[0] = device_buffer_;
+    return true;
+}
+
+void const* Int8Calibrator::readCalibrationCache(size_t& length) noexcept {
+    cache_.clear();
+    std::ifstream file(cache_file_, std::ios::binary);
+    if (file.good()) {
+        cache_.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    length = cache_.size();
+    if (length > 0) {
+        rm::message("TensorRT INT8 calibration cache hit", rm::MSG_OK);
+    }
+    return length > 0 ? cache_.data() : nullptr;
+}
+
+void Int8Calibrator::writeCalibrationCache(void const* cache, size_t length) noexcept {
+    std::ofstream file(cache_file_, std::ios::binary);
+    if (!file.is_open()) {
+        rm::message("TensorRT INT8 : failed to write " + cache_file_, rm::MSG_ERROR);
+        return;
+    }
+    file.write(static_cast<const char*>(cache), length);
+    rm::message("TensorRT INT8 calibration cache saved", rm::MSG_OK);
+}
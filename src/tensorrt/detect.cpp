@@ -0,0 +1,58 @@
+#include "tensorrt/tensorrt.h"
+#include "infer/calib.h"
+#include "uniterm/uniterm.h"
+#include <cuda_runtime_api.h>
+#include <vector>
+using namespace rm;
+
+bool rm::detectDirectory(
+    nvinfer1::IExecutionContext** context,
+    const std::string& image_dir,
+    const DetectNMS& nms,
+    DetectList& detections,
+    size_t output_struct_size,
+    int bboxes_num,
+    int infer_width,
+    int infer_height,
+    int max_num
+) {
+    std::vector<std::string> files;
+    if (!getImageFiles(image_dir, files, max_num) || files.empty()) {
+        rm::message("Detect : no frames in " + image_dir, rm::MSG_ERROR);
+        return false;
+    }
+
+    cudaStream_t stream;
+    if (!initCudaStream(&stream)) return false;
+
+    float* input_device_buffer = nullptr;
+    float* output_device_buffer = nullptr;
+    float* output_host_buffer = nullptr;
+    mallocYoloDetectBuffer(
+        &input_device_buffer, &output_device_buffer, &output_host_buffer,
+        infer_width, infer_height, output_struct_size, bboxes_num);
+    std::vector<float> input_host_buffer(static_cast<size_t>(3) * infer_width * infer_height);
+
+    // 与校准使用同一CPU预处理，读取失败的帧保留为空，保证各精度结果逐帧对齐
+    detections.assign(files.size(), std::vector<YoloRect>());
+    for (size_t i = 0; i < files.size(); i++) {
+        cv::Mat img = cv::imread(files[i], cv::IMREAD_COLOR);
+        if (img.empty()) {
+            rm::message("Detect : failed to read " + files[i], rm::MSG_WARNING);
+            continue;
+        }
+        letterbox(img, input_host_buffer.data(), infer_width, infer_height);
+        cudaMemcpyAsync(
+            input_device_buffer, input_host_buffer.data(),
+            input_host_buffer.size() * sizeof(float), cudaMemcpyHostToDevice, stream);
+
+        detectEnqueue(input_device_buffer, output_device_buffer, context, &stream);
+        detectOutput(output_host_buffer, output_device_buffer, &stream, output_struct_size, bboxes_num);
+        detections[i] = nms(output_host_buffer, img.cols, img.rows);
+    }
+
+    freeYoloDetectBuffer(input_device_buffer, output_device_buffer, output_host_buffer);
+    cudaStreamDestroy(stream);
+    rm::message("Detect frames : " + std::to_string(files.size()), rm::MSG_NOTE);
+    return true;
+}
@@ -1,5 +1,8 @@
 #include "tensorrt/tensorrt.h"
+#include "tensorrt/calibrator.h"
 #include "uniterm/uniterm.h"
+#include <algorithm>
+#include <memory>
 #include <iostream>
 #include <fstream>
 #include <unistd.h>
@@ -7,6 +10,152 @@
 using namespace nvinfer1;
 using namespace nvonnxparser;
 
+static bool deserializeTrtEngine(
+    const void* data,
+    size_t size,
+    IExecutionContext** context
+) {
+    static Logger logger;
+
+    // 运行时与引擎需要在上下文的整个生命周期内保持有效
+    auto runtime = createInferRuntime(logger);
+    if (!runtime) {
+        rm::message("TensorRT : failed to create runtime", rm::MSG_ERROR);
+        return false;
+    }
+
+    // 反序列化引擎 (TensorRT 10.x removed the third parameter)
+    auto engine = runtime->deserializeCudaEngine(data, size);
+    if (!engine) {
+        delete runtime;
+        return false;
+    }
+
+    // 创建推理上下文, 失败时释放引擎与运行时
+    *context = engine->createExecutionContext();
+    if (!(*context)) {
+        delete engine;
+        delete runtime;
+        return false;
+    }
+    return true;
+}
+
+// 输入的批维度为动态时按最大批大小建立优化配置, 批维度固定时只能构建该批大小
+static bool setTrtBatchProfile(
+    IBuilder* infer_builder,
+    INetworkDefinition* network,
+    IBuilderConfig* config,
+    unsigned int batch_size
+) {
+    IOptimizationProfile* profile = nullptr;
+    int max_batch = static_cast<int>(std::max(batch_size, 1U));
+    for (int i = 0; i < network->getNbInputs(); i++) {
+        ITensor* input = network->getInput(i);
+        Dims dims = input->getDimensions();
+        if (dims.nbDims < 1) continue;
+        if (dims.d[0] >= 0) {
+            if (dims.d[0] != max_batch) {
+                rm::message("TensorRT : ONNX input " + std::string(input->getName()) + " has fixed batch "
+                            + std::to_string(dims.d[0]), rm::MSG_WARNING);
+            }
+            continue;
+        }
+
+        if (!profile) profile = infer_builder->createOptimizationProfile();
+        if (!profile) return false;
+        Dims dims_min = dims, dims_max = dims;
+        for (int j = 1; j < dims.nbDims; j++) {
+            if (dims.d[j] < 0) {
+                rm::message("TensorRT : only the batch dimension may be dynamic", rm::MSG_ERROR);
+                return false;
+            }
+        }
+        dims_min.d[0] = 1;
+        dims_max.d[0] = max_batch;
+        profile->setDimensions(input->getName(), OptProfileSelector::kMIN, dims_min);
+        profile->setDimensions(input->getName(), OptProfileSelector::kOPT, dims_max);
+        profile->setDimensions(input->getName(), OptProfileSelector::kMAX, dims_max);
+    }
+    if (!profile) return true;
+
+    // INT8 校准同样按该配置给出输入形状
+    if (config->addOptimizationProfile(profile) < 0) return false;
+    return config->setCalibrationProfile(profile);
+}
+
+static bool buildTrtSerialized(
+    const std::string& onnx_file,
+    rm::EnginePrecision precision,
+    unsigned int batch_size,
+    const std::string& calib_dir,
+    const std::string& calib_file,
+    IHostMemory** serialized_engine
+) {
+    Logger logger;
+    auto infer_builder = createInferBuilder(logger);
+    if (!infer_builder) return false;
+
+    const auto explicit_batch = 1U
+        << static_cast<uint32_t>(NetworkDefinitionCreationFlag::kEXPLICIT_BATCH);
+    auto network = infer_builder->createNetworkV2(explicit_batch);
+    auto parser = network ? nvonnxparser::createParser(*network, logger) : nullptr;
+    auto config = infer_builder->createBuilderConfig();
+
+    bool ok = network && parser && config
+        && parser->parseFromFile(onnx_file.c_str(), static_cast<int>(ILogger::Severity::kINFO))
+        && setTrtBatchProfile(infer_builder, network, config, batch_size);
+
+    if (ok) {
+        switch (precision) {
+            case rm::ENGINE_FP16:
+                if (infer_builder->platformHasFastFp16()) {
+                    config->setFlag(BuilderFlag::kFP16);
+                }
+                break;
+            case rm::ENGINE_INT8:
+                if (!infer_builder->platformHasFastInt8()) {
+                    rm::message("TensorRT : platform has no fast INT8", rm::MSG_WARNING);
+                }
+                if (infer_builder->platformHasFastFp16()) {
+                    config->setFlag(BuilderFlag::kFP16);
+                }
+                config->setFlag(BuilderFlag::kINT8);
+                break;
+            default:
+                break;
+        }
+    }
+
+    // INT8 校准器需要在构建期间保持有效
+    std::unique_ptr<rm::Int8Calibrator> calibrator;
+    if (ok && precision == rm::ENGINE_INT8 && calib_dir.empty() && access(calib_file.c_str(), F_OK) != 0) {
+        rm::message("TensorRT : INT8 engine requires calibration frames", rm::MSG_ERROR);
+        ok = false;
+    }
+    if (ok && precision == rm::ENGINE_INT8) {
+        ITensor* input = network->getInput(0);
+        Dims dims = input->getDimensions();
+        calibrator.reset(new rm::Int8Calibrator(
+            calib_dir, calib_file, input->getName(),
+            static_cast<int>(dims.d[dims.nbDims - 1]),
+            static_cast<int>(dims.d[dims.nbDims - 2]),
+            static_cast<int>(batch_size)));
+        config->setInt8Calibrator(calibrator.get());
+    }
+
+    if (ok) {
+        *serialized_engine = infer_builder->buildSerializedNetwork(*network, *config);
+        ok = (*serialized_engine != nullptr) && ((*serialized_engine)->size() > 0);
+    }
+
+    delete parser;
+    delete network;
+    delete config;
+    delete infer_builder;
+    return ok;
+}
+
 bool rm::initTrtOnnx(
     const std::string& onnx_file,
     const std::string& engine_file,
@@ -30,8 +179,8 @@ bool rm::initTrtOnnx(
         const auto explicit_batch = 1U
             << static_cast<uint32_t>(NetworkDefinitionCreationFlag::kEXPLICIT_BATCH);
 
-        // 创建网络对象，设置批处理大小
-        auto network = infer_builder->createNetworkV2(explicit_batch | batch_size);
+        // 创建网络对象，批大小由优化配置给出
+        auto network = infer_builder->createNetworkV2(explicit_batch);
         if (!network) {
             throw std::runtime_error("Failed to create TensorRT network.");
         }
@@ -54,6 +203,9 @@ bool rm::initTrtOnnx(
         if (infer_builder->platformHasFastFp16()) {
             config->setFlag(BuilderFlag::kFP16);
         }
+        if (!setTrtBatchProfile(infer_builder, network, config, batch_size)) {
+            throw std::runtime_error("Failed to set TensorRT batch profile.");
+        }
 
         // 创建推理引擎
         auto engine = infer_builder->buildEngineWithConfig(*network, *config);
@@ -72,13 +224,18 @@ bool rm::initTrtOnnx(
         if (!file) {
             throw std::runtime_error("Failed to open engine file for writing.");
         }
+        auto serialized_engine = engine->serialize();
+        if (!serialized_engine) {
+            throw std::runtime_error("Failed to serialize TensorRT engine.");
+        }
         file.write(
-            reinterpret_cast<const char*>(engine->serialize()->data()),
-            engine->serialize()->size()
+            reinterpret_cast<const char*>(serialized_engine->data()),
+            serialized_engine->size()
         );
         file.close();
 
         // 释放资源 (TensorRT 10.x uses delete instead of destroy())
+        delete serialized_engine;
         delete parser;
         delete network;
         delete infer_builder;
@@ -105,54 +262,98 @@ bool rm::initTrtEngine(
     const std::string& engine_file,
     nvinfer1::IExecutionContext** context
 ) {
+    EngineCache cache;
     try {
         // 检查引擎文件是否存在
         if(access(engine_file.c_str(), F_OK) != 0) {
             throw std::runtime_error("Engine file not found.");
         }
 
-        // 读取引擎文件
-        std::ifstream file(engine_file, std::ios::binary);
-        if (!file.is_open()) {
-            throw std::runtime_error("Failed to open engine file for reading.");
+        // 映射引擎文件，避免整体拷贝到堆上
+        if (!mapEngineFile(engine_file, cache)) {
+            throw std::runtime_error("Failed to map engine file for reading.");
+        }
+
+        if (!deserializeTrtEngine(cache.data, cache.size, context)) {
+            throw std::runtime_error("Failed to deserialize TensorRT engine.");
         }
 
-        size_t size = 0;
-        file.seekg(0, std::ios::end);
-        size = file.tellg();
-        file.seekg(0, std::ios::beg);
-        char* serialized_engine = new char[size];
+        // 释放资源
+        unmapEngineCache(cache);
+        rm::message("TensorRT Engine OK", rm::MSG_OK);
+        return true;
 
-        file.read(serialized_engine, size);
-        file.close();
+    } catch (const std::exception& e) {
+        std::string error_message = e.what();
+        rm::message("TensoRT Engine : " + error_message, rm::MSG_ERROR);
+        unmapEngineCache(cache);
+        if (*context) {
+            delete *context;
+            *context = nullptr;
+        }
+        return false;
+    }
+}
 
-        // 创建 TensorRT 运行时
-        Logger logger;
-        auto runtime = createInferRuntime(logger);
-        if (!runtime) {
-            throw std::runtime_error("Failed to create TensorRT runtime.");
+bool rm::initTrtCache(
+    const std::string& onnx_file,
+    const std::string& cache_dir,
+    nvinfer1::IExecutionContext** context,
+    EnginePrecision precision,
+    unsigned int batch_size,
+    const std::string& calib_dir
+) {
+    EngineCache cache;
+    try {
+        // 检查ONNX文件是否存在
+        if(access(onnx_file.c_str(), F_OK) != 0) {
+            throw std::runtime_error("ONNX file not found.");
         }
 
-        // 反序列化引擎 (TensorRT 10.x removed the third parameter)
-        auto engine = runtime->deserializeCudaEngine(serialized_engine, size);
-        if (!engine) {
-            throw std::runtime_error("Failed to deserialize TensorRT engine.");
+        // 缓存键: ONNX内容哈希 + 精度 + 最大批大小 + TensorRT版本
+        EngineCacheKey key;
+        uint64_t lib_version = static_cast<uint64_t>(getInferLibVersion());
+        if (!getEngineCacheKey(onnx_file, precision, batch_size, lib_version, key)) {
+            throw std::runtime_error("Failed to hash ONNX file.");
+        }
+        std::string cache_file = getEngineCachePath(cache_dir, onnx_file, key);
+
+        // 命中缓存时直接映射并反序列化
+        if (mapEngineCache(cache_file, key, cache)) {
+            bool ok = deserializeTrtEngine(cache.data, cache.size, context);
+            unmapEngineCache(cache);
+            if (ok) {
+                rm::message("TensorRT Engine cache hit", rm::MSG_OK);
+                return true;
+            }
+            unlink(cache_file.c_str());
+            rm::message("TensorRT Engine cache broken, rebuild", rm::MSG_WARNING);
         }
 
-        // 创建推理上下文
-        *context = engine->createExecutionContext();
-        if (!(*context)) {
-            throw std::runtime_error("Failed to create TensorRT execution context.");
+        // 未命中时重新构建并写入缓存，同时清理同一模型由旧版本推理库构建的缓存
+        IHostMemory* serialized_engine = nullptr;
+        std::string calib_file = cache_file.substr(0, cache_file.rfind('.')) + ".calib";
+        if (!buildTrtSerialized(onnx_file, precision, batch_size, calib_dir, calib_file, &serialized_engine)) {
+            throw std::runtime_error("Failed to build TensorRT engine.");
+        }
+        if (!writeEngineCache(cache_file, key, serialized_engine->data(), serialized_engine->size())) {
+            rm::message("TensorRT : engine cache not saved, next start rebuilds", rm::MSG_WARNING);
         }
+        clearEngineCache(cache_dir, onnx_file, key);
 
-        // 释放资源
-        delete[] serialized_engine;
-        rm::message("TensorRT Engine OK", rm::MSG_OK);
+        bool ok = deserializeTrtEngine(serialized_engine->data(), serialized_engine->size(), context);
+        delete serialized_engine;
+        if (!ok) {
+            throw std::runtime_error("Failed to deserialize TensorRT engine.");
+        }
+
+        rm::message("TensorRT Engine cache built " + getPrecisionStr(precision), rm::MSG_OK);
         return true;
 
     } catch (const std::exception& e) {
         std::string error_message = e.what();
-        rm::message("TensoRT Engine : " + error_message, rm::MSG_ERROR);
+        rm::message("TensoRT Cache : " + error_message, rm::MSG_ERROR);
+        unmapEngineCache(cache);
         if (*context) {
             delete *context;
             *context = nullptr;
@@ -3,49 +3,193 @@
 #include <cmath>
 using namespace std;
 
+constexpr double GRAVITY = 9.8;
+constexpr double BALLISTIC_STEP = 1e-2;         // RK4 积分步长
+constexpr double BALLISTIC_TIME_MAX = 5.0;      // 最长积分时间
+constexpr double BALLISTIC_TOLERANCE = 1e-4;    // 落点高度误差
+
+// 无阻力抛物线, 超出射程时返回 false
+static bool getParabolaDelay(double& pitch, double& t, const double speed, const double d, const double h) {
+    if (d <= 0.0) {
+        pitch = (h >= 0.0) ? M_PI / 2 : -M_PI / 2;
+        t = fabs(h) / speed;
+        return true;
+    }
+
+    // 低弹道闭式解 tan(pitch) = (v^2 - sqrt(v^4 - g(g d^2 + 2 h v^2))) / (g d)
+    // 不动点迭代在近距离大高差时不收敛, 不可达时判别式小于 0
+    double v2 = speed * speed;
+    double disc = v2 * v2 - GRAVITY * (GRAVITY * d * d + 2 * h * v2);
+    if (disc < 0.0) {
+        pitch = 0.0;
+        t = d / speed;
+        return false;
+    }
+    pitch = atan((v2 - sqrt(disc)) / (GRAVITY * d));
+    t = d / (speed * cos(pitch));
+    return true;
+}
+
+double rm::getFlyTrajectory(
+    double& height,
+    const double speed,
+    const double pitch,
+    const double distance,
+    const double drag_k
+) {
+    height = 0.0;
+    if (distance <= 0.0) return 0.0;
+
+    // [ x, z, vx, vz ]
+    auto deriv = [drag_k](const double s[4], double ds[4]) {
+        double v = sqrt(s[2] * s[2] + s[3] * s[3]);
+        ds[0] = s[2];
+        ds[1] = s[3];
+        ds[2] = -drag_k * v * s[2];
+        ds[3] = -GRAVITY - drag_k * v * s[3];
+    };
+
+    double s[4] = {0.0, 0.0, speed * cos(pitch), speed * sin(pitch)};
+    double k1[4], k2[4], k3[4], k4[4], tmp[4];
+    const double h = BALLISTIC_STEP;
+
+    for (double t = 0.0; t < BALLISTIC_TIME_MAX; t += h) {
+        if (s[2] <= 0.0) return -1.0;
+
+        deriv(s, k1);
+        for (int i = 0; i < 4; i++) tmp[i] = s[i] + 0.5 * h * k1[i];
+        deriv(tmp, k2);
+        for (int i = 0; i < 4; i++) tmp[i] = s[i] + 0.5 * h * k2[i];
+        deriv(tmp, k3);
+        for (int i = 0; i < 4; i++) tmp[i] = s[i] + h * k3[i];
+        deriv(tmp, k4);
+
+        double next[4];
+        for (int i = 0; i < 4; i++) next[i] = s[i] + h / 6.0 * (k1[i] + 2 * k2[i] + 2 * k3[i] + k4[i]);
+
+        // 越过目标距离时在本步内三次 Hermite 插值, 线性初值再做一次牛顿修正
+        if (next[0] >= distance) {
+            auto hermite = [h](double r, double p0, double v0, double p1, double v1) {
+                double r2 = r * r, r3 = r2 * r;
+                return (2 * r3 - 3 * r2 + 1) * p0 + (r3 - 2 * r2 + r) * h * v0 + (-2 * r3 + 3 * r2) * p1 + (r3 - r2) * h * v1;
+            };
+            double ratio = (distance - s[0]) / (next[0] - s[0]);
+            double vx = (1 - ratio) * s[2] + ratio * next[2];
+            ratio += (distance - hermite(ratio, s[0], s[2], next[0], next[2])) / (vx * h);
+            height = hermite(ratio, s[1], s[3], next[1], next[3]);
+            return t + ratio * h;
+        }
+        std::copy(next, next + 4, s);
+    }
+    return -1.0;
+}
+
+// 以无阻力解为初值, 割线法修正 pitch 使落点高度等于 h, 无解时返回 false
+static bool getDragDelay(double& pitch, double& t, const double speed, const double d, const double h, const double drag_k) {
+    bool valid = getParabolaDelay(pitch, t, speed, d, h);
+    if (d <= 0.0) return valid;
+
+    auto error = [&](double p, double& time) {
+        double height;
+        time = rm::getFlyTrajectory(height, speed, p, d, drag_k);
+        return (time < 0.0) ? NAN : height - h;
+    };
+
+    double t0, t1;
+    double p0 = pitch, p1 = pitch + 0.01;
+    double e0 = error(p0, t0);
+    double e1 = error(p1, t1);
+
+    for (int i = 0; i < 20; i++) {
+        if (!std::isfinite(e0) || !std::isfinite(e1)) break;
+        if (fabs(e1) < BALLISTIC_TOLERANCE) {
+            pitch = p1;
+            t = t1;
+            return true;
+        }
+        if (e1 == e0) break;
+        double p2 = std::clamp(p1 - e1 * (p1 - p0) / (e1 - e0), -1.4, 1.4);
+        p0 = p1; e0 = e1; t0 = t1;
+        p1 = p2; e1 = error(p1, t1);
+    }
+    return false;
+}
+
+// 无解时与原无阻力解法一致, 水平射击
+static bool getPitchDelay(double& pitch, double& t, const double speed, const double d, const double h, const double drag_k) {
+    bool valid = (drag_k <= 0.0) ? getParabolaDelay(pitch, t, speed, d, h)
+                                 : getDragDelay(pitch, t, speed, d, h, drag_k);
+    if (!valid) {
+        pitch = 0.0;
+        t = d / speed;
+    }
+    return valid;
+}
+
 double rm::getFlyDelay(
     double& yaw,
-    double& pitch, 
+    double& pitch,
     const double speed,
     const double target_x,
     const double target_y,
     const double target_z,
-    const double head_dx, 
-    const double head_dy, 
+    const double head_dx,
+    const double head_dy,
     const double head_dz,
-    const double barrel_dx, 
-    const double barrel_dy, 
+    const double barrel_dx,
+    const double barrel_dy,
     const double barrel_dz,
     const double barrel_yaw,
-    const double barrel_pitchs
+    const double barrel_pitch,
+    const double drag_k
 ) {
-    return 0.0;
+    yaw = atan2(target_y, target_x);
+    pitch = 0.0;
+    double t = 0.0;
+
+    // 枪口位置随云台姿态变化, 迭代至姿态收敛
+    for (int i = 0; i < 10; i++) {
+        double cy = cos(yaw), sy = sin(yaw);
+        double cp = cos(pitch), sp = sin(pitch);
+
+        double px = head_dx + cp * barrel_dx - sp * barrel_dz;
+        double py = head_dy + barrel_dy;
+        double pz = head_dz + sp * barrel_dx + cp * barrel_dz;
+
+        double muzzle_x = cy * px - sy * py;
+        double muzzle_y = sy * px + cy * py;
+        double muzzle_z = pz;
+
+        double bullet_yaw, bullet_pitch;
+        t = getFlyDelay(
+            bullet_yaw, bullet_pitch, speed,
+            target_x - muzzle_x, target_y - muzzle_y, target_z - muzzle_z, drag_k);
+
+        double yaw_new = bullet_yaw - barrel_yaw;
+        double pitch_new = bullet_pitch - barrel_pitch;
+        bool converge = (fabs(yaw_new - yaw) < 1e-6) && (fabs(pitch_new - pitch) < 1e-6);
+        yaw = yaw_new;
+        pitch = pitch_new;
+        if (converge) break;
+    }
+    return t;
 }
 
 double rm::getFlyDelay(
     double& yaw,
-    double& pitch, 
+    double& pitch,
     const double speed,
     const double target_x,
     const double target_y,
-    const double target_z
+    const double target_z,
+    const double drag_k
 ) {
     yaw = atan2(target_y, target_x);
-    double g = 9.8;
     double h = target_z;
     double d = sqrt(target_x * target_x + target_y * target_y);
-    double t = sqrt(d * d + h * h) / speed;
-
-    for(int i = 0; i < 5; i++) {
-        
-        pitch = asin((h + 0.5 * g * t * t) / (speed * t));
-        
-        if (std::isnan(pitch)) {
-            pitch = 0.0;
-        }
 
-        t = d / (speed * cos(pitch));
-    }
+    double t;
+    getPitchDelay(pitch, t, speed, d, h, drag_k);
     return t;
 }
 
@@ -53,5 +197,89 @@ double rm::getRotateDelay(
     const double current_yaw,
     const double target_yaw
 ) {
-    return 0.0;
-}
\ No newline at end of file
+    return getRotateDelay(current_yaw, target_yaw, ROTATE_SPEED_MAX, ROTATE_ACCEL_MAX);
+}
+
+double rm::getRotateDelay(
+    const double current_yaw,
+    const double target_yaw,
+    const double max_speed,
+    const double max_accel
+) {
+    if ((max_speed <= 0.0) || (max_accel <= 0.0)) return 0.0;
+    double d = fabs(remainder(target_yaw - current_yaw, 2 * M_PI));
+
+    // 加速段与减速段共走过 v^2 / a, 距离不足时为三角形速度曲线
+    double d_ramp = max_speed * max_speed / max_accel;
+    if (d < d_ramp) return 2.0 * sqrt(d / max_accel);
+    return d / max_speed + max_speed / max_accel;
+}
+
+bool rm::BallisticTable::build(
+    const double speed,
+    const double drag_k,
+    const double distance_min,
+    const double distance_max,
+    const double height_min,
+    const double height_max,
+    const double step
+) {
+    if ((speed <= 0.0) || (step <= 0.0) || (distance_max <= distance_min) || (height_max <= height_min)) {
+        return false;
+    }
+    speed_ = speed;
+    drag_k_ = drag_k;
+    distance_min_ = distance_min;
+    height_min_ = height_min;
+    step_ = step;
+    cols_ = (int)ceil((distance_max - distance_min) / step) + 1;
+    rows_ = (int)ceil((height_max - height_min) / step) + 1;
+    pitch_.assign(rows_ * cols_, NAN);
+    time_.assign(rows_ * cols_, NAN);
+
+    for (int r = 0; r < rows_; r++) {
+        for (int c = 0; c < cols_; c++) {
+            double d = distance_min_ + c * step_;
+            double h = height_min_ + r * step_;
+            double pitch, t;
+            if (!getPitchDelay(pitch, t, speed_, d, h, drag_k_)) continue;
+
+            pitch_[r * cols_ + c] = pitch;
+            time_[r * cols_ + c] = t;
+        }
+    }
+    return true;
+}
+
+bool rm::BallisticTable::query(const double distance, const double height, double& pitch, double& time) const {
+    if (empty()) return false;
+
+    double fc = (distance - distance_min_) / step_;
+    double fr = (height - height_min_) / step_;
+    if ((fc < 0.0) || (fr < 0.0) || (fc > cols_ - 1) || (fr > rows_ - 1)) return false;
+
+    int c = std::min((int)fc, cols_ - 2);
+    int r = std::min((int)fr, rows_ - 2);
+    double u = fc - c, v = fr - r;
+
+    int i00 = r * cols_ + c, i01 = i00 + 1;
+    int i10 = i00 + cols_, i11 = i10 + 1;
+    auto lerp = [u, v](const std::vector<double>& m, int a, int b, int c, int d) {
+        return (1 - v) * ((1 - u) * m[a] + u * m[b]) + v * ((1 - u) * m[c] + u * m[d]);
+    };
+    pitch = lerp(pitch_, i00, i01, i10, i11);
+    time = lerp(time_, i00, i01, i10, i11);
+    return std::isfinite(pitch) && std::isfinite(time);
+}
+
+bool rm::BallisticTable::query(
+    double& yaw,
+    double& pitch,
+    double& time,
+    const double target_x,
+    const double target_y,
+    const double target_z
+) const {
+    yaw = atan2(target_y, target_x);
+    return query(sqrt(target_x * target_x + target_y * target_y), target_z, pitch, time);
+}
@@ -0,0 +1,73 @@
+#include "utils/latency.h"
+#include "utils/delay.h"
+#include <algorithm>
+#include <cmath>
+using namespace rm;
+using namespace std;
+
+static const char* stage_name[LATENCY_STAGE_NUM] = {"capture", "detect", "pnp", "predict", "serial"};
+
+LatencyBudget::LatencyBudget(double alpha) : alpha_(alpha) {
+    rotate_speed_ = ROTATE_SPEED_MAX;
+    rotate_accel_ = ROTATE_ACCEL_MAX;
+}
+
+void LatencyBudget::push(LatencyStage stage, double latency) {
+    if ((stage < 0) || (stage >= LATENCY_STAGE_NUM) || !std::isfinite(latency)) return;
+    std::lock_guard<std::mutex> lock(mtx_);
+
+    // 前几个样本用算术平均启动，之后指数滑动平均跟随变化
+    count_[stage]++;
+    double alpha = std::max(alpha_, 1.0 / count_[stage]);
+    double diff = latency - mean_[stage];
+    mean_[stage] += alpha * diff;
+    var_[stage] = (1.0 - alpha) * (var_[stage] + alpha * diff * diff);
+}
+
+void LatencyBudget::push(LatencyStage stage, const TimePoint& start, const TimePoint& end) {
+    push(stage, getDoubleOfS(start, end));
+}
+
+void LatencyBudget::setRotateLimit(double max_speed, double max_accel) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    rotate_speed_ = max_speed;
+    rotate_accel_ = max_accel;
+}
+
+double LatencyBudget::getStage(LatencyStage stage) {
+    if ((stage < 0) || (stage >= LATENCY_STAGE_NUM)) return 0.0;
+    std::lock_guard<std::mutex> lock(mtx_);
+    return mean_[stage];
+}
+
+double LatencyBudget::getStageStd(LatencyStage stage) {
+    if ((stage < 0) || (stage >= LATENCY_STAGE_NUM)) return 0.0;
+    std::lock_guard<std::mutex> lock(mtx_);
+    return sqrt(var_[stage]);
+}
+
+double LatencyBudget::getTotal(double sigma) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    double mean = 0.0, var = 0.0;
+    for (int i = 0; i < LATENCY_STAGE_NUM; i++) {
+        mean += mean_[i];
+        var += var_[i];
+    }
+    return mean + sigma * sqrt(var);
+}
+
+double LatencyBudget::getAppendDelay(double current_yaw, double target_yaw) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    double rotate = getRotateDelay(current_yaw, target_yaw, rotate_speed_, rotate_accel_);
+    return mean_[LATENCY_CAPTURE] + mean_[LATENCY_SERIAL] + control_delay_ + rotate;
+}
+
+void LatencyBudget::getStateStr(std::vector<std::string>& str) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    str.push_back("LatencyBudget");
+    for (int i = 0; i < LATENCY_STAGE_NUM; i++) {
+        str.push_back("  " + std::string(stage_name[i]) + ": " + to_string(mean_[i] * 1e3) + " ms");
+    }
+    str.push_back("  control: " + to_string(control_delay_ * 1e3) + " ms");
+    str.push_back(" ");
+}
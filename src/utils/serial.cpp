@@ -7,6 +7,9 @@
 #include <fcntl.h>   // 用于文件控制
 #include <termios.h> // 用于串口操作
 #include <unistd.h>  // 用于POSIX标准的系统调用
+#include <poll.h>    // 用于等待串口可读
+#include <sys/uio.h> // 用于环形缓冲区分段读取
+#include <array>
 #include <cstring>   // 用于处理字符串和内存操作
 #include <cerrno>    // 用于错误处理
 using namespace rm;
@@ -343,3 +346,173 @@ SerialStatus rm::initSerialHead(int& file_descriptor, size_t struct_size, const
     return SERIAL_STATUS_OK;
 }
 
+// CRC-16/MCR 查表, 反射多项式 0x8408, 初值 0xFFFF
+static constexpr std::array<uint16_t, 256> getCRC16Table() {
+    std::array<uint16_t, 256> table {};
+    for (int i = 0; i < 256; i++) {
+        uint16_t crc = i;
+        for (int j = 0; j < 8; j++) {
+            crc = (crc & 1) ? (crc >> 1) ^ 0x8408 : (crc >> 1);
+        }
+        table[i] = crc;
+    }
+    return table;
+}
+static constexpr std::array<uint16_t, 256> CRC16_TABLE = getCRC16Table();
+
+uint16_t rm::getCRC16(const unsigned char* data, size_t length, uint16_t crc) {
+    for (size_t i = 0; i < length; i++) {
+        crc = (crc >> 8) ^ CRC16_TABLE[(crc ^ data[i]) & 0xFF];
+    }
+    return crc;
+}
+
+size_t rm::packSerialFrame(const unsigned char* payload, uint16_t length, unsigned char* frame, const unsigned char sof) {
+    frame[0] = sof;
+    frame[1] = length & 0xFF;
+    frame[2] = length >> 8;
+    memcpy(frame + SERIAL_FRAME_HEAD, payload, length);
+
+    size_t crc_index = SERIAL_FRAME_HEAD + length;
+    uint16_t crc = getCRC16(frame, crc_index);
+    frame[crc_index] = crc & 0xFF;
+    frame[crc_index + 1] = crc >> 8;
+    return crc_index + SERIAL_FRAME_TAIL;
+}
+
+SerialFramer::SerialFramer(size_t capacity, const unsigned char sof) : sof_(sof) {
+    size_t size = 64;
+    while (size < capacity) size <<= 1;
+    buffer_.resize(size);
+    mask_ = size - 1;
+}
+
+SerialStatus SerialFramer::read(int file_descriptor, int timeout_ms) {
+    if (file_descriptor <= 0) {
+        counter_.read_error++;
+        return SERIAL_STATUS_READ_FAILED;
+    }
+
+    // 等待可读而不是空转 read, 超时无数据不算错误
+    pollfd fds {file_descriptor, POLLIN, 0};
+    int ready = poll(&fds, 1, timeout_ms);
+    if (ready == 0) return SERIAL_STATUS_OK;
+    if ((ready < 0) && (errno != EINTR)) {
+        counter_.read_error++;
+        return SERIAL_STATUS_READ_FAILED;
+    }
+    if (ready < 0) return SERIAL_STATUS_OK;
+    if (!(fds.revents & POLLIN)) {
+        counter_.read_error++;
+        return SERIAL_STATUS_READ_FAILED;
+    }
+
+    // 缓冲区满时丢弃最旧的一半, 保留最新数据
+    if (size() == buffer_.size()) {
+        size_t half = buffer_.size() / 2;
+        drop(half);
+        counter_.overflow += half;
+    }
+
+    // 空闲区域可能跨越缓冲区末尾, 分两段直接读入
+    size_t free = buffer_.size() - size();
+    size_t start = tail_ & mask_;
+    size_t first = std::min(free, buffer_.size() - start);
+    iovec iov[2] = {
+        {buffer_.data() + start, first},
+        {buffer_.data(), free - first}
+    };
+    ssize_t curr = readv(file_descriptor, iov, (free > first) ? 2 : 1);
+    if (curr < 0) {
+        if ((errno == EAGAIN) || (errno == EINTR)) return SERIAL_STATUS_OK;
+        counter_.read_error++;
+        return SERIAL_STATUS_READ_FAILED;
+    }
+    tail_ += curr;
+    counter_.bytes += curr;
+    return SERIAL_STATUS_OK;
+}
+
+size_t SerialFramer::feed(const unsigned char* data, size_t length) {
+    if (length > buffer_.size()) {
+        counter_.overflow += length - buffer_.size();
+        data += length - buffer_.size();
+        length = buffer_.size();
+    }
+    size_t free = buffer_.size() - size();
+    if (length > free) {
+        drop(length - free);
+        counter_.overflow += length - free;
+    }
+    for (size_t i = 0; i < length; i++) {
+        buffer_[(tail_ + i) & mask_] = data[i];
+    }
+    tail_ += length;
+    counter_.bytes += length;
+    return length;
+}
+
+void SerialFramer::copy(size_t index, unsigned char* data, size_t length) const {
+    size_t start = (head_ + index) & mask_;
+    size_t first = std::min(length, buffer_.size() - start);
+    memcpy(data, buffer_.data() + start, first);
+    memcpy(data + first, buffer_.data(), length - first);
+}
+
+uint16_t SerialFramer::getCRC16(size_t length) const {
+    size_t start = head_ & mask_;
+    size_t first = std::min(length, buffer_.size() - start);
+    uint16_t crc = rm::getCRC16(buffer_.data() + start, first);
+    return rm::getCRC16(buffer_.data(), length - first, crc);
+}
+
+SerialStatus SerialFramer::pop(unsigned char* data, size_t length) {
+    size_t frame_length;
+    return popFrame(data, length, length, frame_length);
+}
+
+SerialStatus SerialFramer::pop(unsigned char* data, size_t max_length, size_t& length) {
+    return popFrame(data, 0, max_length, length);
+}
+
+SerialStatus SerialFramer::popFrame(unsigned char* data, size_t min_length, size_t max_length, size_t& length) {
+    length = 0;
+    if (SERIAL_FRAME_HEAD + min_length + SERIAL_FRAME_TAIL > buffer_.size()) {
+        rm::message("Serial framer pop failed : frame larger than buffer", rm::MSG_ERROR);
+        return SERIAL_STATUS_LENGTH_ERROR;
+    }
+    // 变长帧的负载上限同时受目标缓冲区和环形缓冲区限制
+    max_length = std::min(max_length, buffer_.size() - SERIAL_FRAME_HEAD - SERIAL_FRAME_TAIL);
+
+    while (size() >= SERIAL_FRAME_HEAD) {
+        if (at(0) != sof_) {
+            drop(1);
+            counter_.sof_error++;
+            continue;
+        }
+        size_t frame_length = at(1) | (at(2) << 8);
+        if ((frame_length < min_length) || (frame_length > max_length)) {
+            drop(1);
+            counter_.length_error++;
+            continue;
+        }
+        size_t frame_size = SERIAL_FRAME_HEAD + frame_length + SERIAL_FRAME_TAIL;
+        if (size() < frame_size) break;
+
+        size_t crc_index = SERIAL_FRAME_HEAD + frame_length;
+        uint16_t crc = at(crc_index) | (at(crc_index + 1) << 8);
+        if (getCRC16(crc_index) != crc) {
+            drop(1);
+            counter_.crc_error++;
+            continue;
+        }
+
+        // 校验通过后负载直接拷入目标结构体
+        copy(SERIAL_FRAME_HEAD, data, frame_length);
+        drop(frame_size);
+        counter_.frame++;
+        length = frame_length;
+        return SERIAL_STATUS_OK;
+    }
+    return SERIAL_STATUS_INCOMPLETE;
+}
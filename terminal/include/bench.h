@@ -0,0 +1,60 @@
+#ifndef __OPENRM_TERMINAL_BENCH_H__
+#define __OPENRM_TERMINAL_BENCH_H__
+
+#include <openrm.h>
+#include <string>
+#include <vector>
+#include <chrono>
+
+// 基准与精度测试，均使用合成数据或记录数据，无需硬件
+// 用法: openrm -b <name> [arg ...]
+
+typedef void (*BenchFunc)(const std::vector<std::string>& args);
+
+struct BenchStat {
+    double mean = 0.0;                      // Mean of samples
+    double p50  = 0.0;                      // Median of samples
+    double p95  = 0.0;                      // 95th percentile of samples
+    double max  = 0.0;                      // Maximum of samples
+};
+
+void bench(const std::vector<std::string>& args);
+BenchStat getBenchStat(std::vector<double> samples);
+std::string getBenchStatStr(const std::string& name, const BenchStat& stat, const std::string& unit);
+void getBenchCamera(rm::Camera& camera, int width = 1280, int height = 1024, double focal = 1200.0);
+std::vector<cv::Point2f> getBenchProject(
+    const rm::YawPnPShared& shared,
+    const std::vector<cv::Point3f>& object_points,
+    const Eigen::Vector4d& pose,
+    double armor_yaw,
+    rm::ArmorElevation elevation = rm::ARMOR_ELEVATION_UP_15);
+
+// 计时, 返回每次调用的平均微秒数
+template<typename F>
+double getBenchTime(int repeat, F&& func) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeat; i++) func(i);
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(t1 - t0).count() / repeat;
+}
+
+void benchAntitop4(const std::vector<std::string>& args);
+void benchAssociation(const std::vector<std::string>& args);
+void benchBallistic(const std::vector<std::string>& args);
+void benchBatchPnP(const std::vector<std::string>& args);
+void benchCache(const std::vector<std::string>& args);
+void benchIMM(const std::vector<std::string>& args);
+void benchLatency(const std::vector<std::string>& args);
+void benchLetterbox(const std::vector<std::string>& args);
+void benchOutpost(const std::vector<std::string>& args);
+void benchRune(const std::vector<std::string>& args);
+void benchRuneFit(const std::vector<std::string>& args);
+void benchScorer(const std::vector<std::string>& args);
+void benchSEKF(const std::vector<std::string>& args);
+void benchSerial(const std::vector<std::string>& args);
+void benchSqrtKF(const std::vector<std::string>& args);
+void benchUKF(const std::vector<std::string>& args);
+void benchVehicle(const std::vector<std::string>& args);
+void benchYawPnP(const std::vector<std::string>& args);
+
+#endif
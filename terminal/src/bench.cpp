@@ -0,0 +1,94 @@
+#include "bench.h"
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <map>
+
+static const std::map<std::string, BenchFunc> BENCH_LIST = {
+    {"antitop4",    benchAntitop4},
+    {"association", benchAssociation},
+    {"ballistic",   benchBallistic},
+    {"batchpnp",    benchBatchPnP},
+    {"cache",       benchCache},
+    {"imm",         benchIMM},
+    {"latency",     benchLatency},
+    {"letterbox",   benchLetterbox},
+    {"outpost",     benchOutpost},
+    {"rune",        benchRune},
+    {"runefit",     benchRuneFit},
+    {"scorer",      benchScorer},
+    {"sekf",        benchSEKF},
+    {"serial",      benchSerial},
+    {"sqrtkf",      benchSqrtKF},
+    {"ukf",         benchUKF},
+    {"vehicle",     benchVehicle},
+    {"yawpnp",      benchYawPnP},
+};
+
+void bench(const std::vector<std::string>& args) {
+    auto it = args.empty() ? BENCH_LIST.end() : BENCH_LIST.find(args[0]);
+    if (it == BENCH_LIST.end()) {
+        std::cout << "Usage: openrm -b <name> [arg ...]" << std::endl;
+        for (const auto& [name, func] : BENCH_LIST) std::cout << "  " << name << std::endl;
+        return;
+    }
+    it->second(std::vector<std::string>(args.begin() + 1, args.end()));
+}
+
+BenchStat getBenchStat(std::vector<double> samples) {
+    BenchStat stat;
+    if (samples.empty()) return stat;
+    std::sort(samples.begin(), samples.end());
+    for (double x : samples) stat.mean += x;
+    stat.mean /= samples.size();
+    stat.p50 = samples[samples.size() / 2];
+    stat.p95 = samples[std::min(samples.size() - 1, samples.size() * 95 / 100)];
+    stat.max = samples.back();
+    return stat;
+}
+
+std::string getBenchStatStr(const std::string& name, const BenchStat& stat, const std::string& unit) {
+    char str[160];
+    snprintf(str, sizeof(str), "%-24s mean %9.4f  p50 %9.4f  p95 %9.4f  max %9.4f %s",
+        name.c_str(), stat.mean, stat.p50, stat.p95, stat.max, unit.c_str());
+    return std::string(str);
+}
+
+// 合成相机: 无畸变, 内参与 getYawPnPShared 一致使用 float, 相机系 (x右 y下 z前) 到云台系 (x前 y左 z上)
+void getBenchCamera(rm::Camera& camera, int width, int height, double focal) {
+    camera.width = width;
+    camera.height = height;
+    camera.intrinsic_matrix = (cv::Mat_<float>(3, 3) <<
+        focal, 0, width / 2.0,
+        0, focal, height / 2.0,
+        0, 0, 1);
+    camera.distortion_coeffs = cv::Mat::zeros(1, 5, CV_32F);
+    camera.Rotate_pnp2head << 0, 0, 1,
+                             -1, 0, 0,
+                              0, -1, 0;
+    camera.Trans_pnp2head = Eigen::Matrix4d::Identity();
+    camera.Trans_pnp2head.block<3, 3>(0, 0) = camera.Rotate_pnp2head;
+}
+
+// 用 YawPnP 自身的投影模型生成装甲板四点，解算结果可与真值直接比较
+std::vector<cv::Point2f> getBenchProject(
+    const rm::YawPnPShared& shared,
+    const std::vector<cv::Point3f>& object_points,
+    const Eigen::Vector4d& pose,
+    double armor_yaw,
+    rm::ArmorElevation elevation
+) {
+    rm::YawPnP yaw_pnp;
+    yaw_pnp.sys_yaw = armor_yaw;
+    yaw_pnp.setElevation(elevation);
+    yaw_pnp.setWorldPoints(object_points);
+    yaw_pnp.Kc = shared.Kc;
+    yaw_pnp.T = shared.T;
+    yaw_pnp.T_inv = shared.T_inv;
+    yaw_pnp.pose = pose;
+
+    rm::YawPnP::Points2d project = yaw_pnp.getProject(yaw_pnp.getMapping(0.0));
+    std::vector<cv::Point2f> image_points;
+    for (int i = 0; i < 4; i++) image_points.emplace_back(project(0, i), project(1, i));
+    return image_points;
+}
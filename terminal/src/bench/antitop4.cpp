@@ -0,0 +1,85 @@
+#include "bench.h"
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <random>
+
+struct BenchAntitop4Truth {
+    int    armor_num;                       // Armor number of vehicle
+    double omega;                           // Spin speed, rad/s
+    double r[2] = {0.22, 0.28};             // Radius of two armor pairs
+    double z[2] = {0.10, 0.15};             // Height of two armor pairs
+
+    // 中心匀速平移，返回 t 时刻最正对相机的装甲板
+    Eigen::Matrix<double, 4, 1> getArmor(double t) const {
+        double cx = 4.0 + 0.3 * t, cy = 0.5 - 0.2 * t, theta = 0.3 + omega * t;
+        double step = 2 * M_PI / armor_num;
+        int k = static_cast<int>(std::round((std::atan2(cy, cx) - theta) / step));
+        int pair = (armor_num == 4) ? (((k % 2) + 2) % 2) : 0;
+        double angle = theta + k * step;
+        return Eigen::Matrix<double, 4, 1>(cx - r[pair] * std::cos(angle), cy - r[pair] * std::sin(angle), z[pair],
+                                           std::remainder(angle, 2 * M_PI));
+    }
+};
+
+// AntitopV4 单次 push 耗时 (与单假设 AntitopV3 对比)、装甲板数判别与 0.2 s 预测误差
+// 最后一帧时间戳为当前时刻，预测真值取调用 getPose 时对应的仿真时间
+// openrm -b antitop4 [frames]
+void benchAntitop4(const std::vector<std::string>& args) {
+    int frames = (args.size() > 0) ? std::stoi(args[0]) : 400;
+    const double dt = 0.01, append_delay = 0.2;
+
+    std::mt19937 rng(3);
+    std::normal_distribution<double> noise(0.0, 1.0);
+
+#ifdef OPENRM_SQRT_KALMAN
+    std::cout << "antitop4: SREKF<9, 4> hypotheses, ";
+#else
+    std::cout << "antitop4: SEKF<9, 4> hypotheses, ";
+#endif
+    std::cout << frames << " frames at " << 1.0 / dt << " Hz, " << rm::ANTITOP_HYPO_NUM_V4 << " hypotheses" << std::endl;
+    std::cout << " armor  omega   chosen   p2     p3     p4    pose err m   V4 us/push   V3 us/push" << std::endl;
+
+    std::vector<double> v4_all, v3_all;
+    for (int armor_num : {2, 3, 4}) {
+        for (double omega : {0.0, 2.0, 6.0, -8.0}) {
+            BenchAntitop4Truth truth;
+            truth.armor_num = armor_num;
+            truth.omega = omega;
+            if (armor_num != 4) {
+                truth.r[1] = truth.r[0];
+                truth.z[1] = truth.z[0];
+            }
+
+            rm::AntitopV4 antitop_v4;
+            antitop_v4.setFireValue(50, 0.5, 0.5, 0.2);
+            rm::AntitopV3 antitop_v3(0.15, 0.4, armor_num);
+            antitop_v3.setFireValue(50, 0.5, 0.5, 0.2);
+
+            TimePoint start = getTime() - std::chrono::microseconds(static_cast<long>(frames * dt * 1e6));
+            std::vector<double> v4_us, v3_us;
+            for (int f = 1; f <= frames; f++) {
+                Eigen::Matrix<double, 4, 1> pose = truth.getArmor(f * dt);
+                for (int i = 0; i < 3; i++) pose[i] += 0.01 * noise(rng);
+                pose[3] += 0.03 * noise(rng);
+                TimePoint t = start + std::chrono::microseconds(static_cast<long>(f * dt * 1e6));
+                v4_us.push_back(getBenchTime(1, [&](int) { antitop_v4.push(pose, t); }));
+                v3_us.push_back(getBenchTime(1, [&](int) { antitop_v3.push(pose, t); }));
+            }
+
+            Eigen::Matrix<double, 4, 1> expect = truth.getArmor(getDoubleOfS(start, getTime()) + append_delay);
+            Eigen::Matrix<double, 4, 1> predict = antitop_v4.getPose(append_delay);
+            double pose_err = (predict.head<2>() - expect.head<2>()).norm();
+            v4_all.insert(v4_all.end(), v4_us.begin(), v4_us.end());
+            v3_all.insert(v3_all.end(), v3_us.begin(), v3_us.end());
+
+            char str[160];
+            snprintf(str, sizeof(str), " %5d %6.1f %8d %6.2f %6.2f %6.2f %12.3f %12.1f %12.1f",
+                armor_num, omega, antitop_v4.getArmorNum(), antitop_v4.getProbability(2), antitop_v4.getProbability(3),
+                antitop_v4.getProbability(4), pose_err, getBenchStat(v4_us).mean, getBenchStat(v3_us).mean);
+            std::cout << str << std::endl;
+        }
+    }
+    std::cout << getBenchStatStr("AntitopV4 push", getBenchStat(v4_all), "us") << std::endl;
+    std::cout << getBenchStatStr("AntitopV3 push", getBenchStat(v3_all), "us") << std::endl;
+}
@@ -0,0 +1,163 @@
+#include "bench.h"
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <random>
+
+struct BenchAssociation {
+    int    switches = 0;                    // Number of identity switches after warm-up
+    int    missed   = 0;                    // Frames in which a truth target had no updated track
+    double us       = 0.0;                  // Time of push and update per frame
+};
+
+// 原 TrackQueueV4 的逐个贪心关联: 按匀速转弯模型外推各航迹，取欧氏距离最近且在最大移动距离内的航迹，否则新建航迹
+// 与 TrackQueueV4 使用相同的运动模型和噪声参数，只替换关联方式，作为对比基线
+struct BenchGreedyState {
+    TimePoint last_t;                       // Last time of target
+    Eigen::Matrix<double, 4, 1> last_pose;  // Last position of target
+    SEKF<8, 3> model;                       // Target motion model
+    int id;                                 // Unique id of this target
+    int keep = 5;                           // Keep count of this target
+};
+
+class BenchGreedyQueue {
+public:
+    BenchGreedyQueue(double distance, double delay) : distance_(distance), delay_(delay) {}
+
+    void push(const Eigen::Matrix<double, 4, 1>& input_pose, TimePoint t) {
+        Eigen::Matrix<double, 3, 1> pose = input_pose.head<3>();
+        list_.erase(std::remove_if(list_.begin(), list_.end(), [&](const BenchGreedyState& state) {
+            return (getDoubleOfS(state.last_t, t) > delay_) || (state.keep <= 0);
+        }), list_.end());
+
+        double min_distance = 1e4;
+        BenchGreedyState* best_state = nullptr;
+        for (auto& state : list_) {
+            double dt = getDoubleOfS(state.last_t, t);
+            const auto& X = state.model.estimate_X;
+            Eigen::Matrix<double, 3, 1> predict_pose(X[0] + dt * X[3] * cos(X[5]), X[1] + dt * X[3] * sin(X[5]), X[2]);
+            double distance = (pose - predict_pose).norm();
+            if (distance < min_distance) {
+                min_distance = distance;
+                best_state = &state;
+            }
+        }
+
+        if ((best_state == nullptr) || (min_distance > distance_)) {
+            list_.emplace_back();
+            best_state = &list_.back();
+            best_state->id = next_id_++;
+            best_state->model.Q = matrixQ_;
+            best_state->model.R = matrixR_;
+            funcA_.dt = 0;
+        } else {
+            funcA_.dt = getDoubleOfS(best_state->last_t, t);
+        }
+        best_state->last_t = t;
+        best_state->last_pose = input_pose;
+        best_state->keep = 5;
+        best_state->model.predict(funcA_);
+        best_state->model.update(funcH_, pose);
+    }
+
+    void update() {
+        for (auto& state : list_) state.keep -= 1;
+    }
+
+    Eigen::Matrix<double, 8, 8> matrixQ_;
+    Eigen::Matrix<double, 3, 3> matrixR_;
+    std::vector<BenchGreedyState> list_;
+
+private:
+    double distance_, delay_;
+    int next_id_ = 0;
+    rm::TrackQueueV4_FuncA funcA_;
+    rm::TrackQueueV4_FuncH funcH_;
+};
+
+// N 个目标分布在间距 gap 的平行车道上，相邻车道反向运动并在 t = 2s 处交错
+// 每帧把真值与本帧更新过的最近航迹对应，航迹 id 变化记为一次 ID 切换
+template<typename Queue, typename Push>
+static BenchAssociation runBenchAssociation(Queue& queue, Push push, int num, double gap, int frames) {
+    std::mt19937 rng(num);
+    std::normal_distribution<double> noise(0.0, 0.01);
+    TimePoint start = getTime();
+    std::vector<int> last_id(num, -1);
+
+    BenchAssociation result;
+    for (int f = 0; f < frames; f++) {
+        double t = f * 0.01;
+        TimePoint tp = start + std::chrono::microseconds(static_cast<long>(t * 1e6));
+        std::vector<Eigen::Matrix<double, 4, 1>> poses(num);
+        for (int k = 0; k < num; k++) {
+            double dir = (k % 2) ? 1.0 : -1.0;
+            poses[k] << 3.0 + dir * (t - 2.0) * 0.8 + noise(rng),
+                        k * gap + 0.02 * std::sin(3.0 * t + k) + noise(rng),
+                        0.1 + noise(rng), 0;
+        }
+
+        result.us += getBenchTime(1, [&](int) {
+            push(poses, tp);
+            queue.update();
+        });
+
+        for (int k = 0; k < num; k++) {
+            int best = -1;
+            double best_distance = 1e9;
+            for (auto& state : queue.list_) {
+                if (state.last_t != tp) continue;
+                double distance = (state.last_pose.head(3) - poses[k].head(3)).norm();
+                if (distance < best_distance) {
+                    best_distance = distance;
+                    best = state.id;
+                }
+            }
+            if (f < 20) {
+                last_id[k] = best;
+                continue;
+            }
+            if (best < 0) {
+                result.missed++;
+                continue;
+            }
+            if ((last_id[k] >= 0) && (best != last_id[k])) result.switches++;
+            last_id[k] = best;
+        }
+    }
+    result.us /= frames;
+    return result;
+}
+
+// 对比原逐个贪心关联与 TrackQueueV4 整帧匈牙利关联的 ID 切换次数与单帧耗时
+// 目标数不超过 TrackQueueV4 目标池容量，避免统计到因池满被丢弃的航迹
+// openrm -b association [frames] [gap]
+void benchAssociation(const std::vector<std::string>& args) {
+    int frames = (args.size() > 0) ? std::stoi(args[0]) : 400;
+    double gap = (args.size() > 1) ? std::stod(args[1]) : 0.05;
+    const double distance = 0.3, delay = 0.5;
+
+    size_t capacity = rm::TrackQueueV4().list_.capacity();
+    std::cout << "association: " << frames << " frames, lane gap " << gap << " m, target pool holds " << capacity << std::endl;
+    std::cout << " targets   greedy sw  missed       us   hungarian sw  missed       us" << std::endl;
+    for (int num : {1, 2, 5, 10, 20, 30, 50}) {
+        if (num >= static_cast<int>(capacity)) break;
+
+        rm::TrackQueueV4 track_queue(5, distance, delay);
+        track_queue.setMatrixQ(1e-4, 1e-4, 1e-4, 1e-2, 1e-3, 1e-2, 1e-2, 1e-2);
+        track_queue.setMatrixR(1e-4, 1e-4, 1e-4);
+        BenchGreedyQueue greedy_queue(distance, delay);
+        greedy_queue.matrixQ_ = Eigen::Matrix<double, 8, 1>(1e-4, 1e-4, 1e-4, 1e-2, 1e-3, 1e-2, 1e-2, 1e-2).asDiagonal();
+        greedy_queue.matrixR_ = Eigen::Matrix<double, 3, 1>(1e-4, 1e-4, 1e-4).asDiagonal();
+
+        BenchAssociation greedy = runBenchAssociation(greedy_queue, [&](auto& poses, TimePoint tp) {
+            for (auto& pose : poses) greedy_queue.push(pose, tp);
+        }, num, gap, frames);
+        BenchAssociation hungarian = runBenchAssociation(track_queue, [&](auto& poses, TimePoint tp) {
+            track_queue.push(poses, tp);
+        }, num, gap, frames);
+        char str[160];
+        snprintf(str, sizeof(str), " %7d  %10d %7d %8.1f  %13d %7d %8.1f",
+            num, greedy.switches, greedy.missed, greedy.us, hungarian.switches, hungarian.missed, hungarian.us);
+        std::cout << str << std::endl;
+    }
+}
@@ -0,0 +1,96 @@
+#include "bench.h"
+#include <cmath>
+#include <iostream>
+#include <random>
+
+// 高精度参考: 1e-5 s 步长 RK4，越过目标水平距离的一步内线性插值
+static double getBenchFlyReference(double& height, double speed, double pitch, double distance, double drag_k) {
+    const double dt = 1e-5;
+    double s[4] = {0.0, 0.0, speed * cos(pitch), speed * sin(pitch)};
+    auto deriv = [&](const double* x, double* dx) {
+        double v = std::hypot(x[2], x[3]);
+        dx[0] = x[2];
+        dx[1] = x[3];
+        dx[2] = -drag_k * v * x[2];
+        dx[3] = -9.8 - drag_k * v * x[3];
+    };
+    double t = 0.0;
+    while (t < 10.0) {
+        double k1[4], k2[4], k3[4], k4[4], tmp[4], next[4];
+        deriv(s, k1);
+        for (int i = 0; i < 4; i++) tmp[i] = s[i] + 0.5 * dt * k1[i];
+        deriv(tmp, k2);
+        for (int i = 0; i < 4; i++) tmp[i] = s[i] + 0.5 * dt * k2[i];
+        deriv(tmp, k3);
+        for (int i = 0; i < 4; i++) tmp[i] = s[i] + dt * k3[i];
+        deriv(tmp, k4);
+        for (int i = 0; i < 4; i++) next[i] = s[i] + dt / 6.0 * (k1[i] + 2 * k2[i] + 2 * k3[i] + k4[i]);
+        if (next[0] >= distance) {
+            double ratio = (distance - s[0]) / (next[0] - s[0]);
+            height = s[1] + ratio * (next[1] - s[1]);
+            return t + ratio * dt;
+        }
+        std::copy(next, next + 4, s);
+        t += dt;
+    }
+    return -1.0;
+}
+
+// 弹道解算精度 (相对高精度 RK4) 与查表、直接积分的耗时对比
+// openrm -b ballistic [speed] [drag_k]
+void benchBallistic(const std::vector<std::string>& args) {
+    double speed = (args.size() > 0) ? std::stod(args[0]) : 25.0;
+    double drag_k = (args.size() > 1) ? std::stod(args[1]) : rm::DRAG_K_17MM;
+
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<double> distance_dist(1.0, 24.0), height_dist(-1.5, 2.5);
+    std::vector<std::pair<double, double>> targets(400);
+    for (auto& [d, h] : targets) {
+        d = distance_dist(rng);
+        h = height_dist(rng);
+    }
+
+    // 1. getFlyDelay 给出的 pitch 按参考积分射出，统计到达目标距离时的高度与时间误差
+    std::vector<double> solve_height, solve_time, solve_us;
+    for (const auto& [d, h] : targets) {
+        double yaw, pitch, height;
+        double time = 0.0;
+        solve_us.push_back(getBenchTime(1, [&](int) {
+            time = rm::getFlyDelay(yaw, pitch, speed, d, 0.0, h, drag_k);
+        }));
+        double reference = getBenchFlyReference(height, speed, pitch, d, drag_k);
+        if ((time < 0) || (reference < 0)) continue;
+        solve_height.push_back(std::abs(height - h) * 1e3);
+        solve_time.push_back(std::abs(time - reference) * 1e6);
+    }
+
+    // 2. 查表，表外或不可达的点不计入
+    rm::BallisticTable table;
+    double build_us = getBenchTime(1, [&](int) {
+        table.build(speed, drag_k, 0.5, 25.0, -2.0, 3.0, 0.05);
+    });
+    std::vector<double> table_height, table_time, table_us;
+    for (const auto& [d, h] : targets) {
+        double pitch, time, height;
+        bool valid = false;
+        table_us.push_back(getBenchTime(1, [&](int) {
+            valid = table.query(d, h, pitch, time);
+        }));
+        if (!valid) continue;
+        double reference = getBenchFlyReference(height, speed, pitch, d, drag_k);
+        if (reference < 0) continue;
+        table_height.push_back(std::abs(height - h) * 1e3);
+        table_time.push_back(std::abs(time - reference) * 1e6);
+    }
+
+    std::cout << "ballistic: speed " << speed << " m/s, drag_k " << drag_k << ", "
+              << targets.size() << " targets in 1~24 m, reference RK4 dt 1e-5 s" << std::endl;
+    std::cout << getBenchStatStr("solve height err", getBenchStat(solve_height), "mm") << std::endl;
+    std::cout << getBenchStatStr("solve time err", getBenchStat(solve_time), "us") << std::endl;
+    std::cout << getBenchStatStr("solve time", getBenchStat(solve_us), "us") << std::endl;
+    std::cout << getBenchStatStr("table height err", getBenchStat(table_height), "mm") << std::endl;
+    std::cout << getBenchStatStr("table time err", getBenchStat(table_time), "us") << std::endl;
+    std::cout << getBenchStatStr("table query", getBenchStat(table_us), "us") << std::endl;
+    std::cout << "table build " << build_us / 1e3 << " ms, " << table_height.size() << "/" << targets.size()
+              << " targets inside table" << std::endl;
+}
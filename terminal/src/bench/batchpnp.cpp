@@ -0,0 +1,74 @@
+#include "bench.h"
+#include <cstdio>
+#include <iostream>
+#include <random>
+
+// 每帧 1~20 块装甲板，对比 solveYawPnPBatch 与逐个调用 solveYawPnP 的单帧耗时
+// openrm -b batchpnp [frames]
+void benchBatchPnP(const std::vector<std::string>& args) {
+    int frames = (args.size() > 0) ? std::stoi(args[0]) : 200;
+
+    rm::Camera camera;
+    getBenchCamera(camera);
+    Eigen::Matrix3d rotate_head2world = Eigen::Matrix3d::Identity();
+    Eigen::Matrix4d trans_head2world = Eigen::Matrix4d::Identity();
+    rm::YawPnPShared shared;
+    getYawPnPShared(&camera, rotate_head2world, trans_head2world, shared);
+
+    std::vector<cv::Point3f> small_points = {
+        {-67.5f, -27.5f, 0}, {-67.5f, 27.5f, 0}, {67.5f, -27.5f, 0}, {67.5f, 27.5f, 0}};
+    std::vector<cv::Point3f> big_points = {
+        {-115.0f, -27.5f, 0}, {-115.0f, 27.5f, 0}, {115.0f, -27.5f, 0}, {115.0f, 27.5f, 0}};
+
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+    std::normal_distribution<double> pixel_noise(0.0, 0.5);
+
+    std::cout << "batchpnp: " << frames << " frames per armor count, "
+              << cv::getNumThreads() << " threads" << std::endl;
+    std::cout << " armors   serial us   batch us   speedup   max yaw diff" << std::endl;
+    for (int num = 1; num <= 20; num++) {
+        double serial_time = 0.0, batch_time = 0.0, max_diff = 0.0;
+        for (int f = 0; f < frames; f++) {
+            std::vector<rm::Armor> armors(num);
+            for (auto& armor : armors) {
+                double distance = 2.0 + 5.0 * std::abs(uniform(rng));
+                double bearing = 0.3 * uniform(rng);
+                Eigen::Vector4d pose(distance * cos(bearing), distance * sin(bearing), 0.2 * uniform(rng), 1);
+                armor.size = (rng() % 4 == 0) ? rm::ARMOR_SIZE_BIG_ARMOR : rm::ARMOR_SIZE_SMALL_ARMOR;
+                armor.id = rm::ARMOR_ID_INFANTRY_3;
+                armor.four_points = getBenchProject(shared,
+                    (armor.size == rm::ARMOR_SIZE_BIG_ARMOR) ? big_points : small_points,
+                    pose, bearing + uniform(rng));
+                for (auto& p : armor.four_points) {
+                    p.x += pixel_noise(rng);
+                    p.y += pixel_noise(rng);
+                }
+            }
+
+            std::vector<double> serial_yaw(num);
+            serial_time += getBenchTime(1, [&](int) {
+                for (int i = 0; i < num; i++) {
+                    Eigen::Vector4d pose;
+                    serial_yaw[i] = rm::solveYawPnP(0.0, &camera, pose,
+                        (armors[i].size == rm::ARMOR_SIZE_BIG_ARMOR) ? big_points : small_points,
+                        armors[i].four_points, rotate_head2world, trans_head2world);
+                }
+            });
+
+            rm::Frame frame;
+            batch_time += getBenchTime(1, [&](int) {
+                rm::solveYawPnPBatch(frame, armors, 0.0, &camera, small_points, big_points,
+                                     rotate_head2world, trans_head2world);
+            });
+            for (size_t i = 0; i < frame.target_list.size(); i++) {
+                max_diff = std::max(max_diff, std::abs(frame.target_list[i].armor_yaw_world - serial_yaw[i]));
+            }
+        }
+
+        char str[128];
+        snprintf(str, sizeof(str), " %6d  %10.2f %10.2f %9.2f   %.2e",
+            num, serial_time / frames, batch_time / frames, serial_time / batch_time, max_diff);
+        std::cout << str << std::endl;
+    }
+}
@@ -0,0 +1,121 @@
+#include "bench.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+static int bench_cache_fail = 0;
+
+static void checkBenchCache(const std::string& name, bool ok) {
+    std::cout << "  " << (ok ? "ok    " : "FAIL  ") << name << std::endl;
+    if (!ok) bench_cache_fail++;
+}
+
+static void writeBenchCacheFile(const fs::path& path, const std::vector<char>& data) {
+    std::ofstream file(path, std::ios::binary);
+    file.write(data.data(), static_cast<std::streamsize>(data.size()));
+}
+
+// 引擎缓存的 CPU 检查: 键计算、命中、头部不匹配时删除、临时文件重命名与同模型缓存清理，无需 GPU
+// ONNX 与引擎均为随机字节，只验证缓存逻辑，不涉及推理库
+// openrm -b cache [onnx_mb]
+void benchCache(const std::vector<std::string>& args) {
+    double onnx_mb = (args.size() > 0) ? std::stod(args[0]) : 20.0;
+    bench_cache_fail = 0;
+
+    fs::path dir = fs::temp_directory_path() / ("openrm_bench_cache_" + std::to_string(getpid()));
+    std::error_code ec;
+    fs::remove_all(dir, ec);
+    fs::create_directories(dir, ec);
+
+    std::mt19937 rng(5);
+    std::vector<char> onnx(static_cast<size_t>(onnx_mb * 1024 * 1024)), engine(1 << 20);
+    for (auto& c : onnx) c = static_cast<char>(rng());
+    for (auto& c : engine) c = static_cast<char>(rng());
+    std::string onnx_file = (dir / "model.onnx").string();
+    writeBenchCacheFile(onnx_file, onnx);
+
+    std::cout << "cache: " << dir.string() << ", onnx " << onnx_mb << " MB, engine 1 MB" << std::endl;
+
+    // 1. 键计算
+    rm::EngineCacheKey key, key_again, key_int8, key_b4, key_old;
+    double hash_us = getBenchTime(1, [&](int) { rm::getEngineCacheKey(onnx_file, rm::ENGINE_FP16, 1, 100, key); });
+    rm::getEngineCacheKey(onnx_file, rm::ENGINE_FP16, 1, 100, key_again);
+    rm::getEngineCacheKey(onnx_file, rm::ENGINE_INT8, 1, 100, key_int8);
+    rm::getEngineCacheKey(onnx_file, rm::ENGINE_FP16, 4, 100, key_b4);
+    rm::getEngineCacheKey(onnx_file, rm::ENGINE_FP16, 1, 99, key_old);
+    std::string path = rm::getEngineCachePath(dir.string(), onnx_file, key);
+    checkBenchCache("hash is stable", key.onnx_hash == key_again.onnx_hash);
+    checkBenchCache("precision, batch and version change the path",
+        (path != rm::getEngineCachePath(dir.string(), onnx_file, key_int8))
+        && (path != rm::getEngineCachePath(dir.string(), onnx_file, key_b4))
+        && (path != rm::getEngineCachePath(dir.string(), onnx_file, key_old)));
+
+    onnx[onnx.size() / 2] ^= 0x01;
+    writeBenchCacheFile(dir / "model_edit.onnx", onnx);
+    rm::EngineCacheKey key_edit;
+    rm::getEngineCacheKey((dir / "model_edit.onnx").string(), rm::ENGINE_FP16, 1, 100, key_edit);
+    checkBenchCache("one flipped onnx byte changes the hash", key_edit.onnx_hash != key.onnx_hash);
+    fs::remove(dir / "model_edit.onnx", ec);
+
+    // 2. 写入后命中，临时文件已重命名
+    double write_us = getBenchTime(1, [&](int) { rm::writeEngineCache(path, key, engine.data(), engine.size()); });
+    checkBenchCache("write leaves no tmp file", fs::exists(path) && !fs::exists(path + ".tmp"));
+    rm::EngineCache cache;
+    bool hit = false;
+    double map_us = getBenchTime(1, [&](int) { hit = rm::mapEngineCache(path, key, cache); });
+    checkBenchCache("cache hit returns the engine", hit && (cache.size == engine.size())
+        && (memcmp(cache.data, engine.data(), engine.size()) == 0));
+    rm::unmapEngineCache(cache);
+
+    // 3. 头部键不匹配或文件被截断时删除
+    fs::path copy = dir / "copy.engine";
+    fs::copy_file(path, copy, fs::copy_options::overwrite_existing, ec);
+    checkBenchCache("other batch key invalidates and unlinks", !rm::mapEngineCache(copy.string(), key_b4, cache) && !fs::exists(copy));
+
+    fs::copy_file(path, copy, fs::copy_options::overwrite_existing, ec);
+    {
+        std::fstream file(copy, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(32);
+        uint64_t lib_version = 101;
+        file.write(reinterpret_cast<const char*>(&lib_version), sizeof(lib_version));
+    }
+    checkBenchCache("changed header version invalidates and unlinks", !rm::mapEngineCache(copy.string(), key, cache) && !fs::exists(copy));
+
+    fs::copy_file(path, copy, fs::copy_options::overwrite_existing, ec);
+    fs::resize_file(copy, fs::file_size(copy) - 100, ec);
+    checkBenchCache("truncated payload invalidates and unlinks", !rm::mapEngineCache(copy.string(), key, cache) && !fs::exists(copy));
+
+    // 4. 清理只删除旧推理库版本的缓存、校准文件与残留临时文件，其他精度与批大小保留
+    std::string path_int8 = rm::getEngineCachePath(dir.string(), onnx_file, key_int8);
+    std::string path_b4 = rm::getEngineCachePath(dir.string(), onnx_file, key_b4);
+    std::string path_old = rm::getEngineCachePath(dir.string(), onnx_file, key_old);
+    std::string calib_int8 = path_int8.substr(0, path_int8.rfind('.')) + ".calib";
+    std::string calib_old = path_old.substr(0, path_old.rfind('.')) + ".calib";
+    rm::writeEngineCache(path_int8, key_int8, engine.data(), engine.size());
+    rm::writeEngineCache(path_b4, key_b4, engine.data(), engine.size());
+    rm::writeEngineCache(path_old, key_old, engine.data(), engine.size());
+    writeBenchCacheFile(calib_int8, engine);
+    writeBenchCacheFile(calib_old, engine);
+    writeBenchCacheFile(path_b4 + ".tmp", engine);
+
+    int removed = rm::clearEngineCache(dir.string(), onnx_file, key);
+    checkBenchCache("clear removes old version, its calib and tmp", (removed == 3) && !fs::exists(path_old)
+        && !fs::exists(calib_old) && !fs::exists(path_b4 + ".tmp"));
+    checkBenchCache("clear keeps other precision, batch and calib", fs::exists(path) && fs::exists(path_int8)
+        && fs::exists(path_b4) && fs::exists(calib_int8));
+    checkBenchCache("kept siblings still hit", rm::mapEngineCache(path_int8, key_int8, cache));
+    rm::unmapEngineCache(cache);
+
+    fs::remove_all(dir, ec);
+
+    char str[160];
+    snprintf(str, sizeof(str), "hash %.1f MB/s, write 1 MB %.0f us, map %.1f us",
+        onnx_mb / (hash_us * 1e-6), write_us, map_us);
+    std::cout << str << std::endl;
+    std::cout << "cache checks: " << (bench_cache_fail ? std::to_string(bench_cache_fail) + " failed" : std::string("all passed")) << std::endl;
+}
@@ -0,0 +1,97 @@
+#include "bench.h"
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <random>
+
+// 可见装甲板: 车体中心 (cx, cy)，朝向 theta 按整块装甲板平移到正对相机
+static Eigen::Matrix<double, 4, 1> getBenchIMMArmor(double cx, double cy, double theta, double r, int armor_num) {
+    double step = 2 * M_PI / armor_num;
+    theta += step * std::round((std::atan2(cy, cx) - theta) / step);
+    return Eigen::Matrix<double, 4, 1>(cx - r * std::cos(theta), cy - r * std::sin(theta), 0.1, theta);
+}
+
+// 三类目标: 平移步兵、小陀螺、前哨站
+static Eigen::Matrix<double, 4, 1> getBenchIMMTruth(int model, double t) {
+    if (model == rm::IMM_TRANSLATE_V1) return getBenchIMMArmor(4.0 + t, 0.5 + 0.5 * std::sin(t), 0.0, 0.25, 4);
+    if (model == rm::IMM_SPIN_V1) return getBenchIMMArmor(4.0 + 0.3 * t, 0.5, 6.0 * t + 0.3, 0.25, 4);
+    return getBenchIMMArmor(4.0, 0.5, rm::OUTPOST_OMEGA_V2 * t + 0.3, rm::OUTPOST_R_V2, 3);
+}
+
+// openrm -b imm [frames]
+void benchIMM(const std::vector<std::string>& args) {
+    int frames = (args.size() > 0) ? std::stoi(args[0]) : 1000;
+    const double dt = 0.01;
+
+    std::mt19937 rng(3);
+    std::normal_distribution<double> noise(0.0, 0.01), angle_noise(0.0, 0.03);
+    auto getNoisy = [&](Eigen::Matrix<double, 4, 1> pose) {
+        for (int i = 0; i < 3; i++) pose[i] += noise(rng);
+        pose[3] += angle_noise(rng);
+        return pose;
+    };
+
+    // 1. 多目标单帧耗时，与只跑 AntitopV3 对比
+    std::cout << "imm: " << frames << " frames at " << 1.0 / dt << " Hz" << std::endl;
+    std::cout << " targets   IMMV1 us/frame   AntitopV3 us/frame" << std::endl;
+    for (int num : {3, 5, 10}) {
+        std::vector<rm::IMMV1> imm(num);
+        std::vector<rm::AntitopV3> antitop(num);
+        double imm_us = 0.0, antitop_us = 0.0;
+        TimePoint start = getTime();
+        for (int f = 0; f < frames; f++) {
+            TimePoint tp = start + std::chrono::microseconds(static_cast<long>(f * dt * 1e6));
+            std::vector<Eigen::Matrix<double, 4, 1>> poses(num);
+            for (int j = 0; j < num; j++) poses[j] = getNoisy(getBenchIMMTruth(j % rm::IMM_MODEL_NUM_V1, f * dt));
+            imm_us += getBenchTime(1, [&](int) {
+                for (int j = 0; j < num; j++) imm[j].push(poses[j], tp);
+            });
+            antitop_us += getBenchTime(1, [&](int) {
+                for (int j = 0; j < num; j++) antitop[j].push(poses[j], tp);
+            });
+        }
+        char str[128];
+        snprintf(str, sizeof(str), " %7d  %15.2f  %19.2f", num, imm_us / frames, antitop_us / frames);
+        std::cout << str << std::endl;
+    }
+
+    // 2. 机动切换: 平移 3s -> 原地小陀螺 3s -> 平移 3s
+    // 延迟为切换后最可能模型连续 10 帧正确所需时间，稳态取每段最后 1s
+    const double phase = 3.0;
+    const int expect[3] = {rm::IMM_TRANSLATE_V1, rm::IMM_SPIN_V1, rm::IMM_TRANSLATE_V1};
+    rm::IMMV1 imm;
+    TimePoint start = getTime();
+    double latency[3] = {-1.0, -1.0, -1.0}, omega_err[3] = {0.0, 0.0, 0.0};
+    int wrong[3] = {0, 0, 0}, steady[3] = {0, 0, 0}, streak = 0;
+    double cx = 4.0, cy = 0.5, theta = 0.0, omega = 0.0;
+    for (int f = 0; f < static_cast<int>(3 * phase / dt); f++) {
+        double t = f * dt;
+        int seg = std::min(2, static_cast<int>(t / phase));
+        double t_seg = t - seg * phase;
+        double vy = (seg == 1) ? 0.0 : ((seg == 0) ? 0.8 : -0.8);
+        omega = (seg == 1) ? 6.0 : 0.0;
+        cy += vy * dt;
+        theta += omega * dt;
+
+        TimePoint tp = start + std::chrono::microseconds(static_cast<long>(t * 1e6));
+        imm.push(getNoisy(getBenchIMMArmor(cx, cy, theta, 0.25, 4)), tp);
+
+        bool correct = (imm.getModelIndex() == expect[seg]);
+        streak = (t_seg < dt / 2) ? 0 : (correct ? streak + 1 : 0);
+        if ((latency[seg] < 0) && (streak >= 10)) latency[seg] = t_seg - 9 * dt;
+        if (t_seg >= phase - 1.0) {
+            wrong[seg] += correct ? 0 : 1;
+            omega_err[seg] += std::pow(std::abs(imm.getOmega()) - omega, 2);
+            steady[seg]++;
+        }
+    }
+
+    std::cout << " manoeuvre           latency s   steady wrong   omega rmse" << std::endl;
+    const char* names[3] = {"translate", "-> spin", "-> translate"};
+    for (int seg = 0; seg < 3; seg++) {
+        char str[128];
+        snprintf(str, sizeof(str), " %-16s %12.3f %8d/%-6d %10.4f",
+            names[seg], latency[seg], wrong[seg], steady[seg], std::sqrt(omega_err[seg] / steady[seg]));
+        std::cout << str << std::endl;
+    }
+}
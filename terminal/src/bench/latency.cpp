@@ -0,0 +1,83 @@
+#include "bench.h"
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <random>
+
+// 目标在 4 m 处横向正弦运动 (峰值 3 m/s)，每 200 帧切换到另一侧的目标，云台需要大角度转动
+static Eigen::Matrix<double, 4, 1> getBenchLatencyTruth(double t, int frame) {
+    double side = ((frame / 200) % 2) ? 1.5 : -1.5;
+    return Eigen::Matrix<double, 4, 1>(4.0, side + std::sin(3.0 * t), 0.1, 0);
+}
+
+// 回放测试: 各阶段耗时按分布随机生成并逐帧 push 到 LatencyBudget，串口耗时在中途从 2 ms 变为 5 ms
+// 预测器把曝光时刻当作时间戳并按真值运动预测，只考察延迟补偿，统计瞄准点与弹丸到达时刻真值的水平误差
+// openrm -b latency [frames] [speed]
+void benchLatency(const std::vector<std::string>& args) {
+    int frames = (args.size() > 0) ? std::stoi(args[0]) : 2000;
+    double speed = (args.size() > 1) ? std::stod(args[1]) : 25.0;
+    const double dt = 0.01, capture = 0.004, control = 0.006;
+
+    std::mt19937 rng(4);
+    auto sample = [&](double mean, double std) {
+        return std::max(0.0, std::normal_distribution<double>(mean, std)(rng));
+    };
+
+    rm::LatencyBudget budget;
+    budget.setControlDelay(control);
+
+    // 不补偿、固定补偿 (按标称值一次性设定，不含云台转动)、LatencyBudget 在线补偿
+    const char* names[3] = {"none", "fixed", "budget"};
+    const double fixed_delay = capture + 0.002 + control;
+    std::vector<double> err[3], append_us;
+    double current_yaw = 0.0;
+
+    for (int f = 0; f < frames; f++) {
+        double t_exp = f * dt;
+        double detect = sample(0.006, 0.001), pnp = sample(0.001, 0.0002), predict = sample(0.0003, 0.0001);
+        double serial = (f < frames / 2) ? sample(0.002, 0.0005) : sample(0.005, 0.0005);
+
+        // 预测器只知道时间戳 t_exp + capture 时的位置，getPose 再加上时间戳到调用时刻的耗时
+        double sys_delay = detect + pnp + predict;
+        auto get_pose = [&](double append_delay) {
+            return getBenchLatencyTruth(t_exp + sys_delay + append_delay, f);
+        };
+
+        double yaw[3], pitch, fly[3], append[3];
+        append[0] = 0.0;
+        append[1] = fixed_delay;
+        fly[0] = rm::getFlyDelayIter(yaw[0], pitch, speed, get_pose, append[0]);
+        fly[1] = rm::getFlyDelayIter(yaw[1], pitch, speed, get_pose, append[1]);
+        append_us.push_back(getBenchTime(1, [&](int) {
+            fly[2] = budget.getFlyDelay(yaw[2], pitch, append[2], speed, current_yaw, get_pose);
+        }));
+
+        // 弹丸离膛时刻: 曝光 + 全流程 + 串口 + 下位机控制 + 云台转动
+        for (int m = 0; m < 3; m++) {
+            double t_fire = t_exp + capture + sys_delay + serial + control + rm::getRotateDelay(current_yaw, yaw[m]);
+            Eigen::Matrix<double, 4, 1> aim = get_pose(fly[m] + append[m]);
+            Eigen::Matrix<double, 4, 1> truth = getBenchLatencyTruth(t_fire + fly[m], f);
+            if (f >= 50) err[m].push_back((aim - truth).head(2).norm() * 1e3);
+        }
+        current_yaw = yaw[2];
+
+        budget.push(rm::LATENCY_CAPTURE, capture);
+        budget.push(rm::LATENCY_DETECT, detect);
+        budget.push(rm::LATENCY_PNP, pnp);
+        budget.push(rm::LATENCY_PREDICT, predict);
+        budget.push(rm::LATENCY_SERIAL, serial);
+    }
+
+    std::cout << "latency: " << frames << " frames, bullet " << speed << " m/s, serial 2 ms -> 5 ms at frame "
+              << frames / 2 << ", target switch every 200 frames" << std::endl;
+    for (int m = 0; m < 3; m++) {
+        std::cout << getBenchStatStr(std::string("aim err ") + names[m], getBenchStat(err[m]), "mm") << std::endl;
+    }
+    std::cout << getBenchStatStr("budget getFlyDelay", getBenchStat(append_us), "us") << std::endl;
+
+    char str[128];
+    snprintf(str, sizeof(str), "serial %.2f ms (std %.2f), total %.2f ms, total + 2 sigma %.2f ms",
+        budget.getStage(rm::LATENCY_SERIAL) * 1e3, budget.getStageStd(rm::LATENCY_SERIAL) * 1e3,
+        budget.getTotal() * 1e3, budget.getTotal(2.0) * 1e3);
+    std::cout << str << std::endl;
+}
@@ -0,0 +1,81 @@
+#include "bench.h"
+#include <iostream>
+#include <random>
+#ifdef OPENRM_WITH_TENSORRT
+#include <cudatools.h>
+#include <cuda_runtime_api.h>
+#endif
+
+// 对比 CPU letterbox 与原有预处理路径的像素差异与耗时
+// 有 TensorRT 时参考为 GPU 上的 rm::resize，否则为相同仿射矩阵的 cv::warpAffine
+// openrm -b letterbox [image] [width] [height]
+void benchLetterbox(const std::vector<std::string>& args) {
+    int dst_width = (args.size() > 1) ? std::stoi(args[1]) : 640;
+    int dst_height = (args.size() > 2) ? std::stoi(args[2]) : 640;
+
+    cv::Mat src;
+    if (!args.empty()) src = cv::imread(args[0], cv::IMREAD_COLOR);
+    if (src.empty()) {
+        src = cv::Mat(1024, 1280, CV_8UC3);
+        cv::randu(src, cv::Scalar::all(0), cv::Scalar::all(255));
+    }
+    size_t area = static_cast<size_t>(dst_width) * dst_height;
+    std::vector<float> cpu(3 * area), ref(3 * area);
+
+    double cpu_time = getBenchTime(20, [&](int) {
+        rm::letterbox(src, cpu.data(), dst_width, dst_height);
+    });
+
+    double ref_time = 0.0;
+#ifdef OPENRM_WITH_TENSORRT
+    std::string ref_name = "rm::resize (cuda)";
+    uint8_t* src_device = nullptr;
+    float* dst_device = nullptr;
+    cudaStream_t stream;
+    cudaStreamCreate(&stream);
+    cudaMalloc(reinterpret_cast<void**>(&src_device), src.total() * 3);
+    cudaMalloc(reinterpret_cast<void**>(&dst_device), ref.size() * sizeof(float));
+    cudaMemcpy(src_device, src.data, src.total() * 3, cudaMemcpyHostToDevice);
+    ref_time = getBenchTime(20, [&](int) {
+        rm::resize(src_device, src.cols, src.rows, dst_device, dst_width, dst_height, &stream);
+        cudaStreamSynchronize(stream);
+    });
+    cudaMemcpy(ref.data(), dst_device, ref.size() * sizeof(float), cudaMemcpyDeviceToHost);
+    cudaFree(src_device);
+    cudaFree(dst_device);
+    cudaStreamDestroy(stream);
+#else
+    std::string ref_name = "cv::warpAffine";
+    ref_time = getBenchTime(20, [&](int) {
+        // 与 rm::letterbox 相同的 dst -> src 仿射矩阵
+        double scale = std::min(static_cast<double>(dst_height) / src.rows, static_cast<double>(dst_width) / src.cols);
+        cv::Mat M = (cv::Mat_<double>(2, 3) <<
+            1 / scale, 0, -0.5 / scale * dst_width + 0.5 * src.cols + 0.5,
+            0, 1 / scale, -0.5 / scale * dst_height + 0.5 * src.rows + 0.5);
+        cv::Mat warp;
+        cv::warpAffine(src, warp, M, cv::Size(dst_width, dst_height),
+            cv::INTER_LINEAR | cv::WARP_INVERSE_MAP, cv::BORDER_CONSTANT, cv::Scalar::all(114));
+        for (int y = 0; y < dst_height; y++) {
+            const uint8_t* row = warp.ptr<uint8_t>(y);
+            for (int x = 0; x < dst_width; x++) {
+                for (int c = 0; c < 3; c++) {
+                    ref[c * area + y * dst_width + x] = row[x * 3 + 2 - c] / 255.0f;
+                }
+            }
+        }
+    });
+#endif
+
+    std::vector<double> diff(ref.size());
+    int over = 0;
+    for (size_t i = 0; i < ref.size(); i++) {
+        diff[i] = std::abs(cpu[i] - ref[i]) * 255.0;
+        if (diff[i] > 1.0) over++;
+    }
+
+    std::cout << "letterbox: " << src.cols << "x" << src.rows << " -> " << dst_width << "x" << dst_height
+              << ", reference " << ref_name << std::endl;
+    std::cout << getBenchStatStr("pixel difference", getBenchStat(diff), "level") << std::endl;
+    std::cout << "values differing by more than 1 level: " << over << " / " << ref.size() << std::endl;
+    std::cout << "cpu letterbox " << cpu_time << " us, reference " << ref_time << " us" << std::endl;
+}
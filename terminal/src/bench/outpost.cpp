@@ -0,0 +1,76 @@
+#include "bench.h"
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <random>
+
+// 前哨站仿真: 中心静止，三块装甲板以 0.8pi rad/s (带 2% 偏差) 旋转，观测为最正对相机的装甲板
+// 时间戳从构造时刻开始向后排列，窗口时刻换算回仿真时间后与真值相位比较
+static void runBenchOutpost(int trials, double history, double angle_noise, double fly_delay) {
+    const double fire_angle = 0.1, dt = 0.01;
+    std::mt19937 rng(static_cast<unsigned>(history * 100));
+    std::normal_distribution<double> noise(0.0, 1.0);
+
+    int locked = 0;
+    std::vector<double> best_err[3], best_ms, cover;
+    for (int trial = 0; trial < trials; trial++) {
+        rm::OutpostV2 outpost;
+        outpost.setFireValue(100, 0.1, fire_angle, fire_angle);
+        TimePoint start = getTime();
+        auto at = [&](double s) { return start + std::chrono::duration_cast<TimePoint::duration>(Duration_s(s)); };
+
+        double omega = ((trial % 2) ? 1.0 : -1.0) * rm::OUTPOST_OMEGA_V2 * (1.0 + 0.02 * noise(rng));
+        double xc = 5.0 + noise(rng), yc = noise(rng), phase0 = noise(rng);
+        double center = std::atan2(yc, xc);
+        auto getPhaseErr = [&](double s) { return std::remainder(phase0 + omega * s - center, 2 * M_PI / 3); };
+
+        int steps = static_cast<int>(history / dt);
+        for (int i = 1; i <= steps; i++) {
+            double s = i * dt;
+            double theta = center + getPhaseErr(s);
+            Eigen::Matrix<double, 4, 1> pose(
+                xc - rm::OUTPOST_R_V2 * std::cos(theta) + 0.01 * noise(rng),
+                yc - rm::OUTPOST_R_V2 * std::sin(theta) + 0.01 * noise(rng),
+                0.5, theta + angle_noise * noise(rng));
+            outpost.push(pose, at(s));
+        }
+
+        std::vector<rm::OutpostFireWindow> windows;
+        if (!outpost.getFireWindows(windows, fly_delay, 3)) continue;
+        locked++;
+
+        for (size_t k = 0; k < windows.size(); k++) {
+            double best = getDoubleOfS(start, windows[k].best) + fly_delay;
+            double err = getPhaseErr(best);
+            best_err[k].push_back(std::abs(err));
+            best_ms.push_back(std::abs(err / omega) * 1e3);
+
+            // 窗口内按 1 ms 采样开火时刻，命中时真值相位在开火角内的比例
+            double s0 = getDoubleOfS(start, windows[k].start), s1 = getDoubleOfS(start, windows[k].end);
+            int inside = 0, total = 0;
+            for (double s = s0; s <= s1; s += 1e-3, total++) {
+                if (std::abs(getPhaseErr(s + fly_delay)) <= fire_angle) inside++;
+            }
+            if (total > 0) cover.push_back(static_cast<double>(inside) / total);
+        }
+    }
+
+    char str[200];
+    snprintf(str, sizeof(str), " %6.1f %6d/%-5d %8.4f %8.4f %8.4f %9.2f %9.2f %8.3f %8.3f",
+        history, locked, trials, getBenchStat(best_err[0]).p95, getBenchStat(best_err[1]).p95, getBenchStat(best_err[2]).p95,
+        getBenchStat(best_ms).p50, getBenchStat(best_ms).p95, getBenchStat(cover).mean, getBenchStat(cover).p50);
+    std::cout << str << std::endl;
+}
+
+// OutpostV2 开火窗口相对真值相位的精度
+// openrm -b outpost [trials] [angle_noise] [fly_delay]
+void benchOutpost(const std::vector<std::string>& args) {
+    int trials = (args.size() > 0) ? std::stoi(args[0]) : 200;
+    double angle_noise = (args.size() > 1) ? std::stod(args[1]) : 0.05;
+    double fly_delay = (args.size() > 2) ? std::stod(args[2]) : 0.3;
+
+    std::cout << "outpost: " << trials << " trials, angle noise " << angle_noise << " rad, fly delay "
+              << fly_delay << " s, fire angle 0.1 rad, 3 windows each" << std::endl;
+    std::cout << " history    locked  p95 phase err rad (w1 w2 w3)  best ms p50/p95   in-angle mean/p50" << std::endl;
+    for (double history : {1.0, 2.0, 4.0, 8.0}) runBenchOutpost(trials, history, angle_noise, fly_delay);
+}
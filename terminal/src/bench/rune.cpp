@@ -0,0 +1,169 @@
+#include "bench.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <random>
+
+struct BenchRuneTruth {
+    Eigen::Vector3d center;                 // R 标中心
+    double theta;                           // 符面法向 yaw，指向场景内，与 RuneV2 观测一致
+    double angle;                           // 待激活扇叶角度
+    int    leaf;                            // 待激活扇叶序号
+};
+
+// 大符真值: 7 m 外，符面略偏转，按 spd = a * sin(w t + p) + 2.090 - a 旋转，每 2.5 s 切换待激活扇叶
+static BenchRuneTruth getBenchRuneTruth(double t) {
+    const double a = 0.9, w = 1.942, p = 0.7;
+    BenchRuneTruth truth;
+    truth.center = Eigen::Vector3d(7.0, 0.8, 0.9);
+    truth.theta = std::atan2(0.8, 7.0) + 0.25;
+    truth.leaf = (static_cast<int>(t / 2.5) * 3) % 5;
+    double base = (2.090 - a) * t + a / w * (std::cos(p) - std::cos(w * t + p));
+    truth.angle = std::remainder(base + truth.leaf * 2 * M_PI / 5, 2 * M_PI);
+    return truth;
+}
+
+// 符面内坐标 (u 向右, v 向上) 投影到像素
+static cv::Point getBenchRunePixel(const rm::YawPnPShared& shared, const BenchRuneTruth& truth, double u, double v) {
+    Eigen::Vector4d world;
+    world << truth.center + u * Eigen::Vector3d(std::sin(truth.theta), -std::cos(truth.theta), 0) + v * Eigen::Vector3d::UnitZ(), 1;
+    Eigen::Vector3d pnp = (shared.T_inv * world).head<3>();
+    Eigen::Vector3d pixel = shared.Kc * (pnp / pnp[2]);
+    return cv::Point(static_cast<int>(std::lround(pixel[0])), static_cast<int>(std::lround(pixel[1])));
+}
+
+// 绘制 R 标、已激活扇叶 (灯臂常亮) 与待激活扇叶 (灯臂为间断箭头)，靶心为圆环
+static void drawBenchRune(cv::Mat& img, const rm::YawPnPShared& shared, const BenchRuneTruth& truth, const cv::Scalar& color) {
+    img.setTo(cv::Scalar::all(0));
+    auto polygon = [&](const std::vector<std::pair<double, double>>& points) {
+        std::vector<std::vector<cv::Point>> poly(1);
+        for (const auto& [u, v] : points) poly[0].push_back(getBenchRunePixel(shared, truth, u, v));
+        return poly;
+    };
+    auto circle = [&](double cu, double cv_, double r) {
+        std::vector<std::pair<double, double>> points;
+        for (int i = 0; i < 64; i++) points.emplace_back(cu + r * std::cos(i * M_PI / 32), cv_ + r * std::sin(i * M_PI / 32));
+        return polygon(points);
+    };
+    auto bar = [&](double dir, double from, double to, double half) {
+        double c = std::cos(dir), s = std::sin(dir);
+        return polygon({{from * c + half * s, from * s - half * c}, {to * c + half * s, to * s - half * c},
+                        {to * c - half * s, to * s + half * c}, {from * c - half * s, from * s + half * c}});
+    };
+
+    cv::fillPoly(img, polygon({{-0.08, -0.08}, {0.08, -0.08}, {0.08, 0.08}, {-0.08, 0.08}}), color);
+    for (int k : {0, 1, 2}) {
+        double dir = truth.angle + k * 2 * M_PI / 5;
+        double cu = rm::R * std::cos(dir), cw = rm::R * std::sin(dir);
+        if (k == 0) {
+            for (double from = 0.2; from < 0.5; from += 0.1) cv::fillPoly(img, bar(dir, from, from + 0.03, 0.02), color);
+        } else {
+            cv::fillPoly(img, bar(dir, 0.2, rm::R - 0.16, 0.02), color);
+        }
+        cv::fillPoly(img, circle(cu, cw, 0.18), color);
+        cv::fillPoly(img, circle(cu, cw, 0.15), cv::Scalar::all(0));
+    }
+}
+
+// 回放录制的符视频 (或合成帧)，对比 findRune 全图与 ROI 耗时，solveRunePose 结果送入 RuneV2::push
+// 合成帧有真值，额外统计位姿误差，验证 theta / angle 与 RuneV2_FuncH 的约定一致
+// 录制视频的相机内参按 1200 焦距近似，预测误差以 0.3 s 后的解算结果为参考
+// openrm -b rune [video|-] [fps] [red|blue]
+void benchRune(const std::vector<std::string>& args) {
+    bool synthetic = args.empty() || (args[0] == "-");
+    double fps = (args.size() > 1) ? std::stod(args[1]) : 100.0;
+    rm::ArmorColor color = ((args.size() > 2) && (args[2] == "blue")) ? rm::ARMOR_COLOR_BLUE : rm::ARMOR_COLOR_RED;
+    const double dt = 1.0 / fps, horizon = 0.3;
+    const int frames = 1000;
+
+    cv::VideoCapture capture;
+    if (!synthetic && !capture.open(args[0])) {
+        rm::message("Failed to open " + args[0], rm::MSG_ERROR);
+        return;
+    }
+
+    rm::Camera camera;
+    if (synthetic) {
+        getBenchCamera(camera);
+    } else {
+        getBenchCamera(camera, static_cast<int>(capture.get(cv::CAP_PROP_FRAME_WIDTH)),
+                               static_cast<int>(capture.get(cv::CAP_PROP_FRAME_HEIGHT)));
+    }
+    rm::YawPnPShared shared;
+    getYawPnPShared(&camera, Eigen::Matrix3d::Identity(), Eigen::Matrix4d::Identity(), shared);
+
+    // 1. 逐帧识别与解算
+    cv::Scalar draw_color = (color == rm::ARMOR_COLOR_RED) ? cv::Scalar(40, 40, 255) : cv::Scalar(255, 40, 40);
+    cv::Mat img(camera.height, camera.width, CV_8UC3);
+    rm::Rune tracked;
+    std::vector<double> full_us, roi_us, pose_mm, theta_deg, angle_deg;
+    std::vector<Eigen::Matrix<double, 5, 1>> poses;
+    std::vector<bool> valids;
+    for (int k = 0; synthetic ? (k < frames) : capture.read(img); k++) {
+        BenchRuneTruth truth = getBenchRuneTruth(k * dt);
+        if (synthetic) drawBenchRune(img, shared, truth, draw_color);
+
+        rm::Rune fresh;
+        full_us.push_back(getBenchTime(1, [&](int) { rm::findRune(img, fresh, color); }));
+        bool was_tracking = tracked.valid;
+        bool found = false;
+        double us = getBenchTime(1, [&](int) { found = rm::findRune(img, tracked, color); });
+        if (was_tracking) roi_us.push_back(us);
+
+        Eigen::Matrix<double, 5, 1> pose;
+        bool valid = found && rm::solveRunePose(&camera, shared, tracked, pose);
+        poses.push_back(pose);
+        valids.push_back(valid);
+        if (!valid || !synthetic) continue;
+
+        Eigen::Vector3d target = truth.center + rm::R * std::cos(truth.angle) * Eigen::Vector3d(std::sin(truth.theta), -std::cos(truth.theta), 0)
+                               + rm::R * std::sin(truth.angle) * Eigen::Vector3d::UnitZ();
+        pose_mm.push_back((pose.head<3>() - target).norm() * 1e3);
+        theta_deg.push_back(std::abs(std::remainder(pose[3] - truth.theta, 2 * M_PI)) * 180 / M_PI);
+        angle_deg.push_back(std::abs(std::remainder(pose[4] - truth.angle, 2 * M_PI)) * 180 / M_PI);
+    }
+
+    // 2. 按帧间隔重放到 RuneV2，时间戳从当前时刻开始，getPose 的 append_delay 扣除已经流逝的时间
+    rm::RuneV2 rune_v2;
+    rune_v2.setRuneType(true);
+    int horizon_frames = static_cast<int>(std::lround(horizon / dt));
+    std::vector<double> predict_mm, push_us;
+    TimePoint start = getTime();
+    for (size_t k = 0; k < poses.size(); k++) {
+        if (!valids[k]) continue;
+        TimePoint t = start + std::chrono::microseconds(static_cast<long>(k * dt * 1e6));
+        push_us.push_back(getBenchTime(1, [&](int) { rune_v2.push(poses[k], t); }));
+
+        size_t future = k + horizon_frames;
+        if ((k < 200) || (future >= poses.size())) continue;
+        Eigen::Vector3d reference;
+        if (synthetic) {
+            BenchRuneTruth truth = getBenchRuneTruth(future * dt);
+            double angle = std::remainder(truth.angle - (truth.leaf - getBenchRuneTruth(k * dt).leaf) * 2 * M_PI / 5, 2 * M_PI);
+            reference = truth.center + rm::R * std::cos(angle) * Eigen::Vector3d(std::sin(truth.theta), -std::cos(truth.theta), 0)
+                      + rm::R * std::sin(angle) * Eigen::Vector3d::UnitZ();
+        } else {
+            if (!valids[future]) continue;
+            reference = poses[future].head<3>();
+        }
+        Eigen::Matrix<double, 4, 1> predict = rune_v2.getPose(horizon - getDoubleOfS(t, getTime()));
+        if (predict.head<3>().isZero()) continue;
+        predict_mm.push_back((predict.head<3>() - reference).norm() * 1e3);
+    }
+
+    int valid_num = static_cast<int>(std::count(valids.begin(), valids.end(), true));
+    std::cout << "rune: " << (synthetic ? std::string("synthetic") : args[0]) << ", " << poses.size() << " frames "
+              << camera.width << "x" << camera.height << ", " << valid_num << " solved" << std::endl;
+    std::cout << getBenchStatStr("findRune full", getBenchStat(full_us), "us") << std::endl;
+    BenchStat roi_stat = getBenchStat(roi_us);
+    std::cout << getBenchStatStr("findRune roi", roi_stat, "us") << std::endl;
+    std::cout << "roi p95 within 1 ms: " << ((roi_stat.p95 <= 1000.0) ? "yes" : "no") << std::endl;
+    if (synthetic) {
+        std::cout << getBenchStatStr("target pos err", getBenchStat(pose_mm), "mm") << std::endl;
+        std::cout << getBenchStatStr("theta err", getBenchStat(theta_deg), "deg") << std::endl;
+        std::cout << getBenchStatStr("angle err", getBenchStat(angle_deg), "deg") << std::endl;
+    }
+    std::cout << getBenchStatStr("RuneV2 push", getBenchStat(push_us), "us") << std::endl;
+    std::cout << getBenchStatStr("predict 0.3s err", getBenchStat(predict_mm), "mm") << std::endl;
+}
@@ -0,0 +1,71 @@
+#include "bench.h"
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <random>
+
+// 大符合成数据: spd = a * sin(w t + p0) + 2.090 - a，随机切换符叶并把角度折回 [-pi, pi)
+// 每 10 帧拟合一次，a / w 误差小于 0.02 且相位误差小于 0.1 rad 记为收敛
+static void runBenchRuneFit(int runs, double noise, int frames) {
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::normal_distribution<double> angle_noise(0.0, noise);
+
+    std::vector<double> err_a, err_w, err_p, fit_us, converge_frames;
+    int converged = 0;
+    for (int run = 0; run < runs; run++) {
+        double a = 0.780 + 0.265 * uniform(rng);
+        double w = 1.884 + 0.116 * uniform(rng);
+        double p0 = 2 * M_PI * uniform(rng);
+        double sign = (uniform(rng) < 0.5) ? 1.0 : -1.0;
+        double b = 2.090 - a, leaf = 0.0;
+
+        rm::RuneFit fit(300);
+        rm::RuneFitResult result;
+        int first = -1;
+        for (int k = 0; k < frames; k++) {
+            double t = k * 0.01;
+            if (uniform(rng) < 0.005) leaf = std::floor(5 * uniform(rng));
+            double angle = sign * (b * t + a / w * (std::cos(p0) - std::cos(w * t + p0))) + leaf * 2 * M_PI / 5;
+            fit.push(t, std::remainder(angle + angle_noise(rng), 2 * M_PI));
+            if (k % 10 != 9) continue;
+
+            bool valid = false;
+            fit_us.push_back(getBenchTime(1, [&](int) { valid = fit.fit(sign, result); }));
+            double phase = std::remainder(w * t + p0, 2 * M_PI);
+            bool close = valid && (std::abs(result.a - a) < 0.02) && (std::abs(result.w - w) < 0.02)
+                      && (std::abs(std::remainder(result.p - phase, 2 * M_PI)) < 0.1);
+            if (close && (first < 0)) first = k + 1;
+        }
+
+        double phase = std::remainder(w * (frames - 1) * 0.01 + p0, 2 * M_PI);
+        err_a.push_back(std::abs(result.a - a));
+        err_w.push_back(std::abs(result.w - w));
+        err_p.push_back(std::abs(std::remainder(result.p - phase, 2 * M_PI)));
+        if (first >= 0) {
+            converged++;
+            converge_frames.push_back(first);
+        }
+    }
+
+    BenchStat a_stat = getBenchStat(err_a), w_stat = getBenchStat(err_w), p_stat = getBenchStat(err_p);
+    BenchStat frame_stat = getBenchStat(converge_frames);
+    char str[200];
+    snprintf(str, sizeof(str), " %6.3f %6d/%-4d %8.0f %8.0f   %.4f/%.4f  %.4f/%.4f  %.4f/%.4f %8.1f",
+        noise, converged, runs, frame_stat.mean, frame_stat.max,
+        a_stat.p50, a_stat.p95, w_stat.p50, w_stat.p95, p_stat.p50, p_stat.p95, getBenchStat(fit_us).mean);
+    std::cout << str << std::endl;
+}
+
+// RuneFit 在合成正弦速度 + 噪声上的拟合精度、收敛帧数与耗时
+// openrm -b runefit [runs] [noise]
+void benchRuneFit(const std::vector<std::string>& args) {
+    int runs = (args.size() > 0) ? std::stoi(args[0]) : 50;
+    std::vector<double> noises = {0.005, 0.01, 0.02, 0.05};
+    if (args.size() > 1) noises = {std::stod(args[1])};
+    const int frames = 400;
+
+    std::cout << "runefit: " << runs << " runs of " << frames << " frames at 100 Hz, window 300, fit every 10 frames" << std::endl;
+    std::cout << "  noise  converged  frames  max      a p50/p95      w p50/p95      p p50/p95      fit us" << std::endl;
+    for (double noise : noises) runBenchRuneFit(runs, noise, frames);
+}
@@ -0,0 +1,138 @@
+#include "bench.h"
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <type_traits>
+
+struct BenchScorerTarget {
+    rm::ArmorID id;                         // Armor id of target
+    double a0, b, w;                        // Angle from crosshair is |a0 + b * sin(w t)|
+    double d0;                              // Mean distance, m
+    bool   visible = true;                  // Whether target is visible in this frame
+    bool   seen = false;                    // Whether target has been observed
+    double seen_t = 0.0;                    // Replay time of last observation
+    double angle = 0.0;                     // Last observed angle, rad
+    double distance = 0.0;                  // Last observed distance, m
+    double hit = 0.0;                       // Hit probability in this frame, 0 when not visible
+};
+
+struct BenchScorerResult {
+    double hit = 0.0;                       // Sum of hit probability of the selected target
+    int    switches = 0;                    // Number of target switches
+    int    frames = 0;                      // Number of replayed frames
+    int    hero = 0;                        // Frames focused on the hero
+    std::vector<double> pop_us;             // Time of each pop, us
+};
+
+// 回放一局: 4 个目标角度与距离按脚本变化，每帧 1% 概率出现或消失
+// 消失的目标按最后一次观测重新 push，时间戳按回放时间回退，使超时判断跟随回放时间而不是墙上时间
+// 命中率代理: 选中目标当前帧的命中概率，切换后 0.15 s 云台转动期间记为 0
+template<typename Attack>
+static BenchScorerResult runBenchScorer(Attack& attack, unsigned seed, int frames, bool full) {
+    const double dt = 0.01, settle_time = 0.15, sigma = 0.15;
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    std::vector<BenchScorerTarget> targets;
+    for (rm::ArmorID id : {rm::ARMOR_ID_HERO, rm::ARMOR_ID_INFANTRY_3, rm::ARMOR_ID_INFANTRY_4, rm::ARMOR_ID_SENTRY}) {
+        BenchScorerTarget target;
+        target.id = id;
+        target.a0 = 0.6 * uniform(rng);
+        target.b = 0.2 + 0.5 * uniform(rng);
+        target.w = 0.3 + uniform(rng);
+        target.d0 = 2.0 + 5.0 * uniform(rng);
+        targets.push_back(target);
+    }
+
+    BenchScorerResult result;
+    rm::ArmorID last_id = rm::ARMOR_ID_UNKNOWN;
+    double settle = 0.0;
+    for (int f = 0; f < frames; f++) {
+        double t = f * dt;
+        TimePoint now = getTime();
+        for (size_t i = 0; i < targets.size(); i++) {
+            BenchScorerTarget& target = targets[i];
+            if (uniform(rng) < 0.01) target.visible = !target.visible;
+            target.hit = 0.0;
+            if (target.visible) {
+                target.angle = std::abs(target.a0 + target.b * std::sin(target.w * t));
+                target.distance = target.d0 + std::sin(0.2 * t + i);
+                double big = (target.id == rm::ARMOR_ID_HERO) ? 1.3 : 1.0;
+                target.hit = std::min(1.0, std::exp(-target.angle * target.angle / (2 * sigma * sigma))
+                                         * std::min(1.0, 3.0 / target.distance) * big);
+                target.seen = true;
+                target.seen_t = t;
+            }
+            if (!target.seen) continue;
+
+            TimePoint stamp = now - std::chrono::duration_cast<TimePoint::duration>(Duration_s(t - target.seen_t));
+            if constexpr (std::is_same_v<Attack, rm::Scorer>) {
+                if (full) {
+                    rm::ArmorSize size = (target.id == rm::ARMOR_ID_HERO) ? rm::ARMOR_SIZE_BIG_ARMOR : rm::ARMOR_SIZE_SMALL_ARMOR;
+                    attack.push(target.id, target.angle, target.distance, target.hit, size, stamp);
+                    continue;
+                }
+            }
+            attack.push(target.id, target.angle, stamp);
+        }
+
+        rm::ArmorID id = rm::ARMOR_ID_UNKNOWN;
+        result.pop_us.push_back(getBenchTime(1, [&](int) { id = attack.pop(); }));
+        if ((id != rm::ARMOR_ID_UNKNOWN) && (last_id != rm::ARMOR_ID_UNKNOWN) && (id != last_id)) {
+            result.switches++;
+            settle = settle_time;
+        }
+        if ((id != rm::ARMOR_ID_UNKNOWN) && (settle <= 0.0)) {
+            for (const auto& target : targets) if (target.id == id) result.hit += target.hit;
+        }
+        if (id == rm::ARMOR_ID_HERO) result.hero++;
+        if (id != rm::ARMOR_ID_UNKNOWN) last_id = id;
+        settle -= dt;
+        result.frames++;
+    }
+    return result;
+}
+
+// Scorer 与 DeadLocker / Filtrate / FreshCenter 在同一组脚本回放上的命中率代理、切换频率与 pop 耗时
+// Scorer(angle) 只 push 角度，与旧选择器输入相同；Scorer(full) 额外 push 距离、命中概率与装甲板大小
+// openrm -b scorer [runs] [seconds]
+void benchScorer(const std::vector<std::string>& args) {
+    int runs = (args.size() > 0) ? std::stoi(args[0]) : 50;
+    double seconds = (args.size() > 1) ? std::stod(args[1]) : 30.0;
+    int frames = static_cast<int>(seconds * 100);
+
+    const char* names[5] = {"DeadLocker", "Filtrate", "FreshCenter", "Scorer(angle)", "Scorer(full)"};
+    BenchScorerResult total[5];
+    auto add = [](BenchScorerResult& sum, const BenchScorerResult& one) {
+        sum.hit += one.hit;
+        sum.switches += one.switches;
+        sum.frames += one.frames;
+        sum.hero += one.hero;
+        sum.pop_us.insert(sum.pop_us.end(), one.pop_us.begin(), one.pop_us.end());
+    };
+    for (int run = 0; run < runs; run++) {
+        unsigned seed = static_cast<unsigned>(run);
+        rm::DeadLocker dead_locker;
+        rm::Filtrate filtrate;
+        rm::FreshCenter fresh_center;
+        rm::Scorer scorer_angle, scorer_full;
+        add(total[0], runBenchScorer(dead_locker, seed, frames, false));
+        add(total[1], runBenchScorer(filtrate, seed, frames, false));
+        add(total[2], runBenchScorer(fresh_center, seed, frames, false));
+        add(total[3], runBenchScorer(scorer_angle, seed, frames, false));
+        add(total[4], runBenchScorer(scorer_full, seed, frames, true));
+    }
+
+    std::cout << "scorer: " << runs << " replays of " << seconds << " s at 100 Hz, 4 targets, 0.15 s settle after switch" << std::endl;
+    std::cout << " selector        hits/frame  switches/min  hero share   pop us mean/p95" << std::endl;
+    for (int i = 0; i < 5; i++) {
+        BenchStat stat = getBenchStat(total[i].pop_us);
+        double minutes = total[i].frames * 0.01 / 60.0;
+        char str[160];
+        snprintf(str, sizeof(str), " %-14s %11.3f %13.1f %11.2f %9.2f/%.2f",
+            names[i], total[i].hit / total[i].frames, total[i].switches / minutes,
+            static_cast<double>(total[i].hero) / total[i].frames, stat.mean, stat.p95);
+        std::cout << str << std::endl;
+    }
+}
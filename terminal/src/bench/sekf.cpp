@@ -0,0 +1,105 @@
+#include "bench.h"
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <random>
+
+// TrackQueueV3 的状态转移只写了前 10 维，这里补齐第 11 维并给出解析雅可比与稀疏结构
+struct BenchTQ3_FuncA {
+    template<class T>
+    void operator()(const T x0[11], T x1[11]) {
+        rm::TrackQueueV3_FuncA func{dt};
+        func(x0, x1);
+        x1[10] = x0[10];
+    }
+    template<class M>
+    void jacobian(const double x0[11], M& F) {
+        F = M::Identity();
+        F(0, 4) = dt;
+        F(0, 8) = 0.5 * dt * dt;
+        F(1, 5) = dt;
+        F(1, 9) = 0.5 * dt * dt;
+        F(2, 6) = dt;
+        F(3, 7) = dt;
+        F(3, 10) = 0.5 * dt * dt;
+        F(4, 8) = dt;
+        F(5, 9) = dt;
+        F(7, 10) = dt;
+    }
+    static constexpr int sparsity[][2] = {{0, 4}, {0, 8}, {1, 5}, {1, 9}, {2, 6}, {3, 7}, {3, 10}, {4, 8}, {5, 9}, {7, 10}};
+    double dt;
+};
+
+// 同一观测序列分别送入 EKF 与 SEKF，比较单步耗时与状态、协方差的差异
+template<int dimX, int dimY, class FuncA, class FuncH, class Gen>
+static void runBenchSEKF(const char* name, int steps, Gen&& gen, const Eigen::Matrix<double, dimX, 1>& init) {
+    using VecY = Eigen::Matrix<double, dimY, 1>;
+    std::vector<VecY> measures(steps);
+    for (int k = 0; k < steps; k++) measures[k] = gen(k);
+
+    EKF<dimX, dimY> ekf;
+    SEKF<dimX, dimY> sekf;
+    ekf.Q = EKF<dimX, dimY>::MatXX::Identity() * 1e-2;
+    ekf.R = EKF<dimX, dimY>::MatYY::Identity() * 1e-3;
+    sekf.Q = ekf.Q;
+    sekf.R = ekf.R;
+
+    // 每 500 步重启一次，模拟目标丢失后重新建模
+    auto run = [&](auto& filter) {
+        FuncA func_a;
+        FuncH func_h;
+        func_a.dt = 0.005;
+        return getBenchTime(steps, [&](int k) {
+            if (k % 500 == 0) {
+                filter.restart();
+                filter.estimate_X = init;
+            }
+            filter.predict(func_a);
+            filter.update(func_h, measures[k]);
+        });
+    };
+    double ekf_us = run(ekf);
+    double sekf_us = run(sekf);
+
+    double x_diff = (ekf.estimate_X - sekf.estimate_X).cwiseAbs().maxCoeff();
+    double p_diff = (ekf.P - sekf.P).cwiseAbs().maxCoeff() / std::max(1.0, ekf.P.cwiseAbs().maxCoeff());
+    bool pass = (x_diff < 1e-6) && (p_diff < 1e-9);
+
+    char str[160];
+    snprintf(str, sizeof(str), " %-16s %10.1f %10.1f %8.2f   %.2e   %.2e   %s",
+        name, ekf_us * 1e3, sekf_us * 1e3, ekf_us / sekf_us, x_diff, p_diff, pass ? "ok" : "FAIL");
+    std::cout << str << std::endl;
+}
+
+// openrm -b sekf [steps]
+void benchSEKF(const std::vector<std::string>& args) {
+    int steps = (args.size() > 0) ? std::stoi(args[0]) : 200000;
+
+    std::mt19937 rng(0);
+    std::normal_distribution<double> noise(0.0, 0.01);
+    const double dt = 0.005;
+
+    std::cout << "sekf: " << steps << " steps, EKF vs SEKF on identical measurements" << std::endl;
+    std::cout << " model              EKF ns    SEKF ns  speedup   max dX     max dP/|P|" << std::endl;
+
+    // TrackQueueV4: 匀加速转弯
+    runBenchSEKF<8, 3, rm::TrackQueueV4_FuncA, rm::TrackQueueV4_FuncH>("<8,3>  tq4", steps, [&](int k) {
+        double t = k * dt, theta = 0.5 * t;
+        return Eigen::Matrix<double, 3, 1>(
+            4.0 + 2.0 * sin(theta) + noise(rng), 1.0 - 2.0 * cos(theta) + noise(rng), 0.1 + noise(rng));
+    }, Eigen::Matrix<double, 8, 1>(4, -1, 0.1, 1, 0, 0, 0.5, 0));
+
+    // AntitopV3: 中心静止的小陀螺
+    runBenchSEKF<9, 4, rm::AntitopV3_FuncA, rm::AntitopV3_FuncH>("<9,4>  antitop3", steps, [&](int k) {
+        double theta = 6.0 * k * dt;
+        return Eigen::Matrix<double, 4, 1>(
+            4.0 - 0.25 * cos(theta) + noise(rng), 1.0 - 0.25 * sin(theta) + noise(rng), 0.1 + noise(rng), theta);
+    }, (Eigen::Matrix<double, 9, 1>() << 4, 1, 0.1, 0, 0, 0, 0, 6, 0.25).finished());
+
+    // TrackQueueV3: 匀加速直线
+    runBenchSEKF<11, 4, BenchTQ3_FuncA, rm::TrackQueueV3_FuncH>("<11,4> tq3", steps, [&](int k) {
+        double t = (k % 500) * dt;
+        return Eigen::Matrix<double, 4, 1>(
+            4.0 + t + 0.25 * t * t + noise(rng), 1.0 - 0.5 * t + noise(rng), 0.1 + noise(rng), 0.2 * t + noise(rng));
+    }, Eigen::Matrix<double, 11, 1>::Zero());
+}
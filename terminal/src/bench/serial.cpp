@@ -0,0 +1,152 @@
+#include "bench.h"
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <iostream>
+#include <random>
+#include <termios.h>
+#include <unistd.h>
+
+struct BenchSerialAim {
+    uint64_t seq;                           // Sequence number
+    double   yaw;                           // Aim yaw, seq * 0.5
+    double   pitch;                         // Aim pitch, -seq * 0.25
+};
+
+struct BenchSerialResult {
+    int sent = 0;                           // Intact frames written
+    int corrupt = 0;                        // Frames written with a flipped payload bit
+    int got = 0;                            // Frames popped
+    int bad = 0;                            // Popped frames whose payload fails the consistency check
+    std::vector<double> pop_us;             // Time of each successful pop, us
+};
+
+// 打开一对 pty，主端模拟下位机写入，从端设为 raw 后交给 SerialFramer 读取
+static bool openBenchPty(int& master, int& slave) {
+    master = posix_openpt(O_RDWR | O_NOCTTY);
+    if ((master < 0) || (grantpt(master) != 0) || (unlockpt(master) != 0)) return false;
+    slave = open(ptsname(master), O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (slave < 0) return false;
+
+    termios tio {};
+    tcgetattr(slave, &tio);
+    cfmakeraw(&tio);
+    return tcsetattr(slave, TCSANOW, &tio) == 0;
+}
+
+// 写入: 10% 的帧翻转负载中一位，20% 的帧前插入含假 sof 的垃圾字节，每帧在随机位置拆成两次写入
+// mixed 为 false 时只发 Locate 并按定长 pop，为 true 时 Locate 与 BenchSerialAim 交替，按返回长度分发
+static BenchSerialResult runBenchSerial(int frames, bool mixed) {
+    BenchSerialResult result;
+    int master, slave;
+    if (!openBenchPty(master, slave)) {
+        rm::message("Serial bench failed : cannot open pty", rm::MSG_ERROR);
+        return result;
+    }
+
+    std::mt19937 rng(mixed ? 7 : 3);
+    rm::SerialFramer framer(256);
+    unsigned char frame[256];
+    unsigned char payload[256];
+
+    auto check = [&](const unsigned char* data, size_t length) {
+        if (length == sizeof(rm::Locate)) {
+            rm::Locate locate;
+            memcpy(&locate, data, sizeof(locate));
+            return (locate.position_x == locate.receive_config * 0.5) && (locate.send_config == ~locate.receive_config);
+        }
+        if (length == sizeof(BenchSerialAim)) {
+            BenchSerialAim aim;
+            memcpy(&aim, data, sizeof(aim));
+            return (aim.yaw == aim.seq * 0.5) && (aim.pitch == -(aim.seq * 0.25));
+        }
+        return false;
+    };
+    auto drain = [&]() {
+        while (true) {
+            rm::SerialStatus status = rm::SERIAL_STATUS_INCOMPLETE;
+            size_t length = 0;
+            double us = getBenchTime(1, [&](int) {
+                if (mixed) {
+                    status = framer.pop(payload, sizeof(payload), length);
+                } else {
+                    rm::Locate locate;
+                    status = framer.pop(locate);
+                    memcpy(payload, &locate, sizeof(locate));
+                    length = sizeof(locate);
+                }
+            });
+            if (status != rm::SERIAL_STATUS_OK) break;
+            result.pop_us.push_back(us);
+            result.got++;
+            if (!check(payload, length)) result.bad++;
+        }
+    };
+
+    for (int k = 0; k < frames; k++) {
+        size_t n;
+        if (mixed && (k % 2)) {
+            BenchSerialAim aim {static_cast<uint64_t>(k), k * 0.5, -(k * 0.25)};
+            n = rm::packSerialFrame(reinterpret_cast<unsigned char*>(&aim), sizeof(aim), frame);
+        } else {
+            rm::Locate locate {};
+            locate.receive_config = k;
+            locate.position_x = k * 0.5;
+            locate.send_config = ~static_cast<uint64_t>(k);
+            n = rm::packSerialFrame(reinterpret_cast<unsigned char*>(&locate), sizeof(locate), frame);
+        }
+
+        if (rng() % 10 == 0) {
+            frame[rm::SERIAL_FRAME_HEAD + rng() % (n - rm::SERIAL_FRAME_HEAD - rm::SERIAL_FRAME_TAIL)] ^= 0x10;
+            result.corrupt++;
+        } else {
+            result.sent++;
+        }
+        if (rng() % 5 == 0) {
+            const unsigned char junk[7] = {0xA5, 0x70, 0x00, 0x01, 0x02, 0xA5, 0x18};
+            if (write(master, junk, rng() % 7 + 1) < 0) break;
+        }
+
+        size_t cut = rng() % n;
+        if (write(master, frame, cut) < 0) break;
+        framer.read(slave, 10);
+        if (write(master, frame + cut, n - cut) < 0) break;
+        for (int r = 0; r < 3; r++) framer.read(slave, 1);
+        drain();
+    }
+    for (int r = 0; r < 10; r++) framer.read(slave, 5);
+    drain();
+
+    const rm::SerialCounter& counter = framer.getCounter();
+    char str[256];
+    snprintf(str, sizeof(str), " %-6s %6d %7d %6d %4d   %8lu %6lu %6lu %6lu %6lu %6lu",
+        mixed ? "mixed" : "fixed", result.sent, result.corrupt, result.got, result.bad,
+        static_cast<unsigned long>(counter.bytes), static_cast<unsigned long>(counter.frame),
+        static_cast<unsigned long>(counter.sof_error), static_cast<unsigned long>(counter.length_error),
+        static_cast<unsigned long>(counter.crc_error), static_cast<unsigned long>(counter.overflow));
+    std::cout << str << std::endl;
+
+    close(slave);
+    close(master);
+    return result;
+}
+
+// 无硬件的串口回环: pty 上发送带噪声、拆包和假帧头的 CRC16 帧，检查 SerialFramer 的重同步与计数
+// 所有完好的帧都应收到且负载一致，损坏的帧都应被 CRC 拒绝
+// openrm -b serial [frames]
+void benchSerial(const std::vector<std::string>& args) {
+    int frames = (args.size() > 0) ? std::stoi(args[0]) : 2000;
+
+    uint16_t crc = rm::getCRC16(reinterpret_cast<const unsigned char*>("123456789"), 9);
+    char str[128];
+    snprintf(str, sizeof(str), "serial: pty loopback, %d frames, crc16 check %04x (expect 6f91)", frames, crc);
+    std::cout << str << std::endl;
+    std::cout << " mode     sent corrupt    got  bad      bytes  frame    sof    len    crc    ovf" << std::endl;
+
+    BenchSerialResult fixed = runBenchSerial(frames, false);
+    BenchSerialResult mixed = runBenchSerial(frames, true);
+    std::cout << "all intact frames received: "
+              << (((fixed.got == fixed.sent) && (mixed.got == mixed.sent) && !fixed.bad && !mixed.bad) ? "yes" : "no") << std::endl;
+    std::cout << getBenchStatStr("pop fixed", getBenchStat(fixed.pop_us), "us") << std::endl;
+    std::cout << getBenchStatStr("pop mixed", getBenchStat(mixed.pop_us), "us") << std::endl;
+}
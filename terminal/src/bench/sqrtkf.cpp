@@ -0,0 +1,92 @@
+#include "bench.h"
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <random>
+
+// P 对称且 Cholesky 分解成功才视为正定
+template<class M>
+static bool isBenchPD(const M& P) {
+    Eigen::LLT<M> llt(P);
+    double scale = std::max(1.0, P.cwiseAbs().maxCoeff());
+    return (llt.info() == Eigen::Success) && ((P - P.transpose()).cwiseAbs().maxCoeff() < 1e-9 * scale);
+}
+
+// 长时间高频运行，每 1000 步检查一次 P 的正定性，输出单步耗时、失效次数与最终最小特征值
+template<class Filter, class FuncA, class FuncH, class Gen>
+static void runBenchSqrtKF(const char* name, int steps, Filter& filter, FuncA func_a, FuncH func_h, Gen gen, int index, double truth) {
+    using VecY = typename Filter::VecY;
+    std::vector<VecY> measures(steps);
+    for (int k = 0; k < steps; k++) measures[k] = gen(k);
+
+    int bad = 0, first = -1;
+    double time = 0.0;
+    for (int k = 0; k < steps; k += 1000) {
+        int n = std::min(1000, steps - k);
+        time += n * getBenchTime(n, [&](int i) {
+            filter.predict(func_a);
+            filter.update(func_h, measures[k + i]);
+        });
+        if (!isBenchPD(filter.P)) {
+            bad++;
+            if (first < 0) first = k + n;
+        }
+    }
+    double min_eig = Eigen::SelfAdjointEigenSolver<typename Filter::MatXX>(filter.P).eigenvalues().minCoeff();
+
+    char str[160];
+    snprintf(str, sizeof(str), " %-18s %9.1f %6d/%-6d %9d  %+.2e  %.2e",
+        name, time / steps * 1e3, bad, (steps + 999) / 1000, first, min_eig, std::abs(filter.estimate_X[index] - truth));
+    std::cout << str << std::endl;
+}
+
+// openrm -b sqrtkf [steps]
+void benchSqrtKF(const std::vector<std::string>& args) {
+    int steps = (args.size() > 0) ? std::stoi(args[0]) : 1000000;
+    const double dt = 0.005, omega = 6.0;
+
+    std::cout << "sqrtkf: " << steps << " steps at " << 1.0 / dt << " Hz, P checked every 1000 steps" << std::endl;
+    std::cout << " filter               ns/step  non-PD      first  min eig    |omega err|" << std::endl;
+
+    // AntitopV3 角速度模型，过程噪声极小、观测极准，普通 KF 的 P 容易失去正定
+    auto omega_gen = [&, rng = std::mt19937(0), noise = std::normal_distribution<double>(0.0, 1e-4)](int k) mutable {
+        return Eigen::Matrix<double, 1, 1>(omega * (k + 1) * dt + noise(rng));
+    };
+    auto omega_setup = [](auto& filter) {
+        filter.Q = decltype(filter.Q)::Zero();
+        filter.Q(2, 2) = 1e-14;
+        filter.R = decltype(filter.R)::Identity() * 1e-10;
+    };
+    {
+        KF<3, 1> kf;
+        omega_setup(kf);
+        runBenchSqrtKF("KF<3,1>    omega", steps, kf, rm::AntitopV3_OmegaFuncA{dt}, rm::AntitopV3_OmegaFuncH{}, omega_gen, 1, omega);
+        SRKF<3, 1> srkf;
+        omega_setup(srkf);
+        runBenchSqrtKF("SRKF<3,1>  omega", steps, srkf, rm::AntitopV3_OmegaFuncA{dt}, rm::AntitopV3_OmegaFuncH{}, omega_gen, 1, omega);
+    }
+
+    // AntitopV3 整车模型，中心静止、匀速旋转
+    auto top_gen = [&, rng = std::mt19937(0), noise = std::normal_distribution<double>(0.0, 1e-3)](int k) mutable {
+        double theta = omega * (k + 1) * dt;
+        return Eigen::Matrix<double, 4, 1>(
+            1.0 - 0.25 * cos(theta) + noise(rng), 1.0 - 0.25 * sin(theta) + noise(rng), noise(rng), theta);
+    };
+    auto top_setup = [&](auto& filter) {
+        filter.Q = decltype(filter.Q)::Identity() * 1e-10;
+        filter.Q(7, 7) = 1e-6;
+        filter.R = decltype(filter.R)::Identity() * 1e-6;
+        filter.estimate_X << 1, 1, 0, 0, 0, 0, 0, omega, 0.25;
+    };
+    {
+        EKF<9, 4> ekf;
+        top_setup(ekf);
+        runBenchSqrtKF("EKF<9,4>   top", steps, ekf, rm::AntitopV3_FuncA{dt}, rm::AntitopV3_FuncH{}, top_gen, 7, omega);
+        SEKF<9, 4> sekf;
+        top_setup(sekf);
+        runBenchSqrtKF("SEKF<9,4>  top", steps, sekf, rm::AntitopV3_FuncA{dt}, rm::AntitopV3_FuncH{}, top_gen, 7, omega);
+        SREKF<9, 4> srekf;
+        top_setup(srekf);
+        runBenchSqrtKF("SREKF<9,4> top", steps, srekf, rm::AntitopV3_FuncA{dt}, rm::AntitopV3_FuncH{}, top_gen, 7, omega);
+    }
+}
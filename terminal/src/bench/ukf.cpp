@@ -0,0 +1,126 @@
+#include "bench.h"
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <random>
+
+static void printBenchUKF(const char* name, const char* model, const double rmse[3], double us) {
+    char str[160];
+    snprintf(str, sizeof(str), " %-6s %-8s %10.4f %10.4f %10.4f %9.2f", name, model, rmse[0], rmse[1], rmse[2], us);
+    std::cout << str << std::endl;
+}
+
+// 大符: 真值按 BigRuneV2_FuncA 演化，相位初值未知，统计后半段相位、振幅、角频率的均方根误差
+template<class Filter>
+static void runBenchUKFRune(const char* name, int runs) {
+    std::mt19937 rng(5);
+    std::normal_distribution<double> noise(0.0, 1.0);
+    double err[3] = {0.0, 0.0, 0.0}, time = 0.0;
+    int count = 0, steps = 0;
+    for (int run = 0; run < runs; run++) {
+        Filter filter;
+        filter.Q.setZero();
+        filter.Q.diagonal() << 1e-6, 1e-6, 1e-6, 1e-6, 1e-5, 1e-4, 1e-5, 1e-5;
+        filter.R.setZero();
+        filter.R.diagonal() << 1e-4, 1e-4, 1e-4, 1e-4, 4e-4;
+
+        double a = 0.78 + 0.265 * std::abs(noise(rng)) / 2;
+        double w = 1.884 + 0.116 * std::abs(noise(rng)) / 2;
+        Eigen::Matrix<double, 8, 1> x;
+        x << 5, 0, 1, 0, 0, 3 * noise(rng), a, w;
+        filter.estimate_X << 5, 0, 1, 0, 0, 0, 0.9, 1.94;
+        filter.P = Eigen::Matrix<double, 8, 8>::Identity() * 0.01;
+        filter.P(5, 5) = 3;
+        filter.P(7, 7) = 0.003;
+
+        rm::BigRuneV2_FuncA func_a;
+        rm::BigRuneV2_FuncH func_h;
+        func_a.dt = 0.01;
+        func_a.sign = 1.0;
+        for (int k = 0; k < 1000; k++) {
+            Eigen::Matrix<double, 8, 1> x1;
+            func_a(x.data(), x1.data());
+            x = x1;
+            Eigen::Matrix<double, 5, 1> y;
+            func_h(x.data(), y.data());
+            for (int i = 0; i < 5; i++) y[i] += std::sqrt(filter.R(i, i)) * noise(rng);
+
+            time += getBenchTime(1, [&](int) {
+                filter.predict(func_a);
+                filter.update(func_h, y);
+            });
+            steps++;
+            if (k < 500) continue;
+            err[0] += std::pow(std::remainder(filter.estimate_X[5] - x[5], 2 * M_PI), 2);
+            err[1] += std::pow(filter.estimate_X[6] - x[6], 2);
+            err[2] += std::pow(filter.estimate_X[7] - x[7], 2);
+            count++;
+        }
+    }
+    for (double& e : err) e = std::sqrt(e / count);
+    printBenchUKF(name, "rune", err, time / steps);
+}
+
+// 整车: 中心匀速移动、匀速旋转，统计后半段中心、半径、角速度的均方根误差
+template<class Filter>
+static void runBenchUKFTop(const char* name, int runs) {
+    std::mt19937 rng(7);
+    std::normal_distribution<double> noise(0.0, 1.0);
+    double err[3] = {0.0, 0.0, 0.0}, time = 0.0;
+    int count = 0, steps = 0;
+    for (int run = 0; run < runs; run++) {
+        Filter filter;
+        filter.Q.setZero();
+        filter.Q.diagonal() << 1e-5, 1e-5, 1e-6, 1e-4, 1e-4, 1e-4, 1e-6, 1e-2, 1e-6;
+        filter.R.setZero();
+        filter.R.diagonal() << 4e-4, 4e-4, 1e-4, 4e-3;
+
+        double r = 0.2 + 0.05 * std::abs(noise(rng));
+        double w = 4 + 4 * std::abs(noise(rng));
+        Eigen::Matrix<double, 9, 1> x;
+        x << 3, 0.2, 0, 0, 0.3, -0.2, 0, w, r;
+        filter.estimate_X << 3.2, 0.2, 0, 0, 0, 0, 0, 0, 0.25;
+        filter.P = Eigen::Matrix<double, 9, 9>::Identity() * 0.1;
+
+        rm::AntitopV3_FuncA func_a;
+        rm::AntitopV3_FuncH func_h;
+        func_a.dt = 0.01;
+        for (int k = 0; k < 600; k++) {
+            Eigen::Matrix<double, 9, 1> x1;
+            func_a(x.data(), x1.data());
+            x = x1;
+            Eigen::Matrix<double, 4, 1> y;
+            func_h(x.data(), y.data());
+            for (int i = 0; i < 4; i++) y[i] += std::sqrt(filter.R(i, i)) * noise(rng);
+
+            time += getBenchTime(1, [&](int) {
+                filter.predict(func_a);
+                filter.update(func_h, y);
+            });
+            steps++;
+            if (k < 300) continue;
+            err[0] += std::pow(filter.estimate_X[0] - x[0], 2) + std::pow(filter.estimate_X[1] - x[1], 2);
+            err[1] += std::pow(filter.estimate_X[8] - x[8], 2);
+            err[2] += std::pow(filter.estimate_X[7] - x[7], 2);
+            count++;
+        }
+    }
+    for (double& e : err) e = std::sqrt(e / count);
+    printBenchUKF(name, "antitop", err, time / steps);
+}
+
+// 对比 EKF / IEKF / UKF 在大符与 AntitopV3 模型上的精度与单步耗时
+// openrm -b ukf [runs]
+void benchUKF(const std::vector<std::string>& args) {
+    int runs = (args.size() > 0) ? std::stoi(args[0]) : 50;
+
+    std::cout << "ukf: " << runs << " runs per model" << std::endl;
+    std::cout << " filter model         rmse 1     rmse 2     rmse 3   us/step" << std::endl;
+    std::cout << " (rune: phase rad, amplitude, omega rad/s; antitop: center m, radius m, omega rad/s)" << std::endl;
+    runBenchUKFRune<EKF<8, 5>>("EKF", runs);
+    runBenchUKFRune<IEKF<8, 5>>("IEKF", runs);
+    runBenchUKFRune<UKF<8, 5>>("UKF", runs);
+    runBenchUKFTop<EKF<9, 4>>("EKF", runs);
+    runBenchUKFTop<IEKF<9, 4>>("IEKF", runs);
+    runBenchUKFTop<UKF<9, 4>>("UKF", runs);
+}
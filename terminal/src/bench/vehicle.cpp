@@ -0,0 +1,109 @@
+#include "bench.h"
+#include <cmath>
+#include <iostream>
+#include <random>
+
+// 合成车体上对比逐装甲板 YawPnP 与 solveVehiclePnP 联合求解的中心、朝向、半径误差
+// 逐装甲板的中心由单板位姿沿朝向外推默认半径后取平均，联合求解以单板结果为初值
+// openrm -b vehicle [samples] [pixel_noise]
+void benchVehicle(const std::vector<std::string>& args) {
+    int samples = (args.size() > 0) ? std::stoi(args[0]) : 2000;
+    double noise = (args.size() > 1) ? std::stod(args[1]) : 0.5;
+    const double r_init = 0.25;
+
+    rm::Camera camera;
+    getBenchCamera(camera);
+    rm::YawPnPShared shared;
+    getYawPnPShared(&camera, Eigen::Matrix3d::Identity(), Eigen::Matrix4d::Identity(), shared);
+
+    std::vector<cv::Point3f> small_points = {
+        {-67.5f, -27.5f, 0}, {-67.5f, 27.5f, 0}, {67.5f, -27.5f, 0}, {67.5f, 27.5f, 0}};
+    std::vector<cv::Point3f> big_points = {
+        {-115.0f, -27.5f, 0}, {-115.0f, 27.5f, 0}, {115.0f, -27.5f, 0}, {115.0f, 27.5f, 0}};
+
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+    std::normal_distribution<double> pixel_noise(0.0, noise);
+
+    std::vector<double> single_center, single_yaw, single_radius, single_time;
+    std::vector<double> joint_center, joint_yaw, joint_radius, joint_time, joint_iter;
+    int valid = 0, converged = 0;
+    for (int k = 0; k < samples; k++) {
+        // 四装甲板车体，两组半径与高度不同，参考装甲板大致正对相机，另有一块相邻装甲板可见
+        double distance = 3.0 + 2.0 * std::abs(uniform(rng));
+        double bearing = 0.2 * uniform(rng);
+        Eigen::Vector3d center(distance * cos(bearing), distance * sin(bearing), 0.1 * uniform(rng));
+        double r[2] = {0.2 + 0.05 * uniform(rng), 0.25 + 0.05 * uniform(rng)};
+        double z[2] = {center(2), center(2) + 0.05 * uniform(rng)};
+        double yaw = bearing + 0.6 * uniform(rng);
+        int side = (yaw > bearing) ? -1 : 1;
+
+        std::vector<rm::VehicleArmor> armors;
+        Eigen::Vector2d single_sum = Eigen::Vector2d::Zero();
+        double single_us = 0.0;
+        for (int index : {0, side}) {
+            int toggle = std::abs(index) % 2;
+            double armor_yaw = yaw + index * M_PI / 2;
+            Eigen::Vector4d pose(
+                center(0) - r[toggle] * cos(armor_yaw),
+                center(1) - r[toggle] * sin(armor_yaw),
+                z[toggle], 1);
+
+            rm::Armor armor;
+            armor.size = rm::ARMOR_SIZE_SMALL_ARMOR;
+            armor.id = rm::ARMOR_ID_INFANTRY_3;
+            armor.four_points = getBenchProject(shared, small_points, pose, armor_yaw);
+            for (auto& p : armor.four_points) {
+                p.x += pixel_noise(rng);
+                p.y += pixel_noise(rng);
+            }
+
+            rm::Target target;
+            rm::ArmorElevation elevation = rm::ARMOR_ELEVATION_UP_15;
+            single_us += getBenchTime(1, [&](int) {
+                target.armor_yaw_world = rm::solveYawPnP(0.0, &camera, shared, target.pose_world,
+                    small_points, armor.four_points, armor.id, &elevation);
+            });
+            target.armor_elevation = elevation;
+
+            rm::VehicleArmor vehicle_armor;
+            if (!rm::getVehicleArmor(armor, target, small_points, big_points, vehicle_armor)) continue;
+            armors.push_back(vehicle_armor);
+            single_sum += Eigen::Vector2d(
+                target.pose_world(0) + r_init * cos(target.armor_yaw_world),
+                target.pose_world(1) + r_init * sin(target.armor_yaw_world));
+        }
+        if (armors.size() != 2) continue;
+
+        rm::VehiclePose vehicle;
+        double joint_us = getBenchTime(1, [&](int) {
+            rm::solveVehiclePnP(shared, armors, vehicle, 4, 1e-3);
+        });
+        valid++;
+        converged += vehicle.converged ? 1 : 0;
+
+        Eigen::Vector2d single_center_xy = single_sum / 2.0;
+        single_center.push_back((single_center_xy - center.head(2)).norm());
+        single_yaw.push_back(std::abs(std::remainder(armors[0].yaw - yaw, 2 * M_PI)));
+        single_radius.push_back(0.5 * (std::abs(r_init - r[0]) + std::abs(r_init - r[1])));
+        single_time.push_back(single_us);
+
+        joint_center.push_back((vehicle.center.head(2) - center.head(2)).norm());
+        joint_yaw.push_back(std::abs(std::remainder(vehicle.yaw - yaw, 2 * M_PI)));
+        joint_radius.push_back(0.5 * (std::abs(vehicle.r[0] - r[0]) + std::abs(vehicle.r[1] - r[1])));
+        joint_time.push_back(single_us + joint_us);
+        joint_iter.push_back(vehicle.iterations);
+    }
+
+    std::cout << "vehicle: " << valid << "/" << samples << " samples, pixel noise " << noise
+              << ", converged " << converged << "/" << valid << std::endl;
+    std::cout << getBenchStatStr("per-armor center", getBenchStat(single_center), "m") << std::endl;
+    std::cout << getBenchStatStr("per-armor yaw", getBenchStat(single_yaw), "rad") << std::endl;
+    std::cout << getBenchStatStr("per-armor radius", getBenchStat(single_radius), "m") << std::endl;
+    std::cout << getBenchStatStr("per-armor time", getBenchStat(single_time), "us") << std::endl;
+    std::cout << getBenchStatStr("joint center", getBenchStat(joint_center), "m") << std::endl;
+    std::cout << getBenchStatStr("joint yaw", getBenchStat(joint_yaw), "rad") << std::endl;
+    std::cout << getBenchStatStr("joint radius", getBenchStat(joint_radius), "m") << std::endl;
+    std::cout << getBenchStatStr("joint time", getBenchStat(joint_time), "us") << std::endl;
+    std::cout << getBenchStatStr("joint iterations", getBenchStat(joint_iter), "") << std::endl;
+}
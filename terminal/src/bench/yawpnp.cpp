@@ -0,0 +1,82 @@
+#include "bench.h"
+#include <iostream>
+#include <random>
+
+// 合成装甲板位姿上对比旧的双三分搜索与 IPPE 初值 + Brent 搜索
+// openrm -b yawpnp [samples] [pixel_noise]
+void benchYawPnP(const std::vector<std::string>& args) {
+    int samples = (args.size() > 0) ? std::stoi(args[0]) : 2000;
+    double noise = (args.size() > 1) ? std::stod(args[1]) : 0.5;
+
+    rm::Camera camera;
+    getBenchCamera(camera);
+    rm::YawPnPShared shared;
+    getYawPnPShared(&camera, Eigen::Matrix3d::Identity(), Eigen::Matrix4d::Identity(), shared);
+
+    // YawPnP 使用毫米的世界坐标，IPPE 使用米，朝向不受尺度影响
+    std::vector<cv::Point3f> object_points = {
+        {-67.5f, -27.5f, 0}, {-67.5f, 27.5f, 0}, {67.5f, -27.5f, 0}, {67.5f, 27.5f, 0}};
+    std::vector<cv::Point3f> object_points_m;
+    for (const auto& p : object_points) object_points_m.push_back(p * 1e-3f);
+
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+    std::normal_distribution<double> pixel_noise(0.0, noise);
+
+    std::vector<double> seed_error, ternary_error, brent_error;
+    std::vector<double> ternary_time, brent_time;
+    for (int k = 0; k < samples; k++) {
+        rm::YawPnP yaw_pnp;
+        yaw_pnp.sys_yaw = 0.3 * uniform(rng);
+        yaw_pnp.setElevation(rm::ARMOR_ELEVATION_UP_15);
+        yaw_pnp.setWorldPoints(object_points);
+        yaw_pnp.Kc = shared.Kc;
+        yaw_pnp.T = shared.T;
+        yaw_pnp.T_inv = shared.T_inv;
+
+        // 目标在视野内，朝向在正对方向 ±1.2 rad 内
+        double distance = 2.0 + 5.0 * std::abs(uniform(rng));
+        double bearing = 0.3 * uniform(rng);
+        yaw_pnp.pose = Eigen::Vector4d(distance * cos(bearing), distance * sin(bearing), 0.2 * uniform(rng), 1);
+        double truth = std::clamp(bearing - yaw_pnp.sys_yaw + 1.2 * uniform(rng), -1.4, 1.4);
+
+        rm::YawPnP::Points2d project = yaw_pnp.getProject(yaw_pnp.getMapping(truth));
+        std::vector<cv::Point2f> image_points;
+        for (int i = 0; i < 4; i++) {
+            image_points.emplace_back(project(0, i) + pixel_noise(rng), project(1, i) + pixel_noise(rng));
+        }
+        yaw_pnp.setImagePoints(image_points);
+
+        cv::Mat rvec, tvec, rotate_cv;
+        cv::solvePnP(object_points_m, image_points, camera.intrinsic_matrix, camera.distortion_coeffs,
+                     rvec, tvec, false, cv::SOLVEPNP_IPPE);
+        cv::Rodrigues(rvec, rotate_cv);
+        Eigen::Matrix3d rotate_pnp;
+        rm::tf_Mat3d(rotate_cv, rotate_pnp);
+        double armor_yaw = rm::tf_rotation2armoryaw(shared.rotate_pnp2world * rotate_pnp);
+        double seed = rm::getYawPnPSeed(yaw_pnp.sys_yaw, armor_yaw);
+
+        double ternary_yaw = 0.0, brent_yaw = 0.0;
+        ternary_time.push_back(getBenchTime(1, [&](int) {
+            double angle_yaw = yaw_pnp.getYawByAngleCost(-(M_PI / 2), (M_PI / 2), 0.03);
+            double pixel_yaw = yaw_pnp.getYawByPixelCost(-(M_PI / 2), (M_PI / 2), 0.03);
+            ternary_yaw = yaw_pnp.getYawByMix(pixel_yaw, angle_yaw);
+        }));
+        brent_time.push_back(getBenchTime(1, [&](int) {
+            double angle_yaw = yaw_pnp.getYawByAngleCost(-(M_PI / 2), (M_PI / 2), seed, 0.005);
+            double pixel_yaw = yaw_pnp.getYawByPixelCost(-(M_PI / 2), (M_PI / 2), seed, 0.005);
+            brent_yaw = yaw_pnp.getYawByMix(pixel_yaw, angle_yaw);
+        }));
+
+        seed_error.push_back(std::abs(seed - truth));
+        ternary_error.push_back(std::abs(ternary_yaw - truth));
+        brent_error.push_back(std::abs(brent_yaw - truth));
+    }
+
+    std::cout << "yawpnp: " << samples << " poses, " << noise << " px noise" << std::endl;
+    std::cout << getBenchStatStr("ippe seed error", getBenchStat(seed_error), "rad") << std::endl;
+    std::cout << getBenchStatStr("ternary error", getBenchStat(ternary_error), "rad") << std::endl;
+    std::cout << getBenchStatStr("brent error", getBenchStat(brent_error), "rad") << std::endl;
+    std::cout << getBenchStatStr("ternary time", getBenchStat(ternary_time), "us") << std::endl;
+    std::cout << getBenchStatStr("brent time", getBenchStat(brent_time), "us") << std::endl;
+}
@@ -1,26 +1,171 @@
 #include "terminal.h"
+#include "bench.h"
+#include <cmath>
 #include <iostream>
 #include <thread>
 #include <vector>
 #include <string>
 #include <unistd.h>
 
+// 对比不同精度引擎的检测结果，第一个文件作为参考 (通常为FP32)，差值相对参考自身的评估
+static void evaluate(const std::vector<std::string>& files) {
+    if (files.size() < 2) {
+        std::cout << "Usage: openrm -e <reference.det> <test.det> [test.det ...]" << std::endl;
+        return;
+    }
+    rm::DetectList reference;
+    if (!rm::readDetections(files[0], reference)) return;
+
+    rm::DetectEval base = rm::evaluateDetection(reference, reference);
+    rm::reportDetectEval(files[0], base);
+    for (size_t i = 1; i < files.size(); i++) {
+        rm::DetectList test;
+        if (!rm::readDetections(files[i], test)) continue;
+        rm::DetectEval eval = rm::evaluateDetection(reference, test);
+        rm::reportDetectEval(files[i], eval, &base);
+    }
+}
+
+// 用指定精度的引擎检测目录下全部帧并写出 .det，供 -e 对比
+static void record(const std::vector<std::string>& args) {
+#ifdef OPENRM_WITH_TENSORRT
+    if (args.size() < 8) {
+        std::cout << "Usage: openrm -r <onnx> <cache_dir> <fp32|fp16|int8> <fp|fpx|v5> <classes> <bboxes> <image_dir> <out.det> [calib_dir]" << std::endl;
+        return;
+    }
+    rm::EnginePrecision precision = rm::ENGINE_FP16;
+    if (args[2] == "fp32") precision = rm::ENGINE_FP32;
+    else if (args[2] == "int8") precision = rm::ENGINE_INT8;
+
+    int classes_num = std::stoi(args[4]);
+    int bboxes_num = std::stoi(args[5]);
+    size_t yolo_size;
+    rm::DetectNMS nms;
+    if (args[3] == "fp") {
+        yolo_size = 9 + classes_num;
+        nms = [=](float* buffer, int width, int height) {
+            return rm::yoloArmorNMS_FP(buffer, bboxes_num, classes_num, 0.25f, 0.45f, width, height, 640, 640);
+        };
+    } else if (args[3] == "fpx") {
+        yolo_size = 9 + 4 + classes_num;
+        nms = [=](float* buffer, int width, int height) {
+            return rm::yoloArmorNMS_FPX(buffer, bboxes_num, classes_num, 0.25f, 0.45f, width, height, 640, 640);
+        };
+    } else if (args[3] == "v5") {
+        yolo_size = 5 + classes_num;
+        nms = [=](float* buffer, int width, int height) {
+            return rm::yoloArmorNMS_V5(buffer, bboxes_num, classes_num, 0.25f, 0.45f, width, height, 640, 640);
+        };
+    } else {
+        std::cout << "Unknown nms: " << args[3] << std::endl;
+        return;
+    }
+
+    nvinfer1::IExecutionContext* context = nullptr;
+    std::string calib_dir = (args.size() > 8) ? args[8] : "";
+    if (!rm::initTrtCache(args[0], args[1], &context, precision, 1U, calib_dir)) return;
+
+    rm::DetectList detections;
+    if (!rm::detectDirectory(&context, args[6], nms, detections, yolo_size * sizeof(float), bboxes_num)) return;
+    rm::writeDetections(args[7], detections);
+#else
+    std::cout << "OpenRM is built without TensorRT" << std::endl;
+#endif
+}
+
+// 重放接口 setRecord / saveRecord 记录的测量序列，搜索接口运动模型的 Q / R 对角线
+static void tune(const std::vector<std::string>& args) {
+    if (args.size() < 3) {
+        std::cout << "Usage: openrm -t <trackqueueV4|antitopV3|outpostV2> <append_delay> <log> [log ...]" << std::endl;
+        return;
+    }
+    std::string model = args[0];
+    double append_delay = std::stod(args[1]);
+
+    std::vector<rm::TunerLog> logs;
+    for (size_t i = 2; i < args.size(); i++) {
+        rm::TunerLog log;
+        if (rm::readTunerLog(args[i], log)) logs.push_back(log);
+    }
+    if (logs.empty()) return;
+
+    std::vector<double> init;
+    rm::TunerObjective objective;
+    int dimX = 0;
+    if (model == "trackqueueV4") {
+        init = {0.1, 0.1, 0.1, 0.1, 0.1, 0.1, 0.1, 0.1, 0.1, 0.1, 0.1};
+        objective = [=](const std::vector<double>& params, const rm::TunerLog& log) {
+            return rm::replayFilterCost<SEKF<8, 3>, rm::TrackQueueV4_FuncA, rm::TrackQueueV4_FuncH>(params, log, append_delay);
+        };
+        dimX = 8;
+    } else if (model == "antitopV3") {
+        init = {0.01, 0.01, 0.01, 0.02, 0.05, 0.05, 0.0001, 0.04, 0.001, 0.1, 0.1, 0.1, 0.2};
+        auto init_state = [](const rm::TunerSample& sample, Eigen::Matrix<double, 9, 1>& X) {
+            double r = 0.25;
+            X[0] = sample.pose[0] + r * cos(sample.pose[3]);
+            X[1] = sample.pose[1] + r * sin(sample.pose[3]);
+            X[2] = sample.pose[2];
+            X[3] = sample.pose[3];
+            X[8] = r;
+        };
+        objective = [=](const std::vector<double>& params, const rm::TunerLog& log) {
+            return rm::replayFilterCost<SEKF<9, 4>, rm::AntitopV3_FuncA, rm::AntitopV3_FuncH>(
+                params, log, append_delay, rm::TUNER_COST_MSE, init_state, rm::AntitopV3_TunerAlign());
+        };
+        dimX = 9;
+    } else if (model == "outpostV2") {
+        init = {0.01, 0.01, 0.01, 0.02, 0.05, 0.05, 0.05, 0.04, 0.1, 0.1, 0.1, 0.2};
+        auto init_state = [](const rm::TunerSample& sample, Eigen::Matrix<double, 8, 1>& X) {
+            X[0] = sample.pose[0] + rm::OUTPOST_R_V2 * cos(sample.pose[3]);
+            X[1] = sample.pose[1] + rm::OUTPOST_R_V2 * sin(sample.pose[3]);
+            X[2] = sample.pose[2];
+            X[3] = sample.pose[3];
+        };
+        objective = [=](const std::vector<double>& params, const rm::TunerLog& log) {
+            return rm::replayFilterCost<SEKF<8, 4>, rm::OutpostV2_FuncA, rm::OutpostV2_FuncH>(
+                params, log, append_delay, rm::TUNER_COST_MSE, init_state, rm::OutpostV2_TunerAlign());
+        };
+        dimX = 8;
+    } else {
+        std::cout << "Unknown model: " << model << std::endl;
+        return;
+    }
+    for (auto& p : init) p = std::log10(p);
+
+    rm::TunerResult result = rm::tuneCMAES(objective, logs, init);
+    std::cout << "cost: " << result.cost << "  evaluations: " << result.evaluations << std::endl;
+    std::cout << rm::getTunerParamStr(result.params, dimX);
+}
+
 
 int main(int argc, char** argv) {
     int option;
     bool oscilloscope_flag = false;
     bool monitor_flag = false;
+    bool evaluate_flag = false;
+    bool record_flag = false;
+    bool tune_flag = false;
+    bool bench_flag = false;
     std::vector<std::string> arg_strs;
     std::vector<std::string> key_name{"autoaim", "camsense", "radar"};
     
-    while ((option = getopt(argc, argv, "dhimov")) != -1) {
+    while ((option = getopt(argc, argv, "bdehimortv")) != -1) {
         switch (option) {
+            case 'b':
+                bench_flag = true;
+                break;
             case 'd':
                 rm::term_init();
                 rm::dashboard(key_name);
                 break;
+            case 'e':
+                evaluate_flag = true;
+                break;
+            case 'r':
+                record_flag = true;
+                break;
             case 'h':
-                std::cout << "Usage: " << argv[0] << " [-d] [-h] [-i] [-v] [-o <arg> <arg> ... ]" << std::endl;
+                std::cout << "Usage: " << argv[0] << " [-b <name> <arg> ... ] [-d] [-h] [-i] [-v] [-o <arg> <arg> ... ] [-r <onnx> <cache> <precision> <nms> <classes> <bboxes> <images> <out> ] [-e <ref> <test> ... ] [-t <model> <delay> <log> ... ]" << std::endl;
                 break;
             case 'i':
                 std::cout << "Hello, World!" << std::endl;
@@ -35,6 +180,9 @@ int main(int argc, char** argv) {
             case 'o':
                 oscilloscope_flag = true;
                 break;
+            case 't':
+                tune_flag = true;
+                break;
         }
     }
 
@@ -44,6 +192,22 @@ int main(int argc, char** argv) {
         }
     }
 
+    if (record_flag) {
+        record(arg_strs);
+    }
+
+    if (evaluate_flag) {
+        evaluate(arg_strs);
+    }
+
+    if (tune_flag) {
+        tune(arg_strs);
+    }
+
+    if (bench_flag) {
+        bench(arg_strs);
+    }
+
     if (oscilloscope_flag) {
         rm::term_init();
         rm::oscilloscope(key_name, arg_strs);